@@ -31,6 +31,7 @@ struct ArgInfo {
   std::string schema_path;
   std::string output_path;
   std::string restart;
+  int threads;
 };
 
 // Describes and parses cli arguments. Returns the error code that main should
@@ -195,6 +196,9 @@ int main(int argc, char* argv[]) {
     si.recorder()->RegisterBackend(fback);
   }
 
+  if (ai.threads > 1) {
+    si.context()->threads(ai.threads);
+  }
   
   char* CYCLUS_NO_CATCH = getenv("CYCLUS_NO_CATCH");
   if( CYCLUS_NO_CATCH !=NULL && CYCLUS_NO_CATCH != "0" ){
@@ -249,6 +253,8 @@ int ParseCliArgs(ArgInfo* ai, int argc, char* argv[]) {
       ("warn-limit", po::value<unsigned int>(),
        "number of warnings to issue per kind, defaults to 42")
       ("warn-as-error", "throw errors when warnings are issued")
+      ("threads", po::value<int>(),
+       "number of threads used to tick/tock thread-safe agents, defaults to 1")
       ("path,p", "print the CYCLUS_PATH")
       ("include", "print the cyclus include directory")
       ("install-path", "print the cyclus install directory")
@@ -462,6 +468,12 @@ void GetSimInfo(ArgInfo* ai) {
   if (ai->vm.count("warn-as-error"))
     cyclus::warn_as_error = true;
 
+  // Threading
+  ai->threads = 1;
+  if (ai->vm.count("threads")) {
+    ai->threads = ai->vm["threads"].as<int>();
+  }
+
   // Output path
   ai->output_path = "cyclus.sqlite";
   if (ai->vm.count("output-path")) {
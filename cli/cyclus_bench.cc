@@ -0,0 +1,583 @@
+// cyclus_bench.cc
+// Benchmarks of performance critical parts of the cyclus kernel on synthetic
+// problems.
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "OsiSolverInterface.hpp"
+
+#include "adaptive_solver.h"
+#include "capacity_constraint.h"
+#include "composition.h"
+#include "context.h"
+#include "error.h"
+#include "exchange_graph.h"
+#include "exchange_graph_dump.h"
+#include "exchange_translator.h"
+#include "facility.h"
+#include "greedy_solver.h"
+#include "logger.h"
+#include "material.h"
+#include "priority_greedy_solver.h"
+#include "prog_solver.h"
+#include "prog_translator.h"
+#include "recorder.h"
+#include "resource_exchange.h"
+#include "solver_factory.h"
+#include "stopwatch.h"
+#include "thread_pool.h"
+#include "timer.h"
+#include "trade.h"
+
+namespace po = boost::program_options;
+
+using cyclus::Arc;
+using cyclus::Bid;
+using cyclus::BidPortfolio;
+using cyclus::CapacityConstraint;
+using cyclus::CommodMap;
+using cyclus::ExchangeGraph;
+using cyclus::ExchangeNode;
+using cyclus::ExchangeNodeGroup;
+using cyclus::Material;
+using cyclus::PrefView;
+using cyclus::Request;
+using cyclus::RequestGroup;
+using cyclus::RequestPortfolio;
+
+struct BenchArgs {
+  int requesters;
+  int suppliers;
+  int commods;
+  int nodes;
+  int caps;
+  double excl_frac;
+  std::string prefs;
+  int seed;
+  std::vector<int> scales;
+  int reps;
+  int threads;
+  std::vector<std::string> solvers;
+  bool exclusive;
+  bool decompose;
+  bool aggregate;
+  std::vector<std::string> dumps;
+};
+
+/// builds a graph of requesters that each request every commodity with nodes
+/// nodes, and suppliers that each offer one commodity to every request node of
+/// it
+void BuildGraph(const BenchArgs& args, ExchangeGraph* g) {
+  std::vector<std::vector<ExchangeNode::Ptr> > reqs(args.commods);
+  for (int r = 0; r < args.requesters; ++r) {
+    RequestGroup::Ptr rg(new RequestGroup(10));
+    rg->AddCapacity(10);
+    rg->AddCapacity(20);
+    for (int c = 0; c < args.commods; ++c) {
+      std::stringstream ss;
+      ss << "commod" << c;
+      for (int n = 0; n < args.nodes; ++n) {
+        ExchangeNode::Ptr u(new ExchangeNode(10, n % 2 == 0, ss.str(), r));
+        rg->AddExchangeNode(u);
+        reqs[c].push_back(u);
+      }
+    }
+    g->AddRequestGroup(rg);
+  }
+
+  for (int s = 0; s < args.suppliers; ++s) {
+    int c = s % args.commods;
+    ExchangeNodeGroup::Ptr sg(new ExchangeNodeGroup());
+    sg->AddCapacity(5 + s % 7);
+    ExchangeNode::Ptr v(new ExchangeNode(5 + s % 7, false, reqs[c].empty() ?
+                                         "" : reqs[c][0]->commod,
+                                         args.requesters + s));
+    sg->AddExchangeNode(v);
+    g->AddSupplyGroup(sg);
+    for (int i = 0; i < reqs[c].size(); ++i) {
+      ExchangeNode::Ptr u = reqs[c][i];
+      Arc a(u, v);
+      double pref = 1 + (i + s) % 5;
+      a.pref(pref);
+      u->prefs[a] = pref;
+      u->unit_capacities[a].push_back(1);
+      u->unit_capacities[a].push_back(0.5 + (i % 3) * 0.25);
+      v->unit_capacities[a].push_back(1);
+      g->AddArc(a);
+    }
+  }
+}
+
+/// times the translation of a graph into a program row by row and in bulk,
+/// serially and, with more than one thread, concurrently
+void BenchTranslate(const BenchArgs& args) {
+  ExchangeGraph g;
+  BuildGraph(args, &g);
+  cyclus::SolverFactory sf("cbc");
+  OsiSolverInterface* iface = sf.get();
+  cyclus::ThreadPool pool(args.threads);
+  bool exclusive = true;
+  double pseudo_cost = 1e6;
+
+  std::cout << "arcs " << g.arcs().size() << "\n";
+  const char* modes[] = {"translate-by-row", "translate", "translate-pooled"};
+  int nmodes = args.threads > 1 ? 3 : 2;
+  for (int m = 0; m < nmodes; ++m) {
+    double best = -1;
+    for (int i = 0; i < args.reps; ++i) {
+      cyclus::Stopwatch sw;
+      sw.Start();
+      cyclus::ProgTranslator xlator(&g, iface, exclusive, pseudo_cost);
+      if (m == 0) {
+        xlator.TranslateByRow();
+      } else {
+        xlator.pool(m == 2 ? &pool : NULL);
+        xlator.Translate();
+      }
+      xlator.Populate();
+      double wall = sw.wall();
+      best = best < 0 || wall < best ? wall : best;
+    }
+    std::cout << modes[m] << " " << best << "\n";
+  }
+  delete iface;
+}
+
+/// @return a new solver of the given name
+cyclus::ExchangeSolver* MakeSolver(const BenchArgs& args,
+                                   const std::string& name) {
+  cyclus::ExchangeSolver* solver;
+  if (name == "greedy") {
+    solver = new cyclus::GreedySolver(args.exclusive);
+  } else if (name == "priority-greedy") {
+    solver = new cyclus::PriorityGreedySolver(args.exclusive);
+  } else if (name == "coin-or" || name == "coin-or-relax") {
+    cyclus::ProgSolver* prog = new cyclus::ProgSolver(
+        "cbc", cyclus::ProgSolver::kDefaultTimeout, args.exclusive, false,
+        false);
+    prog->relax(name == "coin-or-relax");
+    solver = prog;
+  } else if (name == "adaptive") {
+    solver = new cyclus::AdaptiveSolver(args.exclusive);
+  } else {
+    throw cyclus::ValueError("unknown solver '" + name + "'");
+  }
+  solver->decompose(args.decompose);
+  return solver;
+}
+
+/// solves a graph, returning the objective and the wall time in wall
+double TimeSolve(const BenchArgs& args, const std::string& name,
+                 ExchangeGraph* g, double* wall) {
+  g->ClearMatches();
+  cyclus::ExchangeSolver* solver = MakeSolver(args, name);
+  double obj;
+  cyclus::Stopwatch sw;
+  sw.Start();
+  try {
+    obj = solver->Solve(g);
+  } catch (...) {
+    delete solver;
+    throw;
+  }
+  *wall = sw.wall();
+  delete solver;
+  return obj;
+}
+
+/// replays dumped exchange graphs (see DumpExchangeGraph) through solvers,
+/// reporting the fastest solve time, the objective, and the matched quantity
+/// of each graph and solver
+void BenchReplay(const BenchArgs& args) {
+  std::cout << "dump solver arcs wall obj matched\n";
+  for (int i = 0; i < args.dumps.size(); ++i) {
+    cyclus::ExchangeGraph::Ptr g = cyclus::LoadExchangeGraph(args.dumps[i]);
+    for (int s = 0; s < args.solvers.size(); ++s) {
+      double best = -1;
+      double obj = 0;
+      for (int j = 0; j < args.reps; ++j) {
+        double wall;
+        obj = TimeSolve(args, args.solvers[s], g.get(), &wall);
+        best = best < 0 || wall < best ? wall : best;
+      }
+
+      double matched = 0;
+      const std::vector<cyclus::Match>& matches = g->matches();
+      for (int j = 0; j < matches.size(); ++j) {
+        matched += matches[j].second;
+      }
+      std::cout << args.dumps[i] << " " << args.solvers[s] << " "
+                << g->arcs().size() << " " << best << " " << obj << " "
+                << matched << "\n";
+    }
+  }
+}
+
+/// a capacity constraint converter that scales quantities by a factor
+struct ScaleConverter : public cyclus::Converter<Material> {
+  ScaleConverter(double factor) : factor(factor) {}
+
+  virtual double convert(
+      Material::Ptr offer,
+      Arc const * a = NULL,
+      cyclus::ExchangeTranslationContext<Material> const * ctx = NULL) const {
+    return offer->quantity() * factor;
+  }
+
+  double factor;
+};
+
+/// adds n capacity constraints of cap, the i-th of which converts quantities
+/// by a factor of 1 + i / 2
+template <class P>
+void AddConstraints(int n, double cap, P port) {
+  for (int i = 0; i < n; ++i) {
+    cyclus::Converter<Material>::Ptr conv(new ScaleConverter(1 + 0.5 * i));
+    port->AddConstraint(CapacityConstraint<Material>(cap * (1 + 0.5 * i),
+                                                     conv));
+  }
+}
+
+/// a trader of a synthetic market, which exists only within the exchange
+class BenchTrader : public cyclus::Facility {
+ public:
+  BenchTrader(cyclus::Context* ctx) : cyclus::Facility(ctx) {}
+
+  virtual cyclus::Agent* Clone() { return new BenchTrader(context()); }
+  virtual void Snapshot(cyclus::DbInit di) {}
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+  virtual void Tick() {}
+  virtual void Tock() {}
+};
+
+/// requests nodes orders of every commodity, adjusting the preference of each
+/// bid by the bidder's weight
+class BenchRequester : public BenchTrader {
+ public:
+  BenchRequester(cyclus::Context* ctx, int caps)
+      : BenchTrader(ctx),
+        caps_(caps) {}
+
+  /// adds an order for the next request portfolio
+  void AddOrder(Material::Ptr target, const std::string& commod, double pref,
+                bool exclusive) {
+    targets_.push_back(target);
+    commods_.push_back(commod);
+    prefs_.push_back(pref);
+    excl_.push_back(exclusive);
+  }
+
+  virtual std::set<RequestPortfolio<Material>::Ptr> GetMatlRequests() {
+    std::set<RequestPortfolio<Material>::Ptr> ports;
+    RequestPortfolio<Material>::Ptr port(new RequestPortfolio<Material>());
+    for (int i = 0; i < targets_.size(); ++i) {
+      port->AddRequest(targets_[i], this, commods_[i], prefs_[i], excl_[i]);
+    }
+    AddConstraints(caps_, port->qty(), port);
+    ports.insert(port);
+    return ports;
+  }
+
+  virtual void AdjustMatlPrefs(PrefView<Material>& prefs);
+
+ private:
+  int caps_;
+  std::vector<Material::Ptr> targets_;
+  std::vector<std::string> commods_;
+  std::vector<double> prefs_;
+  std::vector<bool> excl_;
+};
+
+/// bids on every request of a commodity
+class BenchSupplier : public BenchTrader {
+ public:
+  BenchSupplier(cyclus::Context* ctx, const std::string& commod, double cap,
+                double weight, bool exclusive, int caps)
+      : BenchTrader(ctx),
+        commod_(commod),
+        cap_(cap),
+        weight_(weight),
+        excl_(exclusive),
+        caps_(caps) {}
+
+  /// @return the factor by which requesters adjust the preferences of bids of
+  /// this supplier
+  double weight() const { return weight_; }
+
+  virtual std::set<BidPortfolio<Material>::Ptr> GetMatlBids(
+      CommodMap<Material>::type& commod_requests) {
+    std::set<BidPortfolio<Material>::Ptr> ports;
+    CommodMap<Material>::type::iterator it = commod_requests.find(commod_);
+    if (it == commod_requests.end()) {
+      return ports;
+    }
+
+    BidPortfolio<Material>::Ptr port(new BidPortfolio<Material>());
+    const std::vector<Request<Material>*>& reqs = it->second;
+    for (int i = 0; i < reqs.size(); ++i) {
+      port->AddBid(reqs[i], reqs[i]->target(), this, excl_);
+    }
+    AddConstraints(caps_, cap_, port);
+    ports.insert(port);
+    return ports;
+  }
+
+ private:
+  std::string commod_;
+  double cap_;
+  double weight_;
+  bool excl_;
+  int caps_;
+};
+
+void BenchRequester::AdjustMatlPrefs(PrefView<Material>& prefs) {
+  for (int i = 0; i < prefs.size(); ++i) {
+    double pref = prefs.request(i)->preference();
+    for (int j = 0; j < prefs.n_bids(i); ++j) {
+      BenchSupplier* s = static_cast<BenchSupplier*>(prefs.bid(i, j)->bidder());
+      prefs.pref(i, j) = pref * s->weight();
+    }
+  }
+}
+
+/// @return a preference drawn from the distribution of the given name
+double DrawPref(const std::string& dist, std::mt19937* rng) {
+  if (dist == "constant") {
+    return 1;
+  } else if (dist == "uniform") {
+    return std::uniform_real_distribution<double>(1, 10)(*rng);
+  } else if (dist == "exponential") {
+    return 1 + std::exponential_distribution<double>(1)(*rng);
+  }
+  throw cyclus::ValueError("unknown preference distribution '" + dist + "'");
+}
+
+/// registers the traders of a market of requesters that each request every
+/// commodity with nodes orders, and suppliers that each bid on every request
+/// of one commodity. A fraction excl_frac of the orders and suppliers are
+/// exclusive, request preferences and supplier weights are drawn from the
+/// prefs distribution, and each portfolio has caps capacity constraints.
+/// Suppliers of a commodity can supply about 80% of its demand.
+void BuildMarket(const BenchArgs& args, int requesters, int suppliers,
+                 cyclus::Context* ctx) {
+  std::mt19937 rng(args.seed);
+  std::uniform_real_distribution<double> unit(0, 1);
+  cyclus::CompMap v;
+  v[922350000] = 1;
+  cyclus::Composition::Ptr comp = cyclus::Composition::CreateFromMass(v);
+
+  std::vector<std::string> commods(args.commods);
+  std::vector<double> demand(args.commods, 0);
+  for (int c = 0; c < args.commods; ++c) {
+    std::stringstream ss;
+    ss << "commod" << c;
+    commods[c] = ss.str();
+  }
+
+  for (int r = 0; r < requesters; ++r) {
+    BenchRequester* t = new BenchRequester(ctx, args.caps);
+    for (int c = 0; c < args.commods; ++c) {
+      for (int n = 0; n < args.nodes; ++n) {
+        double qty = 5 + 10 * unit(rng);
+        demand[c] += qty;
+        t->AddOrder(Material::CreateUntracked(qty, comp), commods[c],
+                    DrawPref(args.prefs, &rng), unit(rng) < args.excl_frac);
+      }
+    }
+    ctx->RegisterTrader(t);
+  }
+
+  for (int s = 0; s < suppliers; ++s) {
+    int c = s % args.commods;
+    int nsup = suppliers / args.commods + (c < suppliers % args.commods);
+    double cap = 0.8 * demand[c] / nsup * (0.5 + unit(rng));
+    BenchSupplier* t = new BenchSupplier(ctx, commods[c], cap,
+                                         DrawPref(args.prefs, &rng),
+                                         unit(rng) < args.excl_frac,
+                                         args.caps);
+    ctx->RegisterTrader(t);
+  }
+}
+
+/// keeps the fastest time of each stage of an exchange
+class StageTimes {
+ public:
+  void Add(const std::string& stage, const std::string& solver, double wall) {
+    std::pair<std::string, std::string> key(stage, solver);
+    if (best_.count(key) == 0) {
+      order_.push_back(key);
+      best_[key] = wall;
+    } else if (wall < best_[key]) {
+      best_[key] = wall;
+    }
+  }
+
+  /// writes a row per stage, prefixed by prefix
+  void Write(const std::string& prefix, std::ostream& out) {
+    for (int i = 0; i < order_.size(); ++i) {
+      out << prefix << " " << order_[i].first << " " << order_[i].second
+          << " " << best_[order_[i]] << "\n";
+    }
+  }
+
+ private:
+  std::vector<std::pair<std::string, std::string> > order_;
+  std::map<std::pair<std::string, std::string>, double> best_;
+};
+
+/// times each stage of material exchanges of synthetic markets at each scale:
+/// collecting requests, bids, and preference adjustments, translating the
+/// exchange into a graph, solving it with each solver, and translating the
+/// solution back into trades
+void BenchDre(const BenchArgs& args) {
+  std::cout << "requesters suppliers commods nodes caps excl_frac prefs "
+            << "arcs stage solver wall\n";
+  for (int sc = 0; sc < args.scales.size(); ++sc) {
+    int requesters = args.requesters * args.scales[sc];
+    int suppliers = args.suppliers * args.scales[sc];
+    cyclus::Timer ti;
+    cyclus::Recorder rec;
+    cyclus::Context ctx(&ti, &rec);
+    BuildMarket(args, requesters, suppliers, &ctx);
+
+    StageTimes times;
+    int narcs = 0;
+    for (int i = 0; i < args.reps; ++i) {
+      cyclus::Stopwatch sw;
+      cyclus::ResourceExchange<Material> exchng(&ctx);
+      sw.Start();
+      exchng.AddAllRequests();
+      times.Add("requests", "-", sw.wall());
+      sw.Start();
+      exchng.AddAllBids();
+      times.Add("bids", "-", sw.wall());
+      sw.Start();
+      exchng.AdjustAll();
+      times.Add("prefs", "-", sw.wall());
+
+      sw.Start();
+      cyclus::ExchangeTranslator<Material> xlator(&exchng.ex_ctx());
+      xlator.aggregate(args.aggregate);
+      ExchangeGraph::Ptr g = xlator.Translate();
+      times.Add("translate", "-", sw.wall());
+      narcs = g->arcs().size();
+
+      for (int s = 0; s < args.solvers.size(); ++s) {
+        double wall;
+        TimeSolve(args, args.solvers[s], g.get(), &wall);
+        times.Add("solve", args.solvers[s], wall);
+
+        sw.Start();
+        std::vector<cyclus::Trade<Material> > trades;
+        xlator.BackTranslateSolution(g->matches(), trades);
+        times.Add("backtranslate", args.solvers[s], sw.wall());
+      }
+    }
+
+    std::stringstream prefix;
+    prefix << requesters << " " << suppliers << " " << args.commods << " "
+           << args.nodes << " " << args.caps << " " << args.excl_frac << " "
+           << args.prefs << " " << narcs;
+    times.Write(prefix.str(), std::cout);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  cyclus::Logger::ReportLevel() = cyclus::LEV_ERROR;
+
+  BenchArgs args;
+  po::options_description desc("Usage: cyclus_bench [options] benchmark "
+                               "[dumps]\n\n"
+                               "Benchmarks:\n"
+                               "  translate  exchange graph to program "
+                               "translation\n"
+                               "  replay     solution of dumped exchange "
+                               "graphs, see CYCLUS_DUMP_DRE\n"
+                               "  dre        each stage of material "
+                               "exchanges of synthetic markets\n\n"
+                               "Results are written as a header row and rows "
+                               "of space separated values.\n\nOptions");
+  desc.add_options()
+      ("help,h", "produce help message")
+      ("requesters", po::value<int>(&args.requesters)->default_value(500),
+       "number of requesters")
+      ("suppliers", po::value<int>(&args.suppliers)->default_value(50),
+       "number of suppliers")
+      ("commods", po::value<int>(&args.commods)->default_value(5),
+       "number of commodities")
+      ("nodes", po::value<int>(&args.nodes)->default_value(2),
+       "request nodes per requester and commodity")
+      ("caps", po::value<int>(&args.caps)->default_value(1),
+       "capacity constraints per portfolio (dre)")
+      ("excl-frac", po::value<double>(&args.excl_frac)->default_value(0.5),
+       "fraction of exclusive requests and suppliers (dre)")
+      ("prefs", po::value<std::string>(&args.prefs)->default_value("uniform"),
+       "preference distribution: constant, uniform, or exponential (dre)")
+      ("seed", po::value<int>(&args.seed)->default_value(1),
+       "random seed of markets (dre)")
+      ("scale", po::value<std::vector<int> >(&args.scales)->multitoken()
+       ->default_value(std::vector<int>(1, 1), "1"),
+       "factors by which requesters and suppliers are scaled (dre)")
+      ("reps", po::value<int>(&args.reps)->default_value(5),
+       "repetitions, the fastest of which is reported")
+      ("threads", po::value<int>(&args.threads)->default_value(1),
+       "number of threads")
+      ("solver", po::value<std::vector<std::string> >(&args.solvers)
+       ->multitoken()
+       ->default_value(std::vector<std::string>(1, "greedy"), "greedy"),
+       "solvers: greedy, priority-greedy, coin-or, coin-or-relax, or "
+       "adaptive")
+      ("exclusive", po::value<bool>(&args.exclusive)->default_value(true),
+       "whether exclusive orders are allowed")
+      ("decompose", po::bool_switch(&args.decompose),
+       "solve graphs by connected component")
+      ("aggregate", po::bool_switch(&args.aggregate),
+       "merge equivalent request portfolios before solving (dre)")
+      ("benchmark", po::value<std::string>(), "the benchmark to run")
+      ("dumps", po::value<std::vector<std::string> >(&args.dumps),
+       "dumped graphs to replay");
+  po::positional_options_description p;
+  p.add("benchmark", 1);
+  p.add("dumps", -1);
+
+  po::variables_map vm;
+  try {
+    po::store(po::command_line_parser(argc, argv).options(desc).positional(p)
+              .run(), vm);
+    po::notify(vm);
+  } catch (std::exception& e) {
+    std::cerr << e.what() << "\n" << desc << "\n";
+    return 1;
+  }
+
+  if (vm.count("help") || vm.count("benchmark") == 0) {
+    std::cout << desc << "\n";
+    return vm.count("help") ? 0 : 1;
+  }
+
+  std::string bench = vm["benchmark"].as<std::string>();
+  try {
+    if (bench == "translate") {
+      BenchTranslate(args);
+    } else if (bench == "replay") {
+      BenchReplay(args);
+    } else if (bench == "dre") {
+      BenchDre(args);
+    } else {
+      throw cyclus::ValueError("unknown benchmark '" + bench + "'");
+    }
+  } catch (cyclus::Error& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
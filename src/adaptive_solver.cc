@@ -0,0 +1,87 @@
+#include "adaptive_solver.h"
+
+#include <vector>
+
+#include "context.h"
+#include "exchange_graph.h"
+#include "greedy_solver.h"
+#include "logger.h"
+#include "prog_solver.h"
+#include "stopwatch.h"
+
+namespace cyclus {
+
+AdaptiveSolver::AdaptiveSolver(bool exclusive_orders)
+    : budget_(kDefaultBudget),
+      max_arcs_(kDefaultMaxArcs),
+      ExchangeSolver(exclusive_orders) {}
+
+AdaptiveSolver::AdaptiveSolver(double budget, int max_arcs,
+                               bool exclusive_orders)
+    : budget_(budget),
+      max_arcs_(max_arcs),
+      ExchangeSolver(exclusive_orders) {}
+
+ExchangeSolver* AdaptiveSolver::Clone() const {
+  AdaptiveSolver* s = new AdaptiveSolver(budget_, max_arcs_,
+                                         exclusive_orders_);
+  s->verbose_ = verbose_;
+  return s;
+}
+
+double AdaptiveSolver::SolveGraph() {
+  Stopwatch sw;
+  sw.Start();
+
+  const std::vector<Arc>& arcs = graph_->arcs();
+  int narcs = arcs.size();
+  int nexcl = 0;
+  if (exclusive_orders_) {
+    for (int i = 0; i != narcs; i++) {
+      nexcl += arcs[i].exclusive();
+    }
+  }
+
+  double obj;
+  if (narcs > max_arcs_) {
+    path_ = "greedy";
+    obj = SolveGreedy();
+  } else {
+    path_ = nexcl == 0 ? "lp" : "milp";
+    ProgSolver prog("cbc", budget_, exclusive_orders_, verbose_, false);
+    prog.budget(budget_);
+    prog.sim_ctx(sim_ctx_);
+    obj = prog.Solve(graph_);
+    if (!prog.finished()) {
+      CLOG(LEV_INFO2) << "Adaptive solver ran out of its " << budget_
+                      << " s budget solving a " << path_ << " with " << narcs
+                      << " arcs, falling back to the greedy solution";
+      path_ += "-fallback";
+      graph_->ClearMatches();
+      obj = SolveGreedy();
+    }
+  }
+
+  RecordPath(narcs, nexcl, sw.wall());
+  return obj;
+}
+
+double AdaptiveSolver::SolveGreedy() {
+  GreedySolver greedy(exclusive_orders_);
+  return greedy.Solve(graph_);
+}
+
+void AdaptiveSolver::RecordPath(int narcs, int nexcl, double wall) {
+  if (sim_ctx_ == NULL) {
+    return;
+  }
+  sim_ctx_->NewDatum("SolverPaths")
+      ->AddVal("Time", sim_ctx_->time())
+      ->AddVal("Path", path_)
+      ->AddVal("NArcs", narcs)
+      ->AddVal("NExclusiveArcs", nexcl)
+      ->AddVal("WallTime", wall)
+      ->Record();
+}
+
+}  // namespace cyclus
@@ -0,0 +1,80 @@
+#ifndef CYCLUS_SRC_ADAPTIVE_SOLVER_H_
+#define CYCLUS_SRC_ADAPTIVE_SOLVER_H_
+
+#include <string>
+
+#include "exchange_solver.h"
+
+namespace cyclus {
+
+class ExchangeGraph;
+
+/// @brief The AdaptiveSolver chooses how to solve each exchange graph based on
+/// its size and exclusivity.
+///
+/// - Graphs with more than max_arcs arcs are solved by a GreedySolver
+///   ("greedy").
+/// - Graphs without exclusive arcs (or any graph, if exclusive orders are
+///   not allowed) translate to linear programs and are solved by a ProgSolver
+///   ("lp").
+/// - All other graphs translate to mixed integer linear programs and are
+///   solved by a ProgSolver ("milp").
+///
+/// Programs are given a wall-clock budget per solve. If a program is not
+/// solved within the budget, the graph is solved by a GreedySolver instead
+/// ("lp-fallback" or "milp-fallback"). The path taken for each solve is
+/// available from path() and, in a simulation, is recorded in the SolverPaths
+/// table together with the graph's size and the time the solve took. Each
+/// component of a decomposed graph (see ExchangeSolver::decompose) chooses
+/// its own path and gets its own budget.
+class AdaptiveSolver: public ExchangeSolver {
+ public:
+  /// default maximum number of arcs of graphs solved as programs
+  static const int kDefaultMaxArcs = 10000;
+
+  /// default budget in seconds
+  static const int kDefaultBudget = 60;
+
+  /// @param budget the wall-clock time in seconds after which a program's
+  /// solution is abandoned, default kDefaultBudget
+  /// @param max_arcs the maximum number of arcs of graphs solved as programs,
+  /// default kDefaultMaxArcs
+  /// @param exclusive_orders whether exclusive orders are allowed
+  /// @{
+  explicit AdaptiveSolver(bool exclusive_orders = kDefaultExclusive);
+  AdaptiveSolver(double budget, int max_arcs, bool exclusive_orders);
+  /// @}
+
+  virtual ~AdaptiveSolver() {}
+
+  /// @return a new AdaptiveSolver with the same settings
+  virtual ExchangeSolver* Clone() const;
+
+  inline double budget() const { return budget_; }
+  inline int max_arcs() const { return max_arcs_; }
+
+  /// @return the path taken by the last solve, "greedy", "lp", "milp",
+  /// "lp-fallback", or "milp-fallback", or an empty string if nothing was
+  /// solved yet
+  inline const std::string& path() const { return path_; }
+
+ protected:
+  /// @brief the AdaptiveSolver solves an ExchangeGraph with the solver chosen
+  /// for it, falling back to a GreedySolver
+  virtual double SolveGraph();
+
+ private:
+  /// solves the graph with a GreedySolver
+  double SolveGreedy();
+
+  /// records the last solve's path in the SolverPaths table
+  void RecordPath(int narcs, int nexcl, double wall);
+
+  double budget_;
+  int max_arcs_;
+  std::string path_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_ADAPTIVE_SOLVER_H_
@@ -65,13 +65,14 @@ Agent::Agent(Context* ctx)
       lifetime_(-1),
       parent_(NULL),
       spec_("UNSPECIFIED") {
-  ctx_->agent_list_.insert(this);
+  ctx_->agent_list_.Add(this);
   MLOG(LEV_DEBUG3) << "Agent ID=" << id_ << ", ptr=" << this << " created.";
 }
 
 Agent::~Agent() {
   MLOG(LEV_DEBUG3) << "Deleting agent '" << prototype() << "' ID=" << id_;
-  context()->agent_list_.erase(this);
+  context()->agent_list_.Remove(this);
+  context()->live_agents_.Remove(this);
 
   std::set<Agent*>::iterator it;
   if (parent_ != NULL) {
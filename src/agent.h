@@ -318,10 +318,50 @@ class Agent : public StateWrangler, virtual public Ider {
   /// their Decommission function.
   virtual void Decommission();
 
-  /// default implementation for material preferences.
+  /// @brief default implementation for material preferences, which adjusts
+  /// them by the PrefMap form of AdjustMatlPrefs. Overrides of this form avoid
+  /// copying preferences into and out of a PrefMap and should not call the
+  /// default.
+  virtual void AdjustMatlPrefs(PrefView<Material>& prefs) {
+    void (Agent::*legacy)(PrefMap<Material>::type&) = &Agent::AdjustMatlPrefs;
+    prefs.AdjustLegacy(this, legacy);
+  }
+
+  /// @brief default implementation for product preferences, which adjusts
+  /// them by the PrefMap form of AdjustProductPrefs. Overrides of this form
+  /// avoid copying preferences into and out of a PrefMap and should not call
+  /// the default.
+  virtual void AdjustProductPrefs(PrefView<Product>& prefs) {
+    void (Agent::*legacy)(PrefMap<Product>::type&) =
+        &Agent::AdjustProductPrefs;
+    prefs.AdjustLegacy(this, legacy);
+  }
+
+  /// @brief adjusts the material preferences of all requesters descending
+  /// from this agent, one view per requester, in a single call per exchange.
+  /// The default adjusts each view by the single-view form of
+  /// AdjustMatlPrefs, so agents that only implement that form (or the PrefMap
+  /// form) are still called once per descending requester.
+  virtual void AdjustMatlPrefs(PrefBatch<Material>::type& prefs) {
+    for (int i = 0; i < prefs.size(); ++i) {
+      AdjustMatlPrefs(prefs[i]);
+    }
+  }
+
+  /// @brief adjusts the product preferences of all requesters descending from
+  /// this agent, see AdjustMatlPrefs(PrefBatch<Material>::type&)
+  virtual void AdjustProductPrefs(PrefBatch<Product>::type& prefs) {
+    for (int i = 0; i < prefs.size(); ++i) {
+      AdjustProductPrefs(prefs[i]);
+    }
+  }
+
+  /// default implementation for material preferences in PrefMap form, which
+  /// does nothing.
   virtual void AdjustMatlPrefs(PrefMap<Material>::type& prefs) {}
 
-  /// default implementation for material preferences.
+  /// default implementation for product preferences in PrefMap form, which
+  /// does nothing.
   virtual void AdjustProductPrefs(PrefMap<Product>::type& prefs) {}
 
   /// Returns an agent's xml rng schema for initializing from input files. All
@@ -0,0 +1,56 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace cyclus {
+
+const std::size_t Arena::kFirstBlock;
+const std::size_t Arena::kMaxBlock;
+
+Arena::Arena(std::size_t max_block)
+    : next_(NULL),
+      left_(0),
+      block_(kFirstBlock),
+      max_block_(std::max(max_block, kFirstBlock)) {}
+
+Arena::~Arena() {
+  for (int i = 0; i < blocks_.size(); ++i) {
+    ::operator delete(blocks_[i]);
+  }
+}
+
+void* Arena::Allocate(std::size_t size, std::size_t align) {
+  std::size_t pad = (align - reinterpret_cast<std::uintptr_t>(next_) % align)
+      % align;
+  if (next_ == NULL || pad + size > left_) {
+    // blocks from operator new are aligned for any object
+    std::size_t n = std::max(block_, size);
+    blocks_.push_back(static_cast<char*>(::operator new(n)));
+    sizes_.push_back(n);
+    next_ = blocks_.back();
+    left_ = n;
+    pad = 0;
+    block_ = std::min(2 * block_, max_block_);
+  }
+  void* p = next_ + pad;
+  next_ += pad + size;
+  left_ -= pad + size;
+  return p;
+}
+
+void Arena::Reset() {
+  if (blocks_.empty()) {
+    return;
+  }
+  for (int i = 0; i + 1 < blocks_.size(); ++i) {
+    ::operator delete(blocks_[i]);
+  }
+  blocks_.erase(blocks_.begin(), blocks_.end() - 1);
+  sizes_.erase(sizes_.begin(), sizes_.end() - 1);
+  next_ = blocks_.back();
+  left_ = sizes_.back();
+}
+
+}  // namespace cyclus
@@ -0,0 +1,110 @@
+#ifndef CYCLUS_SRC_ARENA_H_
+#define CYCLUS_SRC_ARENA_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+namespace cyclus {
+
+/// @class Arena
+///
+/// @brief A bump allocator for objects that are all freed at once, e.g., the
+/// requests and bids of a portfolio or the nodes of a translated exchange
+/// graph. Memory is handed out from blocks that double in size up to a
+/// maximum, so that a few objects cost one allocation and many objects cost
+/// few. Memory is only released by Reset or when the arena is destroyed; the
+/// destructors of objects constructed in it are not called by the arena.
+class Arena {
+ public:
+  /// the size of the first block
+  static const std::size_t kFirstBlock = 256;
+
+  /// the default maximum size of blocks
+  static const std::size_t kMaxBlock = 64 * 1024;
+
+  /// @param max_block the maximum size of blocks, except of those holding
+  /// larger allocations
+  explicit Arena(std::size_t max_block = kMaxBlock);
+
+  ~Arena();
+
+  /// @return uninitialized memory of a size and alignment, which must be a
+  /// power of two no larger than that of std::max_align_t
+  void* Allocate(std::size_t size, std::size_t align);
+
+  /// @brief frees all memory handed out, keeping the last block for reuse
+  void Reset();
+
+  /// @return the number of blocks held
+  inline int n_blocks() const { return blocks_.size(); }
+
+ private:
+  Arena(const Arena&);
+  Arena& operator=(const Arena&);
+
+  std::vector<char*> blocks_;
+  std::vector<std::size_t> sizes_;
+  char* next_;
+  std::size_t left_;
+  std::size_t block_;
+  std::size_t max_block_;
+};
+
+/// @class ArenaAllocator
+///
+/// @brief A standard allocator that allocates from an Arena and keeps it
+/// alive, e.g., to make shared pointers whose objects and control blocks live
+/// in an arena:
+///
+/// @code
+/// boost::shared_ptr<Arena> arena(new Arena());
+/// ExchangeNode::Ptr n = boost::allocate_shared<ExchangeNode>(
+///     ArenaAllocator<ExchangeNode>(arena), qty, exclusive, commod, id);
+/// @endcode
+///
+/// The arena is freed when the last allocator copy, and thus the last object
+/// allocated through one, is destroyed. Deallocation does nothing.
+template <class T>
+class ArenaAllocator {
+ public:
+  typedef T value_type;
+
+  explicit ArenaAllocator(boost::shared_ptr<Arena> arena) : arena_(arena) {}
+
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  template <class U>
+  struct rebind {
+    typedef ArenaAllocator<U> other;
+  };
+
+  inline T* allocate(std::size_t n) {
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  inline void deallocate(T* p, std::size_t n) {}
+
+  inline const boost::shared_ptr<Arena>& arena() const { return arena_; }
+
+ private:
+  boost::shared_ptr<Arena> arena_;
+};
+
+template <class T, class U>
+inline bool operator==(const ArenaAllocator<T>& lhs,
+                       const ArenaAllocator<U>& rhs) {
+  return lhs.arena() == rhs.arena();
+}
+
+template <class T, class U>
+inline bool operator!=(const ArenaAllocator<T>& lhs,
+                       const ArenaAllocator<U>& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_ARENA_H_
@@ -65,6 +65,9 @@ class Bid {
   }
 
  private:
+  /// portfolios construct their own in place
+  friend class BidPortfolio<T>;
+
   /// @brief constructors are private to require use of factory methods
   Bid(Request<T>* request, boost::shared_ptr<T> offer, Trader* bidder,
       bool exclusive = false)
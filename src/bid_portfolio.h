@@ -1,12 +1,14 @@
 #ifndef CYCLUS_SRC_BID_PORTFOLIO_H_
 #define CYCLUS_SRC_BID_PORTFOLIO_H_
 
+#include <new>
 #include <set>
 #include <string>
 #include <sstream>
 
 #include <boost/shared_ptr.hpp>
 
+#include "arena.h"
 #include "bid.h"
 #include "capacity_constraint.h"
 #include "error.h"
@@ -30,6 +32,11 @@ std::string GetTraderSpec(Trader* bidder);
 /// and constraints for a given bidder, guaranteeing a single bidder per
 /// portfolio. Responses are grouped by the bidder. Constraints are assumed to
 /// act over the entire set of possible bids.
+///
+/// Bids are owned by their portfolio and are allocated together in an Arena
+/// of it. A bid, and pointers to it, are valid exactly as long as its
+/// portfolio; archetypes must not delete bids, and must keep the portfolio
+/// (not only the bid) alive to use a bid after the exchange it was made in.
 template <class T>
 class BidPortfolio : public boost::enable_shared_from_this< BidPortfolio<T> > {
  public:
@@ -38,11 +45,11 @@ class BidPortfolio : public boost::enable_shared_from_this< BidPortfolio<T> > {
   /// @brief default constructor
   BidPortfolio() : bidder_(NULL) {}
 
-  /// deletes all bids associated with it
+  /// destroys all bids associated with it
   ~BidPortfolio() {
     typename std::set<Bid<T>*>::iterator it;
     for (it = bids_.begin(); it != bids_.end(); ++it) {
-      delete *it;
+      (*it)->~Bid<T>();
     }
   }
 
@@ -54,17 +61,16 @@ class BidPortfolio : public boost::enable_shared_from_this< BidPortfolio<T> > {
   /// original
   Bid<T>* AddBid(Request<T>* request, boost::shared_ptr<T> offer,
                  Trader* bidder, bool exclusive = false) {
-    Bid<T>* b =
-        Bid<T>::Create(request, offer, bidder, this->shared_from_this(),
-                       exclusive);
-    VerifyResponder_(b);
-    if(offer->quantity() > 0 )
-      bids_.insert(b);
-    else{
+    VerifyResponder_(bidder);
+    if (offer->quantity() <= 0) {
       std::stringstream ss;
       ss << GetTraderPrototype(bidder) << " from " << GetTraderSpec(bidder) << " is offering a bid quantity <= 0, Q = " << offer->quantity() ;
       throw ValueError(ss.str());
     }
+    void* mem = arena_.Allocate(sizeof(Bid<T>), alignof(Bid<T>));
+    Bid<T>* b = new (mem) Bid<T>(request, offer, bidder,
+                                 this->shared_from_this(), exclusive);
+    bids_.insert(b);
     return b;
   }
 
@@ -113,10 +119,10 @@ class BidPortfolio : public boost::enable_shared_from_this< BidPortfolio<T> > {
   /// portfolio's bidder
   /// @throws KeyError if a bid is added from a different bidder than the
   /// original
-  void VerifyResponder_(Bid<T>* b) {
+  void VerifyResponder_(Trader* bidder) {
     if (bidder_ == NULL) {
-      bidder_ = b->bidder();
-    } else if (bidder_ != b->bidder()) {
+      bidder_ = bidder;
+    } else if (bidder_ != bidder) {
       std::string msg = "Insertion error: bidders do not match.";
       throw KeyError(msg);
     }
@@ -125,6 +131,9 @@ class BidPortfolio : public boost::enable_shared_from_this< BidPortfolio<T> > {
   /// @brief *deprecated*
   void VerifyCommodity_(const Bid<T>* r) { }
   
+  /// the memory of the bids
+  Arena arena_;
+
   // bid_ is a set because there is a one-to-one correspondence between a
   // bid and a request, i.e., bids are unique
   std::set<Bid<T>*> bids_;
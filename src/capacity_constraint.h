@@ -27,6 +27,16 @@ struct Converter {
       Arc const * a = NULL,
       ExchangeTranslationContext<T> const * ctx = NULL) const = 0;
 
+  /// @brief whether conversions are pure functions of the offer's
+  /// composition and quantity, i.e., do not depend on the arc or exchange
+  /// context, so that repeated offers of the same resource need only be
+  /// converted once per exchange. Converters doing composition math, e.g.,
+  /// the SWU or fissile content of an offer, should override it to return
+  /// true. Default false.
+  virtual bool pure() const {
+    return false;
+  }
+
   /// @brief operator== is available for subclassing, see
   /// cyclus::TrivialConverter for an example
   virtual bool operator==(Converter& other) const {
@@ -50,6 +60,10 @@ struct TrivialConverter : public Converter<T> {
     return offer->quantity();
   }
 
+  virtual bool pure() const {
+    return true;
+  }
+
   /// @returns true if a dynamic cast succeeds
   virtual bool operator==(Converter<T>& other) const {
     return dynamic_cast<TrivialConverter<T>*>(&other) != NULL;
@@ -0,0 +1,32 @@
+#include "commodity_table.h"
+
+#include <sstream>
+
+#include "error.h"
+
+namespace cyclus {
+
+int CommodityTable::Intern(const std::string& name) {
+  std::pair<std::unordered_map<std::string, int>::iterator, bool> ins =
+      ids_.insert(std::make_pair(name, static_cast<int>(names_.size())));
+  if (ins.second) {
+    names_.push_back(name);
+  }
+  return ins.first->second;
+}
+
+int CommodityTable::Find(const std::string& name) const {
+  std::unordered_map<std::string, int>::const_iterator it = ids_.find(name);
+  return it == ids_.end() ? -1 : it->second;
+}
+
+const std::string& CommodityTable::Name(int id) const {
+  if (id < 0 || id >= names_.size()) {
+    std::stringstream ss;
+    ss << "no commodity with id " << id;
+    throw KeyError(ss.str());
+  }
+  return names_[id];
+}
+
+}  // namespace cyclus
@@ -0,0 +1,40 @@
+#ifndef CYCLUS_SRC_COMMODITY_TABLE_H_
+#define CYCLUS_SRC_COMMODITY_TABLE_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cyclus {
+
+/// @class CommodityTable
+///
+/// @brief Interns commodity names into dense integer ids, which are handed
+/// out in increasing order starting at 0, so that the dynamic resource
+/// exchange can group and compare commodities by id rather than by name. Ids
+/// are never reused or invalidated.
+///
+/// Each simulation Context owns a table (see Context::commodities).
+class CommodityTable {
+ public:
+  /// @return the id of a commodity, adding it to the table if it is new
+  int Intern(const std::string& name);
+
+  /// @return the id of a commodity or -1 if it is not in the table
+  int Find(const std::string& name) const;
+
+  /// @return the name of the commodity with the given id
+  /// @throws KeyError if there is no such commodity
+  const std::string& Name(int id) const;
+
+  /// @return the number of commodities in the table
+  inline int size() const { return names_.size(); }
+
+ private:
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, int> ids_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_COMMODITY_TABLE_H_
@@ -21,6 +21,9 @@ SimInfo::SimInfo()
       branch_time(-1),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      explicit_inventory_changes(false),
+      record_timings(false),
+      threads(1),
       parent_sim(boost::uuids::nil_uuid()),
       parent_type("init") {}
 
@@ -34,6 +37,9 @@ SimInfo::SimInfo(int dur, int y0, int m0, std::string handle)
       handle(handle),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      explicit_inventory_changes(false),
+      record_timings(false),
+      threads(1),
       parent_sim(boost::uuids::nil_uuid()),
       parent_type("init") {}
 
@@ -47,6 +53,9 @@ SimInfo::SimInfo(int dur, int y0, int m0, std::string handle, std::string d)
       handle(handle),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      explicit_inventory_changes(false),
+      record_timings(false),
+      threads(1),
       parent_sim(boost::uuids::nil_uuid()),
       parent_type("init") {}
 
@@ -63,8 +72,15 @@ SimInfo::SimInfo(int dur, boost::uuids::uuid parent_sim,
       branch_time(branch_time),
       explicit_inventory(false),
       explicit_inventory_compact(false),
+      explicit_inventory_changes(false),
+      record_timings(false),
+      threads(1),
       handle(handle) {}
 
+int TraderIdFn::operator()(Trader* t) const {
+  return t->manager()->id();
+}
+
 Context::Context(Timer* ti, Recorder* rec)
     : ti_(ti),
       rec_(rec),
@@ -80,7 +96,7 @@ Context::~Context() {
   // initiate deletion of agents that don't have parents.
   // dealloc will propagate through hierarchy as agents delete their children
   std::vector<Agent*> to_del;
-  std::set<Agent*>::iterator it;
+  AgentRegistry::iterator it;
   for (it = agent_list_.begin(); it != agent_list_.end(); ++it) {
     if ((*it)->parent() == NULL) {
       to_del.push_back(*it);
@@ -92,8 +108,7 @@ Context::~Context() {
 }
 
 void Context::DelAgent(Agent* m) {
-  int n = agent_list_.erase(m);
-  if (n == 1) {
+  if (agent_list_.Remove(m)) {
     delete m;
     m = NULL;
   }
@@ -113,6 +128,23 @@ void Context::SchedBuild(Agent* parent, std::string proto_name, int t) {
       ->Record();
 }
 
+void Context::SchedBuilds(Agent* parent,
+                          const std::vector<std::string>& protos, int t) {
+  if (t == -1) {
+    t = time() + 1;
+  }
+  int pid = (parent != NULL) ? parent->id() : -1;
+  ti_->SchedBuilds(parent, protos, t);
+  for (int i = 0; i < protos.size(); ++i) {
+    NewDatum("BuildSchedule")
+        ->AddVal("ParentId", pid)
+        ->AddVal("Prototype", protos[i])
+        ->AddVal("SchedTime", time())
+        ->AddVal("BuildTime", t)
+        ->Record();
+  }
+}
+
 void Context::SchedDecom(Agent* m, int t) {
   if (t == -1) {
     t = time();
@@ -125,6 +157,20 @@ void Context::SchedDecom(Agent* m, int t) {
       ->Record();
 }
 
+void Context::SchedDecoms(const std::vector<Agent*>& ms, int t) {
+  if (t == -1) {
+    t = time();
+  }
+  ti_->SchedDecoms(ms, t);
+  for (int i = 0; i < ms.size(); ++i) {
+    NewDatum("DecomSchedule")
+        ->AddVal("AgentId", ms[i]->id())
+        ->AddVal("SchedTime", time())
+        ->AddVal("DecomTime", t)
+        ->Record();
+  }
+}
+
 boost::uuids::uuid Context::sim_id() {
   return rec_->sim_id();
 }
@@ -198,6 +244,11 @@ void Context::InitSim(SimInfo si) {
   NewDatum("InfoExplicitInv")
       ->AddVal("RecordInventory", si.explicit_inventory)
       ->AddVal("RecordInventoryCompact", si.explicit_inventory_compact)
+      ->AddVal("RecordInventoryChanges", si.explicit_inventory_changes)
+      ->Record();
+
+  NewDatum("InfoTimings")
+      ->AddVal("RecordTimings", si.record_timings)
       ->Record();
 
   // TODO: when the backends get uint64_t support, the static_cast here should
@@ -218,6 +269,19 @@ int Context::time() {
   return ti_->time();
 }
 
+void Context::threads(int n) {
+  si_.threads = n;
+  ti_->threads(n);
+}
+
+ThreadPool* Context::thread_pool() {
+  return ti_->pool();
+}
+
+bool Context::ThreadSafe(Agent* a) {
+  return ti_->ThreadSafe(a);
+}
+
 void Context::RegisterTimeListener(TimeListener* tl) {
   ti_->RegisterTimeListener(tl);
 }
@@ -226,6 +290,18 @@ void Context::UnregisterTimeListener(TimeListener* tl) {
   ti_->UnregisterTimeListener(tl);
 }
 
+void Context::Wake(TimeListener* tl) {
+  ti_->Wake(tl);
+}
+
+void Context::RegisterMarket(Market* m) {
+  ti_->RegisterMarket(m);
+}
+
+void Context::UnregisterMarket(Market* m) {
+  ti_->UnregisterMarket(m);
+}
+
 Datum* Context::NewDatum(std::string title) {
   return rec_->NewDatum(title);
 }
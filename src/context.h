@@ -4,6 +4,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 #ifndef CYCPP
@@ -13,9 +14,11 @@
 #include <boost/uuid/uuid_generators.hpp>
 #endif
 
-#include "composition.h"
 #include "agent.h"
+#include "commodity_table.h"
+#include "composition.h"
 #include "greedy_solver.h"
+#include "id_registry.h"
 #include "recorder.h"
 
 const uint64_t kDefaultTimeStepDur = 2629846;
@@ -26,12 +29,32 @@ namespace cyclus {
 
 class Datum;
 class ExchangeSolver;
+class Market;
+class ThreadPool;
+template <class T> class ResourceExchange;
 class Recorder;
 class Trader;
 class Timer;
 class TimeListener;
 class SimInit;
 
+/// Returns an agent's id for ordering agents in an IdRegistry.
+struct AgentIdFn {
+  inline int operator()(Agent* a) const { return a->id(); }
+};
+
+/// Returns the id of a trader's manager for ordering traders in an
+/// IdRegistry.
+struct TraderIdFn {
+  int operator()(Trader* t) const;
+};
+
+/// Agents ordered by id.
+typedef IdRegistry<Agent, AgentIdFn> AgentRegistry;
+
+/// Traders ordered by their manager's id.
+typedef IdRegistry<Trader, TraderIdFn> TraderRegistry;
+
 /// Container for a static simulation-global parameters that both describe
 /// the simulation and affect its behavior.
 class SimInfo {
@@ -106,6 +129,26 @@ class SimInfo {
   /// every time step in a table (i.e. agent ID, Time, Quantity,
   /// Composition-object and/or reference).
   bool explicit_inventory_compact;
+
+  /// True if explicit inventories (see explicit_inventory and
+  /// explicit_inventory_compact) are only recorded in time steps in which
+  /// their contents changed. Nuclides that leave an inventory are recorded
+  /// with a zero quantity and emptied inventories with a zero total quantity.
+  bool explicit_inventory_changes;
+
+  /// True if the wall-clock and processor time spent in each simulation phase
+  /// and the time spent ticking/tocking each archetype should be recorded
+  /// every time step in the PhaseTimings and ArchetypeTimings tables.
+  bool record_timings;
+
+  /// Number of threads used to run the Tick and Tock phases of agents whose
+  /// archetypes are annotated as thread-safe and to collect their resource
+  /// exchange requests and bids. Values less than 2 run every agent serially.
+  /// With more than one thread, explicit inventories are also computed and
+  /// recorded in the background, and the connected components of exchange
+  /// graphs are solved concurrently if the solver decomposes them (see
+  /// ExchangeSolver::decompose).
+  int threads;
 };
 
 /// A simulation context provides access to necessary simulation-global
@@ -125,6 +168,8 @@ class Context {
   friend class SimInit;
   friend class Agent;
   friend class Timer;
+  friend class ExchangeSolver;
+  template <class T> friend class ResourceExchange;
 
   /// Creates a new context working with the specified timer and datum manager.
   /// The timer does not have to be initialized (yet).
@@ -151,16 +196,17 @@ class Context {
   /// Registers an agent as a participant in resource exchanges. Agents should
   /// register from their Deploy method.
   inline void RegisterTrader(Trader* e) {
-    traders_.insert(e);
+    traders_.Add(e);
   }
 
   /// Unregisters an agent as a participant in resource exchanges.
   inline void UnregisterTrader(Trader* e) {
-    traders_.erase(e);
+    traders_.Remove(e);
   }
 
-  /// @return the current set of traders registered for resource exchange.
-  inline const std::set<Trader*>& traders() const {
+  /// @return the current set of traders registered for resource exchange,
+  /// iterated in order of their managers' ids.
+  inline const TraderRegistry& traders() const {
     return traders_;
   }
 
@@ -195,11 +241,21 @@ class Context {
   /// next build phase (i.e. the start of the next timestep).
   void SchedBuild(Agent* parent, std::string proto_name, int t = -1);
 
+  /// Schedules each of the named prototypes to be built for the specified
+  /// parent at timestep t (with the same default as SchedBuild). This is
+  /// cheaper than scheduling the builds one by one when deploying a fleet.
+  void SchedBuilds(Agent* parent, const std::vector<std::string>& protos,
+                   int t = -1);
+
   /// Schedules the given Agent to be decommissioned at the specified timestep
   /// t. The default t=-1 results in the decommission being scheduled for the
   /// next decommission phase (i.e. the end of the current timestep).
   void SchedDecom(Agent* m, int time = -1);
 
+  /// Schedules each of the given agents to be decommissioned at timestep t
+  /// (with the same default as SchedDecom).
+  void SchedDecoms(const std::vector<Agent*>& ms, int time = -1);
+
   /// Adds a composition recipe to a simulation-wide accessible list.
   /// Agents should NOT add their own recipes.
   void AddRecipe(std::string name, Composition::Ptr c);
@@ -218,6 +274,18 @@ class Context {
   /// Agents should unregister from their Decommission method.
   void UnregisterTimeListener(TimeListener* tl);
 
+  /// Wakes a sleeping agent (see TimeListener::NextWake) so that it takes
+  /// part in the remaining phases of the current timestep.
+  void Wake(TimeListener* tl);
+
+  /// Registers a market (e.g. of a custom resource type) to be executed
+  /// every timestep after the Material and Product markets (see
+  /// Timer::RegisterMarket).
+  void RegisterMarket(Market* m);
+
+  /// Removes a market from being executed every timestep.
+  void UnregisterMarket(Market* m);
+
   /// Initializes the simulation time parameters. Should only be called once -
   /// NOT idempotent.
   void InitSim(SimInfo si);
@@ -233,6 +301,18 @@ class Context {
     return si_;
   }
 
+  /// Sets the number of threads used to run the Tick and Tock phases of
+  /// thread-safe agents (see SimInfo::threads).
+  void threads(int n);
+
+  /// Returns the thread pool of the running simulation, or NULL if the
+  /// simulation runs serially.
+  ThreadPool* thread_pool();
+
+  /// Returns true if the agent's archetype is annotated as thread-safe (i.e.
+  /// has a true "thread_safe" class-level annotation).
+  bool ThreadSafe(Agent* a);
+
   /// See Recorder::NewDatum documentation.
   Datum* NewDatum(std::string title);
 
@@ -243,6 +323,11 @@ class Context {
   /// Schedules the simulation to be terminated at the end of this timestep.
   void KillSim();
 
+  /// @return the table interning the names of the simulation's commodities
+  inline CommodityTable& commodities() {
+    return commodities_;
+  }
+
   /// @return the next transaction id
   inline int NextTransactionID() {
     return trans_id_++;
@@ -279,12 +364,14 @@ class Context {
   inline void RegisterAgent(Agent* a) {
     n_prototypes_[a->prototype()]++;
     n_specs_[a->spec()]++;
+    live_agents_.Add(a);
   }
 
   /// Unregisters an agent as a participant in the simulation.
   inline void UnregisterAgent(Agent* a) {
     n_prototypes_[a->prototype()]--;
     n_specs_[a->spec()]--;
+    live_agents_.Remove(a);
   }
 
   /// contains archetype specs of all agents for which version have already
@@ -293,8 +380,12 @@ class Context {
 
   std::map<std::string, Agent*> protos_;
   std::map<std::string, Composition::Ptr> recipes_;
-  std::set<Agent*> agent_list_;
-  std::set<Trader*> traders_;
+  /// all agents, including prototypes and agents that haven't been built
+  AgentRegistry agent_list_;
+  /// agents currently participating in the simulation
+  AgentRegistry live_agents_;
+  TraderRegistry traders_;
+  CommodityTable commodities_;
   std::map<std::string, int> n_prototypes_;
   std::map<std::string, int> n_specs_;
 
@@ -0,0 +1,38 @@
+#include "conversion_cache.h"
+
+namespace cyclus {
+
+bool ConversionCache::Find(const void* converter, const void* offer,
+                           int comp, double qty, double* val) {
+  OfferKey okey(converter, offer);
+  std::map<OfferKey, double>::iterator it = by_offer_.find(okey);
+  if (it != by_offer_.end()) {
+    *val = it->second;
+    ++n_reused_;
+    return true;
+  }
+  if (comp < 0) {
+    return false;
+  }
+
+  CompKey ckey(converter, std::make_pair(comp, qty));
+  std::map<CompKey, double>::iterator cit = by_comp_.find(ckey);
+  if (cit == by_comp_.end()) {
+    return false;
+  }
+  *val = cit->second;
+  by_offer_[okey] = *val;
+  ++n_reused_;
+  return true;
+}
+
+void ConversionCache::Add(const void* converter, const void* offer, int comp,
+                          double qty, double val) {
+  by_offer_[OfferKey(converter, offer)] = val;
+  if (comp >= 0) {
+    by_comp_[CompKey(converter, std::make_pair(comp, qty))] = val;
+  }
+  ++n_converted_;
+}
+
+}  // namespace cyclus
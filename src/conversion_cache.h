@@ -0,0 +1,56 @@
+#ifndef CYCLUS_SRC_CONVERSION_CACHE_H_
+#define CYCLUS_SRC_CONVERSION_CACHE_H_
+
+#include <map>
+#include <utility>
+
+namespace cyclus {
+
+/// @class ConversionCache
+///
+/// @brief Keeps the capacity conversions of offers made while translating an
+/// exchange, so that repeated offers of the same resource are converted once
+/// per converter (see Converter::pure and TranslateCapacities).
+///
+/// Conversions are kept per converter and offer and, for resources with a
+/// composition, per converter, composition id, and quantity, so that
+/// separately created offers of the same material share their conversion.
+/// Only conversions of pure converters may be kept, as other converters may
+/// depend on the arc or exchange context.
+class ConversionCache {
+ public:
+  ConversionCache() : n_reused_(0), n_converted_(0) {}
+
+  /// @brief looks up a kept conversion
+  /// @param converter the converter
+  /// @param offer the offered resource
+  /// @param comp the id of the offer's composition, or -1 if it has none
+  /// @param qty the offer's quantity
+  /// @param val set to the conversion, if it was kept
+  /// @return whether a conversion was kept for the offer
+  bool Find(const void* converter, const void* offer, int comp, double qty,
+            double* val);
+
+  /// @brief keeps the conversion of an offer, with the arguments of Find
+  void Add(const void* converter, const void* offer, int comp, double qty,
+           double val);
+
+  /// @return the number of conversions that were found or added
+  /// @{
+  inline int n_reused() const { return n_reused_; }
+  inline int n_converted() const { return n_converted_; }
+  /// @}
+
+ private:
+  typedef std::pair<const void*, const void*> OfferKey;
+  typedef std::pair<const void*, std::pair<int, double> > CompKey;
+
+  std::map<OfferKey, double> by_offer_;
+  std::map<CompKey, double> by_comp_;
+  int n_reused_;
+  int n_converted_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_CONVERSION_CACHE_H_
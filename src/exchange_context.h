@@ -7,18 +7,17 @@
 #include <utility>
 #include <vector>
 
+#include <boost/shared_ptr.hpp>
+
 #include "bid.h"
 #include "bid_portfolio.h"
+#include "commodity_table.h"
+#include "pref_table.h"
 #include "request.h"
 #include "request_portfolio.h"
 
 namespace cyclus {
 
-template <class T>
-struct PrefMap {
-  typedef std::map<Request<T>*, std::map<Bid<T>*, double> > type;
-};
-
 template <class T>
 struct CommodMap {
   typedef std::map<std::string, std::vector<Request<T>*> > type;
@@ -36,9 +35,23 @@ struct CommodMap {
 /// Exchange. The second phase, Response to Request for Bids, is assisted by
 /// grouping requests by commodity type. The third phase, preference adjustment,
 /// is assisted by grouping bids by the requester being responded to.
+///
+/// The commodities of requests are interned in a CommodityTable as they are
+/// added, setting each request's commod_id, which is carried by the nodes of
+/// the translated ExchangeGraph.
 template <class T>
 struct ExchangeContext {
  public:
+  /// @brief an exchange context interning commodities in a table of its own
+  ExchangeContext() : own_commods_(new CommodityTable()) {
+    commodities = own_commods_.get();
+  }
+
+  /// @brief an exchange context interning commodities in a shared table,
+  /// e.g., the simulation's (see Context::commodities)
+  explicit ExchangeContext(CommodityTable* commods)
+      : commodities(commods) {}
+
   /// @brief adds a request to the context
   void AddRequestPortfolio(const typename RequestPortfolio<T>::Ptr port) {
     requests.push_back(port);
@@ -55,7 +68,16 @@ struct ExchangeContext {
   void AddRequest(Request<T>* pr) {
     assert(pr->requester() != NULL);
     requesters.insert(pr->requester());
-    commod_requests[pr->commodity()].push_back(pr);
+    std::vector<Request<T>*>& reqs = commod_requests[pr->commodity()];
+    // a commodity is only interned when it is first requested
+    int id = reqs.empty() ? commodities->Intern(pr->commodity()) :
+             reqs.front()->commod_id();
+    pr->commod_id(id);
+    reqs.push_back(pr);
+    if (id >= n_commod_requests.size()) {
+      n_commod_requests.resize(id + 1, 0);
+    }
+    n_commod_requests[id]++;
   }
 
   /// @brief adds a bid to the context
@@ -78,9 +100,7 @@ struct ExchangeContext {
     bidders.insert(pb->bidder());
 
     bids_by_request[pb->request()].push_back(pb);
-
-    trader_prefs[pb->request()->requester()][pb->request()].insert(
-        std::make_pair(pb, pb->request()->preference()));
+    prefs.Add(pb, pb->request()->preference());
   }
 
   /// @brief a reference to an exchange's set of requests
@@ -98,12 +118,21 @@ struct ExchangeContext {
   /// @brief maps commodity name to requests for that commodity
   typename CommodMap<T>::type commod_requests;
 
+  /// @brief the number of requests for each commodity, indexed by commod_id
+  std::vector<int> n_commod_requests;
+
   /// @brief maps request to all bids for request
   std::map< Request<T>*, std::vector<Bid<T>*> >
       bids_by_request;
 
-  /// @brief maps commodity name to requests for that commodity
-  std::map<Trader*, typename PrefMap<T>::type> trader_prefs;
+  /// @brief the preference of each request-bid pair, initially the request's
+  PrefTable<T> prefs;
+
+  /// @brief the table in which request commodities are interned
+  CommodityTable* commodities;
+
+ private:
+  boost::shared_ptr<CommodityTable> own_commods_;
 };
 
 }  // namespace cyclus
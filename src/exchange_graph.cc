@@ -5,6 +5,7 @@
 
 #include "cyc_limits.h"
 #include "error.h"
+#include "flat_exchange_graph.h"
 #include "logger.h"
 
 namespace cyclus {
@@ -14,6 +15,7 @@ ExchangeNode::ExchangeNode(double qty, bool exclusive, std::string commod,
     : qty(qty),
       exclusive(exclusive),
       commod(commod),
+      commod_id(-1),
       agent_id(agent_id),
       group(NULL) {}
 
@@ -21,6 +23,7 @@ ExchangeNode::ExchangeNode(double qty, bool exclusive)
     : qty(qty),
       exclusive(exclusive),
       commod(""),
+      commod_id(-1),
       agent_id(-1),
       group(NULL) {}
 
@@ -28,6 +31,7 @@ ExchangeNode::ExchangeNode(double qty, bool exclusive, std::string commod)
     : qty(qty),
       exclusive(exclusive),
       commod(commod),
+      commod_id(-1),
       agent_id(-1),
       group(NULL) {}
 
@@ -35,6 +39,7 @@ ExchangeNode::ExchangeNode(double qty)
     : qty(qty),
       exclusive(false),
       commod(""),
+      commod_id(-1),
       agent_id(-1),
       group(NULL) {}
 
@@ -42,6 +47,7 @@ ExchangeNode::ExchangeNode()
     : qty(std::numeric_limits<double>::max()),
       exclusive(false),
       commod(""),
+      commod_id(-1),
       agent_id(-1),
       group(NULL) {}
 
@@ -111,26 +117,44 @@ void RequestGroup::AddExchangeNode(ExchangeNode::Ptr node) {
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-ExchangeGraph::ExchangeGraph() : next_arc_id_(0) { }
+ExchangeGraph::ExchangeGraph() : n_indexed_(0) { }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ExchangeGraph::AddRequestGroup(RequestGroup::Ptr prs) {
   request_groups_.push_back(prs);
+  flat_.reset();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ExchangeGraph::AddSupplyGroup(ExchangeNodeGroup::Ptr pss) {
   supply_groups_.push_back(pss);
+  flat_.reset();
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void ExchangeGraph::AddArc(const Arc& a) {
-  arcs_.push_back(a);    
-  int id = next_arc_id_++;
-  arc_ids_.insert(std::pair<Arc, int>(a, id));
-  arc_by_id_.insert(std::pair<int, Arc>(id, a));
+  arcs_.push_back(a);
   node_arc_map_[a.unode()].push_back(a);
   node_arc_map_[a.vnode()].push_back(a);
+  flat_.reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+boost::shared_ptr<FlatExchangeGraph> ExchangeGraph::flat() const {
+  // a copied graph shares the flat graph of the original until it is rebuilt
+  if (flat_ == NULL || flat_->graph() != this) {
+    flat_.reset(new FlatExchangeGraph(const_cast<ExchangeGraph*>(this)));
+  }
+  return flat_;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ExchangeGraph::IndexArcs() const {
+  for (; n_indexed_ < arcs_.size(); n_indexed_++) {
+    const Arc& a = arcs_[n_indexed_];
+    arc_ids_.insert(std::pair<Arc, int>(a, n_indexed_));
+    arc_by_id_.insert(std::pair<int, Arc>(n_indexed_, a));
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -138,4 +162,77 @@ void ExchangeGraph::AddMatch(const Arc& a, double qty) {
   matches_.push_back(std::make_pair(a, qty));
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+namespace {
+
+int FindRoot(std::vector<int>& parents, int i) {
+  while (parents[i] != i) {
+    parents[i] = parents[parents[i]];  // path halving
+    i = parents[i];
+  }
+  return i;
+}
+
+}  // namespace
+
+std::vector<ExchangeGraph::Ptr> ExchangeGraph::Components() const {
+  // request groups are indexed first, followed by supply groups
+  int nreq = request_groups_.size();
+  int ngrps = nreq + supply_groups_.size();
+  std::map<const ExchangeNodeGroup*, int> grp_index;
+  for (int i = 0; i < nreq; ++i) {
+    grp_index[request_groups_[i].get()] = i;
+  }
+  for (int i = 0; i < supply_groups_.size(); ++i) {
+    grp_index[supply_groups_[i].get()] = nreq + i;
+  }
+
+  // union the groups connected by each arc, keeping the smaller index as the
+  // root so that every component is rooted at its first request group
+  std::vector<int> parents(ngrps);
+  std::vector<bool> has_arcs(ngrps, false);
+  for (int i = 0; i < ngrps; ++i) {
+    parents[i] = i;
+  }
+  std::vector<int> arc_grps(arcs_.size());
+  for (int i = 0; i < arcs_.size(); ++i) {
+    int u = grp_index.at(arcs_[i].unode()->group);
+    int v = grp_index.at(arcs_[i].vnode()->group);
+    has_arcs[u] = true;
+    has_arcs[v] = true;
+    arc_grps[i] = u;
+    u = FindRoot(parents, u);
+    v = FindRoot(parents, v);
+    if (u < v) {
+      parents[v] = u;
+    } else if (v < u) {
+      parents[u] = v;
+    }
+  }
+
+  std::vector<ExchangeGraph::Ptr> comps;
+  std::vector<int> comp_index(ngrps, -1);
+  for (int i = 0; i < ngrps; ++i) {
+    if (!has_arcs[i]) {
+      continue;
+    }
+    int root = FindRoot(parents, i);
+    if (comp_index[root] == -1) {
+      comp_index[root] = comps.size();
+      comps.push_back(ExchangeGraph::Ptr(new ExchangeGraph()));
+    }
+    ExchangeGraph::Ptr& comp = comps[comp_index[root]];
+    if (i < nreq) {
+      comp->AddRequestGroup(request_groups_[i]);
+    } else {
+      comp->AddSupplyGroup(supply_groups_[i - nreq]);
+    }
+  }
+
+  for (int i = 0; i < arcs_.size(); ++i) {
+    comps[comp_index[FindRoot(parents, arc_grps[i])]]->AddArc(arcs_[i]);
+  }
+  return comps;
+}
+
 }  // namespace cyclus
@@ -14,6 +14,7 @@ namespace cyclus {
 
 class ExchangeNodeGroup;
 class Arc;
+class FlatExchangeGraph;
 
 /// @class ExchangeNode
 ///
@@ -51,6 +52,10 @@ struct ExchangeNode {
   /// @brief the commodity associated with this exchange node
   std::string commod;
 
+  /// @brief the interned id of the node's commodity (see CommodityTable), or
+  /// -1 if it was not interned
+  int commod_id;
+
   /// @brief the id of the agent associated with this node
   int agent_id;
 
@@ -227,6 +232,26 @@ class ExchangeGraph {
 
   /// clears all matches
   inline void ClearMatches() { matches_.clear(); }
+
+  /// @brief the FlatExchangeGraph of this graph, which is built on demand and
+  /// shared by the solvers and translators of the graph. It is rebuilt after
+  /// groups or arcs are added or ClearFlat is called; holders of a previous
+  /// one keep a valid snapshot.
+  boost::shared_ptr<FlatExchangeGraph> flat() const;
+
+  /// @brief discards the FlatExchangeGraph, which must be called after
+  /// reordering the graph's groups or their nodes
+  inline void ClearFlat() { flat_.reset(); }
+
+  /// @brief splits the graph into its connected components, i.e., sets of
+  /// request and supply groups that are connected to each other by arcs but
+  /// not to any group outside the set. Components share their groups, nodes,
+  /// and arcs with this graph and can be solved independently of each other.
+  /// Groups without any arcs are not part of any component.
+  ///
+  /// @return the components, ordered by the position of their first request
+  /// group in request_groups(). Groups and arcs keep their relative order.
+  std::vector<ExchangeGraph::Ptr> Components() const;
   
   inline const std::vector<RequestGroup::Ptr>& request_groups() const {
     return request_groups_;
@@ -255,21 +280,42 @@ class ExchangeGraph {
   inline const std::vector<Arc>& arcs() const { return arcs_; }
   inline std::vector<Arc>& arcs() { return arcs_; }
 
-  inline const std::map<Arc, int>& arc_ids() const { return arc_ids_; }
-  inline std::map<Arc, int>& arc_ids() { return arc_ids_; }
+  /// @brief an arc's id is its position in arcs(). These maps are built on
+  /// demand; solvers should use a FlatExchangeGraph instead.
+  /// @{
+  inline const std::map<Arc, int>& arc_ids() const {
+    IndexArcs();
+    return arc_ids_;
+  }
+  inline std::map<Arc, int>& arc_ids() {
+    IndexArcs();
+    return arc_ids_;
+  }
+
+  inline const std::map<int, Arc>& arc_by_id() const {
+    IndexArcs();
+    return arc_by_id_;
+  }
+  inline std::map<int, Arc>& arc_by_id() {
+    IndexArcs();
+    return arc_by_id_;
+  }
+  /// @}
 
-  inline const std::map<int, Arc>& arc_by_id() const { return arc_by_id_; }
-  inline std::map<int, Arc>& arc_by_id() { return arc_by_id_; }
-  
  private:
   std::vector<RequestGroup::Ptr> request_groups_;
   std::vector<ExchangeNodeGroup::Ptr> supply_groups_;
   std::map<ExchangeNode::Ptr, std::vector<Arc> > node_arc_map_;
   std::vector<Match> matches_;
+  /// adds all arcs added since the last call to arc_ids_ and arc_by_id_
+  void IndexArcs() const;
+
   std::vector<Arc> arcs_;
-  std::map<Arc, int> arc_ids_;
-  std::map<int, Arc> arc_by_id_;
-  int next_arc_id_;
+  mutable std::map<Arc, int> arc_ids_;
+  mutable std::map<int, Arc> arc_by_id_;
+  /// the number of arcs in arc_ids_ and arc_by_id_
+  mutable int n_indexed_;
+  mutable boost::shared_ptr<FlatExchangeGraph> flat_;
 };
 
 }  // namespace cyclus
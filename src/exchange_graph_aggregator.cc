@@ -0,0 +1,285 @@
+#include "exchange_graph_aggregator.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+namespace cyclus {
+
+namespace {
+
+/// the description of a request group that equivalent groups share
+typedef std::pair<std::vector<double>, std::vector<std::string> > Signature;
+
+/// @return a copy of a node, without arcs, with the given quantity
+ExchangeNode::Ptr CopyNode(const ExchangeNode::Ptr& n, double qty) {
+  ExchangeNode::Ptr c(new ExchangeNode(qty, n->exclusive, n->commod,
+                                       n->agent_id));
+  c->commod_id = n->commod_id;
+  return c;
+}
+
+/// copies the preferences and unit capacities of an arc to another
+void CopyArc(const Arc& from, Arc* to) {
+  ExchangeNode::Ptr u = from.unode();
+  ExchangeNode::Ptr v = from.vnode();
+  to->pref(from.pref());
+  std::map<Arc, double>::const_iterator p = u->prefs.find(from);
+  if (p != u->prefs.end()) {
+    to->unode()->prefs[*to] = p->second;
+  }
+  std::map<Arc, std::vector<double> >::const_iterator c =
+      u->unit_capacities.find(from);
+  if (c != u->unit_capacities.end()) {
+    to->unode()->unit_capacities[*to] = c->second;
+  }
+  c = v->unit_capacities.find(from);
+  if (c != v->unit_capacities.end()) {
+    to->vnode()->unit_capacities[*to] = c->second;
+  }
+}
+
+/// appends a node's unit capacities for an arc to a key
+void AppendCaps(const ExchangeNode::Ptr& n, const Arc& a,
+                std::vector<double>* key) {
+  std::map<Arc, std::vector<double> >::const_iterator it =
+      n->unit_capacities.find(a);
+  if (it == n->unit_capacities.end()) {
+    key->push_back(0);
+    return;
+  }
+  key->push_back(it->second.size());
+  key->insert(key->end(), it->second.begin(), it->second.end());
+}
+
+/// @return the description of an arc from a request node, which identifies
+/// its bid node's supply group by its position
+std::vector<double> ArcKey(const Arc& a,
+                           const std::map<ExchangeNodeGroup*, int>& sids) {
+  ExchangeNode::Ptr u = a.unode();
+  ExchangeNode::Ptr v = a.vnode();
+  std::vector<double> key;
+  key.push_back(sids.at(v->group));
+  key.push_back(v->qty);
+  key.push_back(a.pref());
+  std::map<Arc, double>::const_iterator p = u->prefs.find(a);
+  key.push_back(p != u->prefs.end());
+  key.push_back(p != u->prefs.end() ? p->second : 0);
+  AppendCaps(u, a, &key);
+  AppendCaps(v, a, &key);
+  return key;
+}
+
+/// determines whether a request group may be merged with equivalent groups
+///
+/// @param arcs set to the arcs of each of the group's nodes, in the order of
+/// their descriptions, if the group may be merged
+/// @param sig set to the group's signature if the group may be merged
+bool Mergeable(const ExchangeGraph& g, const RequestGroup::Ptr& r,
+               const std::map<ExchangeNodeGroup*, int>& sids,
+               std::vector<std::vector<Arc> >* arcs, Signature* sig) {
+  if (!r->excl_node_groups().empty()) {
+    return false;
+  }
+
+  const std::map<ExchangeNode::Ptr, std::vector<Arc> >& node_arcs =
+      g.node_arc_map();
+  const std::vector<ExchangeNode::Ptr>& nodes = r->nodes();
+  const std::vector<double>& caps = r->capacities();
+  std::vector<double>& key = sig->first;
+  key.push_back(r->qty());
+  key.push_back(caps.size());
+  key.insert(key.end(), caps.begin(), caps.end());
+  key.push_back(nodes.size());
+  arcs->resize(nodes.size());
+  std::vector<std::pair<std::vector<double>, int> > arc_keys;
+  for (int n = 0; n < nodes.size(); n++) {
+    const ExchangeNode::Ptr& u = nodes[n];
+    if (u->exclusive) {
+      return false;
+    }
+    sig->second.push_back(u->commod);
+    key.push_back(u->qty);
+
+    std::map<ExchangeNode::Ptr, std::vector<Arc> >::const_iterator it =
+        node_arcs.find(u);
+    if (it == node_arcs.end()) {
+      key.push_back(0);
+      continue;
+    }
+    const std::vector<Arc>& uarcs = it->second;
+    arc_keys.clear();
+    for (int i = 0; i < uarcs.size(); i++) {
+      ExchangeNode::Ptr v = uarcs[i].vnode();
+      if (v->exclusive || node_arcs.at(v).size() != 1) {
+        return false;
+      }
+      arc_keys.push_back(std::make_pair(ArcKey(uarcs[i], sids), i));
+    }
+    std::sort(arc_keys.begin(), arc_keys.end());
+    key.push_back(arc_keys.size());
+    for (int i = 0; i < arc_keys.size(); i++) {
+      key.insert(key.end(), arc_keys[i].first.begin(),
+                 arc_keys[i].first.end());
+      (*arcs)[n].push_back(uarcs[arc_keys[i].second]);
+    }
+  }
+  return true;
+}
+
+/// adds the exclusive node groups of a group to its copy
+void CopyExclGroups(
+    const ExchangeNodeGroup::Ptr& from, ExchangeNodeGroup::Ptr to,
+    const std::map<ExchangeNode::Ptr, ExchangeNode::Ptr>& copies) {
+  const std::vector<std::vector<ExchangeNode::Ptr> >& excl =
+      from->excl_node_groups();
+  std::vector<ExchangeNode::Ptr> nodes;
+  for (int e = 0; e < excl.size(); e++) {
+    nodes.clear();
+    for (int i = 0; i < excl[e].size(); i++) {
+      nodes.push_back(copies.at(excl[e][i]));
+    }
+    to->AddExclGroup(nodes);
+  }
+}
+
+}  // namespace
+
+ExchangeGraphAggregator::ExchangeGraphAggregator(ExchangeGraph::Ptr g)
+    : g_(g),
+      reduced_(new ExchangeGraph()),
+      n_merged_(0) {
+  const std::vector<RequestGroup::Ptr>& rgs = g->request_groups();
+  const std::vector<ExchangeNodeGroup::Ptr>& sgs = g->supply_groups();
+  std::map<ExchangeNodeGroup*, int> sids;
+  for (int i = 0; i < sgs.size(); i++) {
+    sids[sgs[i].get()] = i;
+  }
+
+  // classes of equivalent request groups, in the order of their first groups
+  std::vector<std::vector<int> > classes;
+  std::vector<std::vector<std::vector<Arc> > > arcs(rgs.size());
+  std::map<Signature, int> class_ids;
+  for (int i = 0; i < rgs.size(); i++) {
+    Signature sig;
+    if (!Mergeable(*g, rgs[i], sids, &arcs[i], &sig)) {
+      classes.push_back(std::vector<int>(1, i));
+      continue;
+    }
+    std::pair<std::map<Signature, int>::iterator, bool> c =
+        class_ids.insert(std::make_pair(sig, classes.size()));
+    if (c.second) {
+      classes.push_back(std::vector<int>());
+    }
+    classes[c.first->second].push_back(i);
+  }
+
+  // request groups, merging the bid nodes of merged groups
+  std::map<ExchangeNode::Ptr, ExchangeNode::Ptr> copies;
+  std::map<Arc, Arc> merged_arcs;
+  for (int c = 0; c < classes.size(); c++) {
+    const std::vector<int>& members = classes[c];
+    const RequestGroup::Ptr& first = rgs[members[0]];
+    int k = members.size();
+    n_merged_ += k - 1;
+
+    RequestGroup::Ptr rg(new RequestGroup(k * first->qty()));
+    const std::vector<double>& caps = first->capacities();
+    for (int i = 0; i < caps.size(); i++) {
+      rg->AddCapacity(k * caps[i]);
+    }
+    for (int n = 0; n < first->nodes().size(); n++) {
+      const ExchangeNode::Ptr& u = first->nodes()[n];
+      ExchangeNode::Ptr cu = CopyNode(u, k * u->qty);
+      rg->ExchangeNodeGroup::AddExchangeNode(cu);
+      for (int m = 0; m < k; m++) {
+        copies[rgs[members[m]]->nodes()[n]] = cu;
+      }
+      if (k == 1) {
+        continue;
+      }
+
+      const std::vector<Arc>& first_arcs = arcs[members[0]][n];
+      for (int j = 0; j < first_arcs.size(); j++) {
+        ExchangeNode::Ptr cv = CopyNode(first_arcs[j].vnode(), 0);
+        for (int m = 0; m < k; m++) {
+          ExchangeNode::Ptr v = arcs[members[m]][n][j].vnode();
+          cv->qty += v->qty;
+          copies[v] = cv;
+        }
+        Arc ca(cu, cv);
+        CopyArc(first_arcs[j], &ca);
+        for (int m = 0; m < k; m++) {
+          merged_arcs.insert(std::make_pair(arcs[members[m]][n][j], ca));
+        }
+      }
+    }
+    CopyExclGroups(first, rg, copies);
+    reduced_->AddRequestGroup(rg);
+  }
+
+  // supply groups, in which merged bid nodes take the place of the first node
+  // they were merged from
+  for (int i = 0; i < sgs.size(); i++) {
+    const std::vector<ExchangeNode::Ptr>& nodes = sgs[i]->nodes();
+    ExchangeNodeGroup::Ptr sg(new ExchangeNodeGroup());
+    std::set<ExchangeNode::Ptr> merged;
+    for (int n = 0; n < nodes.size(); n++) {
+      std::map<ExchangeNode::Ptr, ExchangeNode::Ptr>::iterator it =
+          copies.find(nodes[n]);
+      if (it == copies.end()) {
+        ExchangeNode::Ptr cv = CopyNode(nodes[n], nodes[n]->qty);
+        copies[nodes[n]] = cv;
+        sg->AddExchangeNode(cv);
+      } else if (merged.insert(it->second).second) {
+        sg->AddExchangeNode(it->second);
+      }
+    }
+    const std::vector<double>& caps = sgs[i]->capacities();
+    for (int c = 0; c < caps.size(); c++) {
+      sg->AddCapacity(caps[c]);
+    }
+    CopyExclGroups(sgs[i], sg, copies);
+    reduced_->AddSupplyGroup(sg);
+  }
+
+  // arcs, of which merged ones take the place of the first arc they were
+  // merged from
+  std::map<Arc, int> merged_ids;
+  const std::vector<Arc>& garcs = g->arcs();
+  for (int i = 0; i < garcs.size(); i++) {
+    const Arc& a = garcs[i];
+    std::map<Arc, Arc>::iterator it = merged_arcs.find(a);
+    if (it == merged_arcs.end()) {
+      Arc ca(copies.at(a.unode()), copies.at(a.vnode()));
+      CopyArc(a, &ca);
+      reduced_->AddArc(ca);
+      members_.push_back(std::vector<Arc>(1, a));
+      continue;
+    }
+
+    std::pair<std::map<Arc, int>::iterator, bool> id =
+        merged_ids.insert(std::make_pair(it->second, members_.size()));
+    if (id.second) {
+      reduced_->AddArc(it->second);
+      members_.push_back(std::vector<Arc>());
+    }
+    members_[id.first->second].push_back(a);
+  }
+}
+
+void ExchangeGraphAggregator::Disaggregate(const std::vector<Match>& matches,
+                                           std::vector<Match>* ret) const {
+  const std::map<Arc, int>& ids = reduced_->arc_ids();
+  for (int i = 0; i < matches.size(); i++) {
+    const std::vector<Arc>& arcs = members_[ids.at(matches[i].first)];
+    double share = matches[i].second / arcs.size();
+    for (int j = 0; j < arcs.size(); j++) {
+      ret->push_back(std::make_pair(arcs[j], share));
+    }
+  }
+}
+
+}  // namespace cyclus
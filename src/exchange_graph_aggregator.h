@@ -0,0 +1,64 @@
+#ifndef CYCLUS_SRC_EXCHANGE_GRAPH_AGGREGATOR_H_
+#define CYCLUS_SRC_EXCHANGE_GRAPH_AGGREGATOR_H_
+
+#include <vector>
+
+#include "exchange_graph.h"
+
+namespace cyclus {
+
+/// @class ExchangeGraphAggregator
+///
+/// @brief Reduces an exchange graph by merging equivalent request groups,
+/// e.g., the identical requests of a fleet of identical reactors, and the bids
+/// for them, and maps solutions of the reduced graph back to the original.
+///
+/// Request groups are equivalent if they have the same requested quantity and
+/// capacities, and their nodes, in order, have the same quantity and commodity
+/// and arcs to bid nodes of the same supply groups with the same quantity,
+/// preference, and unit capacities. Only request groups whose nodes and bid
+/// nodes are all non-exclusive, and whose bid nodes have no other arcs, are
+/// merged, so that exclusive requests and bids keep their all-or-nothing
+/// semantics.
+///
+/// k equivalent request groups are merged into one group with k times their
+/// quantity and capacities, whose nodes have k times the quantity of theirs.
+/// The corresponding bid nodes of each supply group are merged into one node
+/// with their combined quantity. Flow on a merged arc is split evenly among
+/// the arcs it was merged from, which satisfies the capacities of every
+/// original group. Other groups, nodes, and arcs are copied unchanged.
+class ExchangeGraphAggregator {
+ public:
+  /// @brief builds the reduced graph of a graph
+  /// @param g the (unsolved) graph, which is kept alive by the aggregator
+  explicit ExchangeGraphAggregator(ExchangeGraph::Ptr g);
+
+  /// @return the original graph
+  inline ExchangeGraph::Ptr graph() const { return g_; }
+
+  /// @return the reduced graph, whose groups and arcs are in the order of the
+  /// first of the original groups and arcs they were made from
+  inline ExchangeGraph::Ptr reduced() const { return reduced_; }
+
+  /// @return the number of request groups that were merged into others
+  inline int n_merged() const { return n_merged_; }
+
+  /// @brief maps matches of the reduced graph to matches of the original
+  /// graph, in the same order
+  /// @param matches matches of the reduced graph
+  /// @param ret the container to which original matches are added
+  void Disaggregate(const std::vector<Match>& matches,
+                    std::vector<Match>* ret) const;
+
+ private:
+  ExchangeGraph::Ptr g_;
+  ExchangeGraph::Ptr reduced_;
+  int n_merged_;
+
+  /// the original arcs of each arc of the reduced graph, by arc id
+  std::vector<std::vector<Arc> > members_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_EXCHANGE_GRAPH_AGGREGATOR_H_
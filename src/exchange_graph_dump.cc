@@ -0,0 +1,264 @@
+#include "exchange_graph_dump.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "error.h"
+#include "flat_exchange_graph.h"
+
+namespace cyclus {
+
+namespace {
+
+const char kMagic[8] = {'C', 'Y', 'E', 'X', 'G', 'R', 'P', 'H'};
+const int kVersion = 1;
+const int kMaxSize = std::numeric_limits<int>::max();
+
+template <class T>
+void Write(std::ostream& out, const T& x) {
+  out.write(reinterpret_cast<const char*>(&x), sizeof(T));
+}
+
+void WriteDoubles(std::ostream& out, const double* x, int n) {
+  Write<int>(out, n);
+  out.write(reinterpret_cast<const char*>(x), n * sizeof(double));
+}
+
+template <class T>
+T Read(std::istream& in) {
+  T x;
+  in.read(reinterpret_cast<char*>(&x), sizeof(T));
+  if (!in) {
+    throw IOError("truncated exchange graph dump");
+  }
+  return x;
+}
+
+/// reads a size that must be non-negative and at most max
+int ReadSize(std::istream& in, int max) {
+  int n = Read<int>(in);
+  if (n < 0 || n > max) {
+    throw ValueError("corrupt exchange graph dump");
+  }
+  return n;
+}
+
+void ReadDoubles(std::istream& in, std::vector<double>* x) {
+  int n = Read<int>(in);
+  if (n < 0) {
+    throw ValueError("corrupt exchange graph dump");
+  }
+  x->resize(n);
+  if (n > 0) {
+    in.read(reinterpret_cast<char*>(&(*x)[0]), n * sizeof(double));
+    if (!in) {
+      throw IOError("truncated exchange graph dump");
+    }
+  }
+}
+
+}  // namespace
+
+void DumpExchangeGraph(ExchangeGraph* g, std::ostream& out) {
+  boost::shared_ptr<FlatExchangeGraph> flat = g->flat();
+  const FlatExchangeGraph& fg = *flat;
+  out.write(kMagic, sizeof(kMagic));
+  Write<int>(out, kVersion);
+
+  // commodities are written once and referred to by index, interned ones
+  // are found by their id and others by their name
+  std::vector<int> by_id;
+  std::map<std::string, int> by_name;
+  std::vector<int> node_commods(fg.n_nodes());
+  std::vector<const std::string*> commods;
+  for (int n = 0; n < fg.n_nodes(); n++) {
+    const std::string& c = fg.node(n)->commod;
+    int id = fg.commod_id(n);
+    int* index;
+    if (id >= 0) {
+      if (id >= by_id.size()) {
+        by_id.resize(id + 1, -1);
+      }
+      index = &by_id[id];
+    } else {
+      index = &by_name.insert(std::make_pair(c, -1)).first->second;
+    }
+    if (*index < 0) {
+      *index = commods.size();
+      commods.push_back(&c);
+    }
+    node_commods[n] = *index;
+  }
+  Write<int>(out, commods.size());
+  for (int i = 0; i < commods.size(); i++) {
+    Write<int>(out, commods[i]->size());
+    out.write(commods[i]->data(), commods[i]->size());
+  }
+
+  Write<int>(out, fg.n_nodes());
+  for (int n = 0; n < fg.n_nodes(); n++) {
+    Write<double>(out, fg.qty(n));
+    Write<char>(out, fg.exclusive(n));
+    Write<int>(out, fg.agent_id(n));
+    Write<int>(out, node_commods[n]);
+  }
+
+  Write<int>(out, fg.n_groups());
+  Write<int>(out, fg.n_req_groups());
+  for (int grp = 0; grp < fg.n_groups(); grp++) {
+    if (fg.request(grp)) {
+      Write<double>(out, fg.req_qty(grp));
+    }
+    Write<int>(out, fg.node_begin(grp));
+    Write<int>(out, fg.node_end(grp));
+    WriteDoubles(out, fg.capacities().data() + fg.cap_begin(grp),
+                 fg.n_caps(grp));
+    Write<int>(out, fg.excl_end(grp) - fg.excl_begin(grp));
+    for (int e = fg.excl_begin(grp); e < fg.excl_end(grp); e++) {
+      Write<int>(out, fg.n_excl_nodes(e));
+      out.write(reinterpret_cast<const char*>(fg.excl_nodes(e)),
+                fg.n_excl_nodes(e) * sizeof(int));
+    }
+  }
+
+  Write<int>(out, fg.n_arcs());
+  for (int a = 0; a < fg.n_arcs(); a++) {
+    Write<int>(out, fg.unode(a));
+    Write<int>(out, fg.vnode(a));
+    Write<double>(out, fg.pref(a));
+    const ExchangeNode::Ptr& u = fg.node(fg.unode(a));
+    Write<char>(out, u->prefs.count(fg.arc(a)) > 0);
+    Write<double>(out, fg.req_pref(a));
+    WriteDoubles(out, fg.ucaps(a), fg.n_ucaps(a));
+    WriteDoubles(out, fg.vcaps(a), fg.n_vcaps(a));
+  }
+}
+
+ExchangeGraph::Ptr LoadExchangeGraph(std::istream& in) {
+  char magic[sizeof(kMagic)];
+  in.read(magic, sizeof(magic));
+  if (!in || !std::equal(magic, magic + sizeof(magic), kMagic)) {
+    throw ValueError("not an exchange graph dump");
+  }
+  int version = Read<int>(in);
+  if (version != kVersion) {
+    throw ValueError("unsupported exchange graph dump version");
+  }
+
+  int ncommods = ReadSize(in, kMaxSize);
+  std::vector<std::string> commods(ncommods);
+  for (int i = 0; i < ncommods; i++) {
+    int len = Read<int>(in);
+    if (len < 0) {
+      throw ValueError("corrupt exchange graph dump");
+    }
+    commods[i].resize(len);
+    if (len > 0) {
+      in.read(&commods[i][0], len);
+      if (!in) {
+        throw IOError("truncated exchange graph dump");
+      }
+    }
+  }
+
+  int nnodes = ReadSize(in, kMaxSize);
+  std::vector<ExchangeNode::Ptr> nodes(nnodes);
+  for (int n = 0; n < nnodes; n++) {
+    double qty = Read<double>(in);
+    bool exclusive = Read<char>(in);
+    int agent_id = Read<int>(in);
+    int commod = ReadSize(in, ncommods - 1);
+    nodes[n] = ExchangeNode::Ptr(
+        new ExchangeNode(qty, exclusive, commods[commod], agent_id));
+    nodes[n]->commod_id = commod;
+  }
+
+  ExchangeGraph::Ptr g(new ExchangeGraph());
+  int ngroups = ReadSize(in, kMaxSize);
+  int nreq = ReadSize(in, ngroups);
+  std::vector<double> caps;
+  std::vector<ExchangeNode::Ptr> excl;
+  for (int grp = 0; grp < ngroups; grp++) {
+    ExchangeNodeGroup::Ptr eng;
+    RequestGroup::Ptr rg;
+    if (grp < nreq) {
+      rg = RequestGroup::Ptr(new RequestGroup(Read<double>(in)));
+      eng = rg;
+    } else {
+      eng = ExchangeNodeGroup::Ptr(new ExchangeNodeGroup());
+    }
+
+    // exclusive node groups are added as dumped rather than by
+    // RequestGroup::AddExchangeNode
+    int begin = ReadSize(in, nnodes);
+    int end = ReadSize(in, nnodes);
+    for (int n = begin; n < end; n++) {
+      eng->ExchangeNodeGroup::AddExchangeNode(nodes[n]);
+    }
+    ReadDoubles(in, &caps);
+    for (int i = 0; i < caps.size(); i++) {
+      eng->AddCapacity(caps[i]);
+    }
+    int nexcl = ReadSize(in, kMaxSize);
+    for (int e = 0; e < nexcl; e++) {
+      excl.resize(ReadSize(in, nnodes));
+      for (int i = 0; i < excl.size(); i++) {
+        excl[i] = nodes[ReadSize(in, nnodes - 1)];
+      }
+      eng->AddExclGroup(excl);
+    }
+
+    if (rg) {
+      g->AddRequestGroup(rg);
+    } else {
+      g->AddSupplyGroup(eng);
+    }
+  }
+
+  int narcs = ReadSize(in, kMaxSize);
+  for (int i = 0; i < narcs; i++) {
+    ExchangeNode::Ptr u = nodes[ReadSize(in, nnodes - 1)];
+    ExchangeNode::Ptr v = nodes[ReadSize(in, nnodes - 1)];
+    Arc a(u, v);
+    a.pref(Read<double>(in));
+    bool has_req_pref = Read<char>(in);
+    double req_pref = Read<double>(in);
+    if (has_req_pref) {
+      u->prefs[a] = req_pref;
+    }
+    ReadDoubles(in, &caps);
+    if (!caps.empty()) {
+      u->unit_capacities[a] = caps;
+    }
+    ReadDoubles(in, &caps);
+    if (!caps.empty()) {
+      v->unit_capacities[a] = caps;
+    }
+    g->AddArc(a);
+  }
+  return g;
+}
+
+void DumpExchangeGraph(ExchangeGraph* g, const std::string& path) {
+  std::ofstream out(path.c_str(), std::ios::out | std::ios::binary);
+  if (!out) {
+    throw IOError("could not open '" + path + "' for writing");
+  }
+  DumpExchangeGraph(g, out);
+  if (!out) {
+    throw IOError("could not write '" + path + "'");
+  }
+}
+
+ExchangeGraph::Ptr LoadExchangeGraph(const std::string& path) {
+  std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+  if (!in) {
+    throw IOError("could not open '" + path + "' for reading");
+  }
+  return LoadExchangeGraph(in);
+}
+
+}  // namespace cyclus
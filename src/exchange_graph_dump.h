@@ -0,0 +1,47 @@
+#ifndef CYCLUS_SRC_EXCHANGE_GRAPH_DUMP_H_
+#define CYCLUS_SRC_EXCHANGE_GRAPH_DUMP_H_
+
+#include <iostream>
+#include <string>
+
+#include "exchange_graph.h"
+
+namespace cyclus {
+
+/// @brief Writes an unsolved exchange graph to a stream in a compact binary
+/// format, e.g., to replay the exchange through solvers outside of the
+/// simulation (see the cyclus_bench replay benchmark).
+///
+/// A dump holds the graph's request and supply groups (their requested
+/// quantities, capacities, nodes, and exclusive node groups), its nodes
+/// (their quantities, exclusivity, commodities, and agent ids), and its arcs
+/// (their preferences and unit capacities). Matches are not dumped. Numbers
+/// are written in the byte order of the writing machine.
+///
+/// @param g the graph
+/// @param out the stream, which should be opened in binary mode
+void DumpExchangeGraph(ExchangeGraph* g, std::ostream& out);
+
+/// @brief Reads a graph written by DumpExchangeGraph. The graph's groups,
+/// nodes, and arcs are in the same order as in the dumped graph. The nodes'
+/// commodities are interned in the order they first appear in the graph.
+///
+/// @throws ValueError if the stream does not hold a dump of a supported
+/// version
+/// @throws IOError if the dump is truncated
+ExchangeGraph::Ptr LoadExchangeGraph(std::istream& in);
+
+/// @brief Dumps a graph to a file.
+///
+/// @throws IOError if the file cannot be written
+void DumpExchangeGraph(ExchangeGraph* g, const std::string& path);
+
+/// @brief Loads a graph from a file.
+///
+/// @throws IOError if the file cannot be read, see also
+/// LoadExchangeGraph(std::istream&)
+ExchangeGraph::Ptr LoadExchangeGraph(const std::string& path);
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_EXCHANGE_GRAPH_DUMP_H_
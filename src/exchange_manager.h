@@ -2,17 +2,54 @@
 #define CYCLUS_SRC_EXCHANGE_MANAGER_H_
 
 #include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
 
 #include "exchange_graph.h"
+#include "exchange_graph_dump.h"
 #include "exchange_solver.h"
 #include "exchange_translator.h"
 #include "resource_exchange.h"
+#include "stopwatch.h"
 #include "trade_executor.h"
 #include "trader_management.h"
 #include "env.h"
 
 namespace cyclus {
 
+/// @class Market
+///
+/// @brief The exchange of a resource type, run in steps so that the
+/// exchanges of different resource types can be solved concurrently (see
+/// Timer and ExchangeSolver::concurrent_markets).
+class Market {
+ public:
+  virtual ~Market() {}
+
+  /// @brief runs all steps of the exchange
+  virtual void Execute() = 0;
+
+  /// @brief collects the requests, bids, and preference adjustments of
+  /// traders
+  virtual void Collect() = 0;
+
+  /// @brief translates and solves the collected exchange and translates its
+  /// solution into trades. No agent is called other than through the
+  /// capacity converters of its portfolios, so the markets of different
+  /// resource types may be solved concurrently if each has its own solver.
+  virtual void Solve() = 0;
+
+  /// @brief executes the trades of the solved exchange
+  virtual void ExecuteTrades() = 0;
+
+  /// @brief sets the solver of the exchange, or NULL for that of the
+  /// simulation context
+  virtual void solver(ExchangeSolver* s) = 0;
+};
+
 /// @class ExchangeManager
 ///
 /// @brief The ExchangeManager is designed to house all of the internals
@@ -24,50 +61,123 @@ namespace cyclus {
 /// ExchangeManager<ResourceType> manager(ctx);
 /// manager.Execute();
 /// @endcode
+///
+/// If the CYCLUS_DUMP_DRE environment variable names a directory, each
+/// exchange's graph is written to it, before it is solved, as
+/// <directory>/<resource type>_<time>.exg (see DumpExchangeGraph).
 template <class T>
-class ExchangeManager {
+class ExchangeManager : public Market {
  public:
-  ExchangeManager(Context* ctx) : ctx_(ctx), debug_(false) {
+  ExchangeManager(Context* ctx) : ctx_(ctx), debug_(false), solver_(NULL) {
     debug_ = Env::GetEnv("CYCLUS_DEBUG_DRE").size() > 0;
+    dump_dir_ = Env::GetEnv("CYCLUS_DUMP_DRE");
+    timings_ = ctx->sim_info().record_timings;
+  }
+
+  /// the solver of the exchange, by default (or if set to NULL) that of the
+  /// simulation context
+  /// @{
+  virtual void solver(ExchangeSolver* s) { solver_ = s; }
+  inline ExchangeSolver* solver() const {
+    return solver_ != NULL ? solver_ : ctx_->solver();
   }
+  /// @}
 
   /// @brief execute the full resource sequence
-  void Execute() {
+  virtual void Execute() {
+    Collect();
+    Solve();
+    ExecuteTrades();
+  }
+
+  virtual void Collect() {
+    if (timings_) {
+      sw_.Start();
+    }
+    Clear_();
+
     // collect resource exchange information
-    ResourceExchange<T> exchng(ctx_);
-    exchng.AddAllRequests();
-    exchng.AddAllBids();
-    exchng.AdjustAll();
+    exchng_ = boost::shared_ptr<ResourceExchange<T> >(
+        new ResourceExchange<T>(ctx_));
+    exchng_->AddAllRequests();
+    exchng_->AddAllBids();
+    exchng_->AdjustAll();
     CLOG(LEV_DEBUG1) << "done with info gathering";
-    
+    RecordTiming("Collect");
+
     if (debug_)
-      RecordDebugInfo(exchng.ex_ctx());
+      RecordDebugInfo(exchng_->ex_ctx());
+  }
 
-    if (exchng.Empty())
+  virtual void Solve() {
+    if (exchng_ == NULL || exchng_->Empty())
       return; // empty exchange, move on
+    if (timings_) {
+      sw_.Start();
+    }
 
     // translate graph
-    ExchangeTranslator<T> xlator(&exchng.ex_ctx());
+    xlator_ = boost::shared_ptr<ExchangeTranslator<T> >(
+        new ExchangeTranslator<T>(&exchng_->ex_ctx()));
+    xlator_->aggregate(solver()->aggregate());
     CLOG(LEV_DEBUG1) << "translating graph...";
-    ExchangeGraph::Ptr graph = xlator.Translate();
+    ExchangeGraph::Ptr graph = xlator_->Translate();
     CLOG(LEV_DEBUG1) << "graph translated!";
+    RecordTiming("Translate");
+    if (!dump_dir_.empty())
+      DumpGraph(graph.get());
 
     // solve graph
     CLOG(LEV_DEBUG1) << "solving graph...";
-    ctx_->solver()->Solve(graph.get());
+    solver()->Solve(graph.get());
     CLOG(LEV_DEBUG1) << "graph solved!";
+    RecordTiming("Solve");
 
     // get trades
-    std::vector< Trade<T> > trades;
-    xlator.BackTranslateSolution(graph->matches(), trades);
+    xlator_->BackTranslateSolution(graph->matches(), trades_);
     CLOG(LEV_DEBUG1) << "trades translated!";
+    RecordTiming("BackTranslate");
+  }
+
+  virtual void ExecuteTrades() {
+    if (xlator_ == NULL) {
+      Clear_();
+      return;
+    }
+    if (timings_) {
+      sw_.Start();
+    }
 
     // execute trades!
-    TradeExecutor<T> exec(trades);
+    TradeExecutor<T> exec(trades_);
     exec.ExecuteTrades(ctx_);
+    RecordTiming("Execute");
+    Clear_();
   }
 
  private:
+  /// records the time since the last exchange step in the PhaseTimings table
+  /// as e.g. "ResEx.Material.Solve", if timings are enabled.
+  void RecordTiming(const char* step) {
+    if (!timings_) {
+      return;
+    }
+    ctx_->NewDatum("PhaseTimings")
+        ->AddVal("Time", ctx_->time())
+        ->AddVal("Phase", "ResEx." + T::kType + "." + step)
+        ->AddVal("WallTime", sw_.wall())
+        ->AddVal("CpuTime", sw_.cpu())
+        ->Record();
+    sw_.Start();
+  }
+
+  /// writes the graph to the dump directory
+  void DumpGraph(ExchangeGraph* graph) {
+    std::stringstream ss;
+    ss << dump_dir_ << "/" << T::kType << "_" << ctx_->time() << ".exg";
+    DumpExchangeGraph(graph, ss.str());
+  }
+
   void RecordDebugInfo(ExchangeContext<T>& exctx) {
     typename std::vector<typename RequestPortfolio<T>::Ptr>::iterator it;
     for (it = exctx.requests.begin(); it != exctx.requests.end(); ++it) {
@@ -98,7 +208,7 @@ class ExchangeManager {
       for (it4 = bids.begin(); it4 != bids.end(); ++it4) {
         Bid<T>* b = *it4;
         Request<T>* r = b->request();
-        double pref = exctx.trader_prefs[r->requester()][r][b];
+        double pref = exctx.prefs.pref(b);
         std::stringstream ss;
         ss << ctx_->time() << "_" << b->request();
         ctx_->NewDatum("DebugBids")
@@ -112,8 +222,24 @@ class ExchangeManager {
     }
   }
 
+  /// releases the exchange of the last step
+  void Clear_() {
+    trades_.clear();
+    xlator_.reset();
+    exchng_.reset();
+  }
+
   bool debug_;
+  std::string dump_dir_;
+  bool timings_;
+  Stopwatch sw_;
   Context* ctx_;
+  ExchangeSolver* solver_;
+
+  /// the exchange between its steps
+  boost::shared_ptr<ResourceExchange<T> > exchng_;
+  boost::shared_ptr<ExchangeTranslator<T> > xlator_;
+  std::vector< Trade<T> > trades_;
 };
 
 }  // namespace cyclus
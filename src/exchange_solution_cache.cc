@@ -0,0 +1,62 @@
+#include "exchange_solution_cache.h"
+
+#include <sstream>
+
+#include "exchange_graph_dump.h"
+
+namespace cyclus {
+
+std::string ExchangeSolutionCache::Key(ExchangeGraph* comp) {
+  std::stringstream ss(std::ios::out | std::ios::binary);
+  DumpExchangeGraph(comp, ss);
+  return ss.str();
+}
+
+void ExchangeSolutionCache::Begin(int gen) {
+  if (gen == gen_) {
+    return;
+  }
+  gen_ = gen;
+  std::map<std::string, Solution>::iterator it = solns_.begin();
+  while (it != solns_.end()) {
+    if (it->second.gen < gen - 1) {
+      solns_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool ExchangeSolutionCache::Reuse(const std::string& key, ExchangeGraph* comp,
+                                  double* obj) {
+  std::map<std::string, Solution>::iterator it = solns_.find(key);
+  if (it == solns_.end()) {
+    return false;
+  }
+  Solution& s = it->second;
+  const std::vector<Arc>& arcs = comp->arcs();
+  for (int i = 0; i < s.flows.size(); ++i) {
+    comp->AddMatch(arcs[s.flows[i].first], s.flows[i].second);
+  }
+  s.gen = gen_;
+  *obj = s.obj;
+  ++n_reused_;
+  return true;
+}
+
+void ExchangeSolutionCache::Add(const std::string& key, ExchangeGraph* comp,
+                                double obj) {
+  Solution& s = solns_[key];
+  s.flows.clear();
+  const std::map<Arc, int>& ids = comp->arc_ids();
+  const std::vector<Match>& matches = comp->matches();
+  for (int i = 0; i < matches.size(); ++i) {
+    s.flows.push_back(std::make_pair(ids.at(matches[i].first),
+                                     matches[i].second));
+  }
+  s.obj = obj;
+  s.gen = gen_;
+  ++n_solved_;
+}
+
+}  // namespace cyclus
@@ -0,0 +1,76 @@
+#ifndef CYCLUS_SRC_EXCHANGE_SOLUTION_CACHE_H_
+#define CYCLUS_SRC_EXCHANGE_SOLUTION_CACHE_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "exchange_graph.h"
+
+namespace cyclus {
+
+/// @class ExchangeSolutionCache
+///
+/// @brief Keeps the solutions of the connected components of solved exchange
+/// graphs, so that the components of later graphs that did not change, e.g.,
+/// those of the portfolios that are the same as last time step, are not
+/// solved again (see ExchangeSolver::incremental).
+///
+/// Components are identified by their dump (see DumpExchangeGraph), i.e., by
+/// their groups, nodes, and arcs, in order, with their quantities,
+/// capacities, commodities, agent ids, and preferences. A solution is thus
+/// only reused for a component that a deterministic solver would solve the
+/// same way. Solutions are kept until they go unused for a whole generation,
+/// e.g., a time step.
+class ExchangeSolutionCache {
+ public:
+  ExchangeSolutionCache() : gen_(0), n_reused_(0), n_solved_(0) {}
+
+  /// @return the key of a component
+  static std::string Key(ExchangeGraph* comp);
+
+  /// @brief begins a generation, dropping the solutions that were not used
+  /// in it or the previous one
+  /// @param gen the generation, which should not decrease
+  void Begin(int gen);
+
+  /// @brief adds the kept solution of a component to the component's matches
+  /// @param key the component's key
+  /// @param comp the component
+  /// @param obj set to the solution's objective value, if it was kept
+  /// @return whether a solution was kept for the key
+  bool Reuse(const std::string& key, ExchangeGraph* comp, double* obj);
+
+  /// @brief keeps the solution of a solved component
+  /// @param key the component's key
+  /// @param comp the component, with its matches
+  /// @param obj the solution's objective value
+  void Add(const std::string& key, ExchangeGraph* comp, double obj);
+
+  /// @return the number of kept solutions
+  inline int size() const { return solns_.size(); }
+
+  /// @return the number of components whose solution was reused or added
+  /// @{
+  inline int n_reused() const { return n_reused_; }
+  inline int n_solved() const { return n_solved_; }
+  /// @}
+
+ private:
+  /// a solution: the flow on each matched arc, by arc id in its component
+  struct Solution {
+    std::vector<std::pair<int, double> > flows;
+    double obj;
+    int gen;
+  };
+
+  std::map<std::string, Solution> solns_;
+  int gen_;
+  int n_reused_;
+  int n_solved_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_EXCHANGE_SOLUTION_CACHE_H_
@@ -1,10 +1,15 @@
 #include "exchange_solver.h"
 
+#include <algorithm>
+#include <functional>
 #include <vector>
 #include <map>
+#include <string>
 
 #include "context.h"
 #include "exchange_graph.h"
+#include "recorder.h"
+#include "thread_pool.h"
 
 namespace cyclus {
 
@@ -13,6 +18,18 @@ double ExchangeSolver::Cost(const Arc& a, bool exclusive_orders) {
       a.excl_val() / a.pref() : 1.0 / a.pref();  
 }
 
+ExchangeSolver* ExchangeSolver::CloneWithOptions() const {
+  ExchangeSolver* s = Clone();
+  if (s != NULL) {
+    s->sim_ctx(sim_ctx_);
+    s->decompose(decompose_);
+    s->aggregate(aggregate_);
+    s->incremental(incremental_);
+    s->concurrent_markets(concurrent_markets_);
+  }
+  return s;
+}
+
 double ExchangeSolver::PseudoCost() {
   return PseudoCost(1e-1);
 }
@@ -96,4 +113,147 @@ double ExchangeSolver::PseudoCostByPref(double cost_factor) {
   return max_cost * (1 + cost_factor);
 }
 
+namespace {
+
+/// orders matches by the position of their request group in a graph
+struct MatchOrder {
+  explicit MatchOrder(const std::map<const ExchangeNodeGroup*, int>* index)
+      : index(index) {}
+
+  bool operator()(const Match& lhs, const Match& rhs) const {
+    return index->at(lhs.first.unode()->group) <
+        index->at(rhs.first.unode()->group);
+  }
+
+  const std::map<const ExchangeNodeGroup*, int>* index;
+};
+
+}  // namespace
+
+void ExchangeSolver::SolveComponent_(std::vector<ExchangeSolver*>* solvers,
+                                     std::vector<ExchangeGraph::Ptr>* comps,
+                                     std::vector<double>* objs,
+                                     std::vector<DatumList>* bufs, int i) {
+  // data recorded by the solvers is deferred so that it is recorded in the
+  // order of the components
+  Recorder* rec = sim_ctx_->rec_;
+  rec->BeginDeferred(&(*bufs)[i]);
+  try {
+    (*objs)[i] = (*solvers)[i]->Solve((*comps)[i].get());
+  } catch (...) {
+    rec->EndDeferred();
+    throw;
+  }
+  rec->EndDeferred();
+}
+
+double ExchangeSolver::SolveComponents() {
+  PrepareGraph();
+  std::vector<ExchangeGraph::Ptr> comps = graph_->Components();
+  if (comps.size() < 2 && !incremental_) {
+    return SolveGraph();
+  }
+
+  // components whose kept solutions are reused are not solved again
+  int n = comps.size();
+  std::vector<double> objs(n, 0);
+  std::vector<std::string> keys;
+  std::vector<int> unsolved;
+  if (incremental_) {
+    ++n_solves_;
+    cache_.Begin(sim_ctx_ != NULL ? sim_ctx_->time() : n_solves_);
+    keys.resize(n);
+    for (int i = 0; i < n; ++i) {
+      keys[i] = ExchangeSolutionCache::Key(comps[i].get());
+      if (!cache_.Reuse(keys[i], comps[i].get(), &objs[i])) {
+        unsolved.push_back(i);
+      }
+    }
+  } else {
+    for (int i = 0; i < n; ++i) {
+      unsolved.push_back(i);
+    }
+  }
+
+  ExchangeGraph* graph = graph_;
+  int m = unsolved.size();
+  std::vector<ExchangeGraph::Ptr> todo(m);
+  for (int i = 0; i < m; ++i) {
+    todo[i] = comps[unsolved[i]];
+  }
+  std::vector<double> todo_objs(m, 0);
+  ThreadPool* pool = sim_ctx_ != NULL ? sim_ctx_->thread_pool() : NULL;
+  ExchangeSolver* clone = pool != NULL && m > 1 ? Clone() : NULL;
+  if (clone == NULL) {
+    component_ = true;
+    try {
+      for (int i = 0; i < m; ++i) {
+        graph_ = todo[i].get();
+        todo_objs[i] = SolveGraph();
+      }
+    } catch (...) {
+      graph_ = graph;
+      component_ = false;
+      throw;
+    }
+    graph_ = graph;
+    component_ = false;
+  } else {
+    std::vector<ExchangeSolver*> solvers(m, NULL);
+    solvers[0] = clone;
+    for (int i = 1; i < m; ++i) {
+      solvers[i] = Clone();
+    }
+    for (int i = 0; i < m; ++i) {
+      solvers[i]->sim_ctx(sim_ctx_);
+    }
+    std::vector<DatumList> bufs(m);
+    try {
+      pool->ParallelFor(m, std::bind(&ExchangeSolver::SolveComponent_, this,
+                                     &solvers, &todo, &todo_objs, &bufs,
+                                     std::placeholders::_1));
+    } catch (...) {
+      for (int i = 0; i < m; ++i) {
+        delete solvers[i];
+        for (int j = 0; j < bufs[i].size(); ++j) {
+          delete bufs[i][j];
+        }
+      }
+      throw;
+    }
+    for (int i = 0; i < m; ++i) {
+      delete solvers[i];
+      sim_ctx_->rec_->CommitDeferred(&bufs[i]);
+    }
+  }
+  // solving the components may have reordered the nodes of the groups they
+  // share with the graph
+  graph_->ClearFlat();
+  for (int i = 0; i < m; ++i) {
+    objs[unsolved[i]] = todo_objs[i];
+    if (incremental_) {
+      cache_.Add(keys[unsolved[i]], todo[i].get(), todo_objs[i]);
+    }
+  }
+
+  std::vector<Match> matches;
+  double obj = 0;
+  for (int i = 0; i < n; ++i) {
+    matches.insert(matches.end(), comps[i]->matches().begin(),
+                   comps[i]->matches().end());
+    obj += objs[i];
+  }
+
+  std::map<const ExchangeNodeGroup*, int> index;
+  const std::vector<RequestGroup::Ptr>& groups = graph_->request_groups();
+  for (int i = 0; i < groups.size(); ++i) {
+    index[groups[i].get()] = i;
+  }
+  std::stable_sort(matches.begin(), matches.end(), MatchOrder(&index));
+  for (int i = 0; i < matches.size(); ++i) {
+    graph_->AddMatch(matches[i].first, matches[i].second);
+  }
+  return obj;
+}
+
 } // namespace cyclus
@@ -2,6 +2,11 @@
 #define CYCLUS_SRC_EXCHANGE_SOLVER_H_
 
 #include <cstddef>
+#include <vector>
+
+#include "exchange_graph.h"
+#include "exchange_solution_cache.h"
+#include "recorder.h"
 
 namespace cyclus {
 
@@ -23,7 +28,13 @@ class ExchangeSolver {
   explicit ExchangeSolver(bool exclusive_orders = kDefaultExclusive)
     : exclusive_orders_(exclusive_orders),
       sim_ctx_(NULL),
-      verbose_(false) {}
+      verbose_(false),
+      decompose_(false),
+      aggregate_(false),
+      incremental_(false),
+      concurrent_markets_(false),
+      component_(false),
+      n_solves_(0) {}
   virtual ~ExchangeSolver() {}
 
   /// simulation context get/set
@@ -37,14 +48,65 @@ class ExchangeSolver {
   inline void graph(ExchangeGraph* graph) { graph_ = graph; }
   inline ExchangeGraph* graph() const { return graph_; }
 
+  /// whether graphs are solved one connected component at a time (see
+  /// ExchangeGraph::Components), default false
+  /// @{
+  inline void decompose(bool d) { decompose_ = d; }
+  inline bool decompose() const { return decompose_; }
+  /// @}
+
+  /// whether exchanges merge equivalent request portfolios and their bids
+  /// before their graphs are solved (see ExchangeTranslator::aggregate),
+  /// default false
+  /// @{
+  inline void aggregate(bool a) { aggregate_ = a; }
+  inline bool aggregate() const { return aggregate_; }
+  /// @}
+
+  /// whether the solutions of graph components are kept and reused for
+  /// identical components of the graphs solved later, e.g., the unchanged
+  /// portfolios of the next time step (see ExchangeSolutionCache). Graphs are
+  /// then solved one connected component at a time, default false
+  /// @{
+  inline void incremental(bool i) { incremental_ = i; }
+  inline bool incremental() const { return incremental_; }
+  /// @}
+
+  /// whether the exchanges of different resource types are solved
+  /// concurrently if the simulation uses a thread pool and the solver can be
+  /// cloned (see Timer and Market), default false
+  ///
+  /// @warning this changes the order of the exchange: the requests and bids
+  /// of all resource types are collected before the trades of any are
+  /// executed, so, unlike in a serial run, the product portfolios of a
+  /// trader cannot depend on the material trades of the same time step and
+  /// the output may differ from that of a serial run
+  /// @{
+  inline void concurrent_markets(bool c) { concurrent_markets_ = c; }
+  inline bool concurrent_markets() const { return concurrent_markets_; }
+  /// @}
+
+  /// @return the kept solutions of incremental solves
+  inline const ExchangeSolutionCache& solution_cache() const { return cache_; }
+
   /// @brief interface for solving a given exchange graph
   /// @param a pointer to the graph to be solved
   double Solve(ExchangeGraph* graph = NULL) {
     if (graph != NULL)
       graph_ = graph;
-    return this->SolveGraph();
+    return decompose_ || incremental_ ? SolveComponents() : this->SolveGraph();
   }
 
+  /// @brief creates a new solver configured identically to this one, used to
+  /// solve graph components concurrently. Solvers returning NULL (the
+  /// default) solve their components serially.
+  virtual ExchangeSolver* Clone() const { return NULL; }
+
+  /// @brief creates a clone (see Clone) that also has this solver's
+  /// simulation context and options, e.g., to solve another market
+  /// concurrently. Returns NULL if the solver can not be cloned.
+  ExchangeSolver* CloneWithOptions() const;
+
   /// @brief Calculates the ratio of the maximum objective coefficient to
   /// minimum unit capacity plus an added cost. This is guaranteed to be larger
   /// than any other arc cost measure and can be used as a cost for unmet
@@ -65,10 +127,48 @@ class ExchangeSolver {
   /// @brief Worker function for solving a graph. This must be implemented by
   /// any solver.
   virtual double SolveGraph() = 0;
+
+  /// @brief called with the whole graph before it is split into components,
+  /// e.g., to put it into an order that the solution of each component
+  /// should follow
+  virtual void PrepareGraph() {}
+
+  /// @return whether SolveGraph is solving one of the components of a
+  /// decomposed graph (see decompose), rather than a whole graph
+  inline bool component() const { return component_; }
+
   ExchangeGraph* graph_;
   bool exclusive_orders_;
   bool verbose_;
   Context* sim_ctx_;
+
+ private:
+  /// @brief solves each connected component of the graph, concurrently if the
+  /// simulation uses a thread pool and the solver can be cloned. Matches are
+  /// added to the graph ordered by the position of their request group in the
+  /// graph, regardless of the order in which components finish. Incremental
+  /// solvers reuse the kept solutions of unchanged components.
+  ///
+  /// @return the sum of the components' objective values
+  double SolveComponents();
+
+  /// solves the i'th component with the i'th solver, deferring the data it
+  /// records into the i'th buffer
+  void SolveComponent_(std::vector<ExchangeSolver*>* solvers,
+                       std::vector<ExchangeGraph::Ptr>* comps,
+                       std::vector<double>* objs,
+                       std::vector<DatumList>* bufs, int i);
+
+  bool decompose_;
+  bool aggregate_;
+  bool incremental_;
+  bool concurrent_markets_;
+  bool component_;
+
+  /// the solutions kept by incremental solves, whose generation is the
+  /// simulation time or, without a simulation, the number of solves
+  ExchangeSolutionCache cache_;
+  int n_solves_;
 };
 
 }  // namespace cyclus
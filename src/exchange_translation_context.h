@@ -3,7 +3,11 @@
 
 #include <map>
 
+#include <boost/shared_ptr.hpp>
+
+#include "arena.h"
 #include "bid.h"
+#include "conversion_cache.h"
 #include "exchange_graph.h"
 #include "request.h"
 
@@ -17,10 +21,21 @@ namespace cyclus {
 template <class T>
 struct ExchangeTranslationContext {
  public:
+  ExchangeTranslationContext()
+      : arena(new Arena()),
+        conversions(new ConversionCache()) {}
+
   std::map<Request<T>*, ExchangeNode::Ptr> request_to_node;
   std::map<ExchangeNode::Ptr, Request<T>*> node_to_request;
   std::map<Bid<T>*, ExchangeNode::Ptr> bid_to_node;
   std::map<ExchangeNode::Ptr, Bid<T>*> node_to_bid;
+
+  /// the memory of translated nodes (see NewNode), which is freed once the
+  /// context and all of the nodes are destroyed
+  boost::shared_ptr<Arena> arena;
+
+  /// the conversions of offers by pure converters (see TranslateCapacities)
+  boost::shared_ptr<ConversionCache> conversions;
 };
 
 }  // namespace cyclus
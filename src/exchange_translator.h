@@ -2,13 +2,19 @@
 #define CYCLUS_SRC_EXCHANGE_TRANSLATOR_H_
 
 #include <sstream>
+#include <string>
 
+#include <boost/make_shared.hpp>
+
+#include "arena.h"
 #include "bid.h"
 #include "bid_portfolio.h"
 #include "error.h"
 #include "exchange_graph.h"
+#include "exchange_graph_aggregator.h"
 #include "exchange_translation_context.h"
 #include "logger.h"
+#include "material.h"
 #include "request.h"
 #include "request_portfolio.h"
 #include "trade.h"
@@ -29,17 +35,29 @@ class Trader;
 /// ExchangeGraph. Accordingly, the solution to the ExchangeGraph, i.e., it's
 /// Matches, can be back-translated to the original Requests and Bids via a
 /// BackTranslateSolution() method.
+///
+/// If aggregation is enabled, Translate() returns the graph reduced by merging
+/// equivalent request portfolios and their bids (see ExchangeGraphAggregator),
+/// and BackTranslateSolution() splits the matches of merged arcs back into
+/// per-request trades.
 template <class T>
 class ExchangeTranslator {
  public:
   /// @brief default constructor
   ///
   /// @param ex_ctx the exchance context
-  ExchangeTranslator(ExchangeContext<T>* ex_ctx) {
+  ExchangeTranslator(ExchangeContext<T>* ex_ctx) : aggregate_(false) {
     ex_ctx_ = ex_ctx;
   }
 
-  /// @brief translate the ExchangeContext into an ExchangeGraph
+  /// whether translated graphs are aggregated, default false
+  /// @{
+  inline void aggregate(bool a) { aggregate_ = a; }
+  inline bool aggregate() const { return aggregate_; }
+  /// @}
+
+  /// @brief translate the ExchangeContext into an ExchangeGraph, which is
+  /// aggregated if aggregation is enabled
   ExchangeGraph::Ptr Translate() {
     ExchangeGraph::Ptr graph(new ExchangeGraph());
 
@@ -73,14 +91,19 @@ class ExchangeTranslator {
       }
     }
 
-    return graph;
+    if (!aggregate_) {
+      return graph;
+    }
+    aggregator_.reset(new ExchangeGraphAggregator(graph));
+    CLOG(LEV_DEBUG1) << "Merged " << aggregator_->n_merged() << " of "
+                     << graph->request_groups().size() << " request groups.";
+    return aggregator_->reduced();
   }
 
   /// @brief adds a bid-request arc to a graph, if the preference for the arc is
   /// non-negative
   void AddArc(Request<T>* req, Bid<T>* bid, ExchangeGraph::Ptr graph) {
-    double pref =
-        ex_ctx_->trader_prefs.at(req->requester())[req][bid];
+    double pref = ex_ctx_->prefs.pref(bid);
     // TODO: make the following check `pref <=0` and remove the `else if` block
     // before release 1.5
     if (pref < 0) {
@@ -106,14 +129,16 @@ class ExchangeTranslator {
     graph->AddArc(a);
   }
   
-  /// @brief Provide a vector of Trades given a vector of Matches
+  /// @brief Provide a vector of Trades given a vector of Matches of the
+  /// translated graph
   void BackTranslateSolution(const std::vector<Match>& matches,
                              std::vector< Trade<T> >& ret) {
-    std::vector<Match>::const_iterator m_it;
-    CLOG(LEV_DEBUG1) << "Back traslating " << matches.size()
-                     << " trade matches.";
-    for (m_it = matches.begin(); m_it != matches.end(); ++m_it) {
-      ret.push_back(BackTranslateMatch(xlation_ctx_, *m_it));
+    if (aggregator_) {
+      std::vector<Match> disaggregated;
+      aggregator_->Disaggregate(matches, &disaggregated);
+      BackTranslateMatches_(disaggregated, ret);
+    } else {
+      BackTranslateMatches_(matches, ret);
     }
   }
 
@@ -124,8 +149,20 @@ class ExchangeTranslator {
   ExchangeTranslationContext<T>& translation_ctx() { return xlation_ctx_; }
 
  private:
+  void BackTranslateMatches_(const std::vector<Match>& matches,
+                             std::vector< Trade<T> >& ret) {
+    std::vector<Match>::const_iterator m_it;
+    CLOG(LEV_DEBUG1) << "Back traslating " << matches.size()
+                     << " trade matches.";
+    for (m_it = matches.begin(); m_it != matches.end(); ++m_it) {
+      ret.push_back(BackTranslateMatch(xlation_ctx_, *m_it));
+    }
+  }
+
   ExchangeContext<T>* ex_ctx_;
   ExchangeTranslationContext<T> xlation_ctx_;
+  bool aggregate_;
+  boost::shared_ptr<ExchangeGraphAggregator> aggregator_;
 };
 
 /// @brief Adds a request-node mapping
@@ -144,6 +181,16 @@ inline void AddBid(ExchangeTranslationContext<T>& translation_ctx,
   translation_ctx.node_to_bid[n] = b;
 }
 
+/// @return a node allocated in the arena of a translation context
+template <class T>
+inline ExchangeNode::Ptr NewNode(ExchangeTranslationContext<T>& translation_ctx,
+                                 double qty, bool exclusive,
+                                 const std::string& commod, int agent_id) {
+  return boost::allocate_shared<ExchangeNode>(
+      ArenaAllocator<ExchangeNode>(translation_ctx.arena), qty, exclusive,
+      commod, agent_id);
+}
+
 /// @brief translates a request portfolio by adding request nodes and
 /// accounting for capacities. Request unit capcities must be added when arcs
 /// are known
@@ -159,11 +206,12 @@ RequestGroup::Ptr TranslateRequestPortfolio(
        r_it != rp->requests().end();
        ++r_it) {
     Request<T>* r = *r_it;
-    ExchangeNode::Ptr n(
-        new ExchangeNode(r->target()->quantity(),
-                         r->exclusive(),
-                         r->commodity(),
-                         r->requester()->manager()->id()));
+    ExchangeNode::Ptr n = NewNode(translation_ctx,
+                                  r->target()->quantity(),
+                                  r->exclusive(),
+                                  r->commodity(),
+                                  r->requester()->manager()->id());
+    n->commod_id = r->commod_id();
     rs->AddExchangeNode(n);
 
     AddRequest(translation_ctx, *r_it, n);
@@ -196,11 +244,12 @@ ExchangeNodeGroup::Ptr TranslateBidPortfolio(
        b_it != bp->bids().end();
        ++b_it) {
     Bid<T>* b = *b_it;
-    ExchangeNode::Ptr n(
-        new ExchangeNode(b->offer()->quantity(),
-                         b->exclusive(),
-                         b->request()->commodity(),
-                         b->bidder()->manager()->id()));
+    ExchangeNode::Ptr n = NewNode(translation_ctx,
+                                  b->offer()->quantity(),
+                                  b->exclusive(),
+                                  b->request()->commodity(),
+                                  b->bidder()->manager()->id());
+    n->commod_id = b->request()->commod_id();
     bs->AddExchangeNode(n);
     AddBid(translation_ctx, *b_it, n);
     if (b->exclusive()) {
@@ -273,6 +322,44 @@ Trade<T> BackTranslateMatch(const ExchangeTranslationContext<T>&
   return t;
 }
 
+/// @return the id of the composition of an offer, or -1 if its resource type
+/// has none
+template<typename T>
+inline int CompositionId(typename T::Ptr offer) {
+  return -1;
+}
+
+template<>
+inline int CompositionId<Material>(Material::Ptr offer) {
+  return offer->comp()->id();
+}
+
+/// @return the conversion of an offer by a constraint's converter, which is
+/// kept in the translation context if the converter is pure (see
+/// Converter::pure), so that repeated offers of the same resource are
+/// converted once
+template<typename T>
+double ConvertOffer(
+    typename T::Ptr offer,
+    const CapacityConstraint<T>& c,
+    const Arc& a,
+    const ExchangeTranslationContext<T>& ctx) {
+  const Converter<T>* conv = c.converter().get();
+  if (!conv->pure()) {
+    return conv->convert(offer, &a, &ctx);
+  }
+
+  int comp = CompositionId<T>(offer);
+  double qty = offer->quantity();
+  double val;
+  if (ctx.conversions->Find(conv, offer.get(), comp, qty, &val)) {
+    return val;
+  }
+  val = conv->convert(offer, &a, &ctx);
+  ctx.conversions->Add(conv, offer.get(), comp, qty, val);
+  return val;
+}
+
 /// @brief updates a node's unit capacities given, a target resource and
 /// constraints
 template<typename T>
@@ -284,10 +371,9 @@ void TranslateCapacities(
     const ExchangeTranslationContext<T>& ctx) {
   typename std::set< CapacityConstraint<T> >::const_iterator it;
   for (it = constr.begin(); it != constr.end(); ++it) {
-    CLOG(cyclus::LEV_DEBUG1) << "Additing unit capacity: "
-                             << it->convert(offer, &a, &ctx) / offer->quantity();
-    n->unit_capacities[a].push_back(it->convert(offer, &a, &ctx) /
-                                    offer->quantity());
+    double ucap = ConvertOffer(offer, *it, a, ctx) / offer->quantity();
+    CLOG(cyclus::LEV_DEBUG1) << "Additing unit capacity: " << ucap;
+    n->unit_capacities[a].push_back(ucap);
   }
 }
 
@@ -0,0 +1,138 @@
+#include "flat_exchange_graph.h"
+
+namespace cyclus {
+
+FlatExchangeGraph::FlatExchangeGraph(ExchangeGraph* g) : g_(g) {
+  std::vector<RequestGroup::Ptr>& rgs = g->request_groups();
+  std::vector<ExchangeNodeGroup::Ptr>& sgs = g->supply_groups();
+  nreq_ = rgs.size();
+
+  grp_node_begin_.push_back(0);
+  grp_cap_begin_.push_back(0);
+  for (int i = 0; i < rgs.size(); i++) {
+    AddGroup(rgs[i].get(), i);
+    req_qty_.push_back(rgs[i]->qty());
+  }
+  for (int i = 0; i < sgs.size(); i++) {
+    AddGroup(sgs[i].get(), nreq_ + i);
+  }
+
+  const std::vector<Arc>& arcs = g->arcs();
+  int narcs = arcs.size();
+  unode_.reserve(narcs);
+  vnode_.reserve(narcs);
+  arc_excl_.reserve(narcs);
+  excl_val_.reserve(narcs);
+  pref_.reserve(narcs);
+  req_pref_.reserve(narcs);
+  ucap_begin_.reserve(narcs + 1);
+  vcap_begin_.reserve(narcs + 1);
+  ucap_begin_.push_back(0);
+  vcap_begin_.push_back(0);
+  for (int i = 0; i < narcs; i++) {
+    const Arc& a = arcs[i];
+    ExchangeNode::Ptr u = a.unode();
+    ExchangeNode::Ptr v = a.vnode();
+    unode_.push_back(AddNode(u));
+    vnode_.push_back(AddNode(v));
+    arc_excl_.push_back(a.exclusive());
+    excl_val_.push_back(a.excl_val());
+    pref_.push_back(a.pref());
+
+    std::map<Arc, double>::const_iterator it = u->prefs.find(a);
+    req_pref_.push_back(it != u->prefs.end() ? it->second : 0);
+
+    AddUnitCaps(u, a, &ucaps_);
+    ucap_begin_.push_back(ucaps_.size());
+    AddUnitCaps(v, a, &vcaps_);
+    vcap_begin_.push_back(vcaps_.size());
+  }
+
+  grp_excl_begin_.push_back(0);
+  excl_node_begin_.push_back(0);
+  for (int i = 0; i < rgs.size(); i++) {
+    AddExclGroups(rgs[i].get());
+  }
+  for (int i = 0; i < sgs.size(); i++) {
+    AddExclGroups(sgs[i].get());
+  }
+
+  // compressed sparse row adjacency, arcs in the order they were added
+  int nnodes = nodes_.size();
+  node_arc_begin_.assign(nnodes + 1, 0);
+  for (int i = 0; i < narcs; i++) {
+    node_arc_begin_[unode_[i] + 1]++;
+    node_arc_begin_[vnode_[i] + 1]++;
+  }
+  for (int i = 0; i < nnodes; i++) {
+    node_arc_begin_[i + 1] += node_arc_begin_[i];
+  }
+  node_arcs_.resize(2 * narcs);
+  std::vector<int> next(node_arc_begin_.begin(), node_arc_begin_.end() - 1);
+  for (int i = 0; i < narcs; i++) {
+    node_arcs_[next[unode_[i]]++] = i;
+    node_arcs_[next[vnode_[i]]++] = i;
+  }
+
+  node_index_.clear();
+}
+
+void FlatExchangeGraph::AddGroup(ExchangeNodeGroup* grp, int g) {
+  std::vector<ExchangeNode::Ptr>& nodes = grp->nodes();
+  for (int i = 0; i < nodes.size(); i++) {
+    const ExchangeNode::Ptr& n = nodes[i];
+    node_index_[n.get()] = nodes_.size();
+    nodes_.push_back(n);
+    node_grp_.push_back(g);
+    node_qty_.push_back(n->qty);
+    node_excl_.push_back(n->exclusive);
+    node_agent_.push_back(n->agent_id);
+    node_commod_.push_back(n->commod_id);
+  }
+  grp_node_begin_.push_back(nodes_.size());
+
+  const std::vector<double>& caps = grp->capacities();
+  caps_.insert(caps_.end(), caps.begin(), caps.end());
+  grp_cap_begin_.push_back(caps_.size());
+}
+
+int FlatExchangeGraph::AddNode(const ExchangeNode::Ptr& n) {
+  std::unordered_map<const ExchangeNode*, int>::iterator it =
+      node_index_.find(n.get());
+  if (it != node_index_.end()) {
+    return it->second;
+  }
+
+  int i = nodes_.size();
+  node_index_[n.get()] = i;
+  nodes_.push_back(n);
+  node_grp_.push_back(-1);
+  node_qty_.push_back(n->qty);
+  node_excl_.push_back(n->exclusive);
+  node_agent_.push_back(n->agent_id);
+  node_commod_.push_back(n->commod_id);
+  return i;
+}
+
+void FlatExchangeGraph::AddExclGroups(ExchangeNodeGroup* grp) {
+  std::vector< std::vector<ExchangeNode::Ptr> >& exngs =
+      grp->excl_node_groups();
+  for (int i = 0; i < exngs.size(); i++) {
+    for (int j = 0; j < exngs[i].size(); j++) {
+      excl_nodes_.push_back(AddNode(exngs[i][j]));
+    }
+    excl_node_begin_.push_back(excl_nodes_.size());
+  }
+  grp_excl_begin_.push_back(excl_node_begin_.size() - 1);
+}
+
+void FlatExchangeGraph::AddUnitCaps(const ExchangeNode::Ptr& n, const Arc& a,
+                                    std::vector<double>* caps) {
+  std::map<Arc, std::vector<double> >::const_iterator it =
+      n->unit_capacities.find(a);
+  if (it != n->unit_capacities.end()) {
+    caps->insert(caps->end(), it->second.begin(), it->second.end());
+  }
+}
+
+}  // namespace cyclus
@@ -0,0 +1,189 @@
+#ifndef CYCLUS_SRC_FLAT_EXCHANGE_GRAPH_H_
+#define CYCLUS_SRC_FLAT_EXCHANGE_GRAPH_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "exchange_graph.h"
+
+namespace cyclus {
+
+/// @class FlatExchangeGraph
+///
+/// @brief A compact, index-based representation of an ExchangeGraph for use
+/// by solvers and translators.
+///
+/// Groups, nodes, and arcs are identified by integer indices and their
+/// properties are stored in flat arrays, so that solving a graph requires
+/// neither reference counting (locking an Arc's nodes) nor map lookups
+/// (ExchangeNode::prefs, ExchangeNode::unit_capacities, ExchangeGraph::arc_ids).
+///
+/// - Groups: the graph's request groups are indexed first, in order, followed
+///   by its supply groups. A group's capacities are stored contiguously.
+/// - Nodes: the nodes of each group are indexed contiguously, in the group's
+///   order. Nodes that are part of an arc but not of any group of the graph
+///   are appended with a group of -1.
+/// - Arcs: arc i is ExchangeGraph::arcs()[i]. Each arc stores the unit
+///   capacities of both of its nodes, and each node stores the indices of its
+///   arcs (i.e., a compressed sparse row adjacency), in the order the arcs
+///   were added to the graph.
+///
+/// A FlatExchangeGraph is derived from an ExchangeGraph, which remains the
+/// representation that ExchangeTranslator builds and that aggregation,
+/// back-translation, and the Capacity API use. Building one locks each arc's
+/// nodes and looks up their preference and unit capacity maps once, so the
+/// cost of translating an exchange is unchanged; only solving avoids it.
+///
+/// A FlatExchangeGraph is a snapshot of a graph's structure: it must be
+/// rebuilt if groups, nodes, or arcs are added to the graph or reordered, and
+/// it must not outlive the graph. A graph's solvers and translators share the
+/// one built by ExchangeGraph::flat(). Matches found using it are added to the
+/// graph with ExchangeGraph::AddMatch(arc(i), qty).
+class FlatExchangeGraph {
+ public:
+  explicit FlatExchangeGraph(ExchangeGraph* g);
+
+  /// @return the graph this was built from
+  inline ExchangeGraph* graph() const { return g_; }
+
+  /// groups
+  /// @{
+  inline int n_groups() const { return grp_node_begin_.size() - 1; }
+  inline int n_req_groups() const { return nreq_; }
+  inline bool request(int g) const { return g < nreq_; }
+
+  /// @return the requested quantity of request group g
+  inline double req_qty(int g) const { return req_qty_[g]; }
+
+  /// nodes of group g are indexed [node_begin(g), node_end(g))
+  inline int node_begin(int g) const { return grp_node_begin_[g]; }
+  inline int node_end(int g) const { return grp_node_begin_[g + 1]; }
+
+  /// the capacities of group g are capacities()[cap_begin(g) + i] for i in
+  /// [0, n_caps(g))
+  inline int cap_begin(int g) const { return grp_cap_begin_[g]; }
+  inline int n_caps(int g) const {
+    return grp_cap_begin_[g + 1] - grp_cap_begin_[g];
+  }
+  inline const std::vector<double>& capacities() const { return caps_; }
+
+  /// exclusive node groups of group g are indexed [excl_begin(g),
+  /// excl_end(g)), their nodes are excl_nodes(e)[i] for i in
+  /// [0, n_excl_nodes(e))
+  inline int excl_begin(int g) const { return grp_excl_begin_[g]; }
+  inline int excl_end(int g) const { return grp_excl_begin_[g + 1]; }
+  inline int n_excl_nodes(int e) const {
+    return excl_node_begin_[e + 1] - excl_node_begin_[e];
+  }
+  inline const int* excl_nodes(int e) const {
+    return excl_nodes_.data() + excl_node_begin_[e];
+  }
+  /// @}
+
+  /// nodes
+  /// @{
+  inline int n_nodes() const { return nodes_.size(); }
+  inline const ExchangeNode::Ptr& node(int n) const { return nodes_[n]; }
+
+  /// @return the node's group or -1 if it is not part of a group of the graph
+  inline int group(int n) const { return node_grp_[n]; }
+  inline double qty(int n) const { return node_qty_[n]; }
+  inline bool exclusive(int n) const { return node_excl_[n]; }
+  inline int agent_id(int n) const { return node_agent_[n]; }
+
+  /// @return the node's ExchangeNode::commod_id
+  inline int commod_id(int n) const { return node_commod_[n]; }
+
+  /// the arcs of node n are node_arcs(n)[i] for i in [0, n_node_arcs(n))
+  inline int n_node_arcs(int n) const {
+    return node_arc_begin_[n + 1] - node_arc_begin_[n];
+  }
+  inline const int* node_arcs(int n) const {
+    return node_arcs_.data() + node_arc_begin_[n];
+  }
+  /// @}
+
+  /// arcs
+  /// @{
+  inline int n_arcs() const { return unode_.size(); }
+  inline const Arc& arc(int a) const { return g_->arcs()[a]; }
+  inline int unode(int a) const { return unode_[a]; }
+  inline int vnode(int a) const { return vnode_[a]; }
+  inline bool arc_exclusive(int a) const { return arc_excl_[a]; }
+  inline double excl_val(int a) const { return excl_val_[a]; }
+
+  /// @return the arc's preference, i.e., Arc::pref()
+  inline double pref(int a) const { return pref_[a]; }
+
+  /// @return the preference the arc's request node has for the arc, i.e.,
+  /// ExchangeNode::prefs, or 0 if it has none
+  inline double req_pref(int a) const { return req_pref_[a]; }
+
+  /// the unit capacities of the arc's unode are ucaps(a)[i] for i in
+  /// [0, n_ucaps(a)), likewise for its vnode
+  inline int n_ucaps(int a) const {
+    return ucap_begin_[a + 1] - ucap_begin_[a];
+  }
+  inline const double* ucaps(int a) const {
+    return ucaps_.data() + ucap_begin_[a];
+  }
+  inline int n_vcaps(int a) const {
+    return vcap_begin_[a + 1] - vcap_begin_[a];
+  }
+  inline const double* vcaps(int a) const {
+    return vcaps_.data() + vcap_begin_[a];
+  }
+  /// @}
+
+ private:
+  /// indexes all nodes of a group and its capacities
+  void AddGroup(ExchangeNodeGroup* grp, int g);
+
+  /// indexes a node that is not part of any group of the graph
+  int AddNode(const ExchangeNode::Ptr& n);
+
+  /// indexes the exclusive node groups of a group
+  void AddExclGroups(ExchangeNodeGroup* grp);
+
+  /// appends the unit capacities n has for a to caps
+  static void AddUnitCaps(const ExchangeNode::Ptr& n, const Arc& a,
+                          std::vector<double>* caps);
+
+  ExchangeGraph* g_;
+  int nreq_;
+
+  std::vector<int> grp_node_begin_;
+  std::vector<int> grp_cap_begin_;
+  std::vector<double> caps_;
+  std::vector<double> req_qty_;
+  std::vector<int> grp_excl_begin_;
+  std::vector<int> excl_node_begin_;
+  std::vector<int> excl_nodes_;
+
+  std::vector<ExchangeNode::Ptr> nodes_;
+  std::vector<int> node_grp_;
+  std::vector<double> node_qty_;
+  std::vector<char> node_excl_;
+  std::vector<int> node_agent_;
+  std::vector<int> node_commod_;
+  std::vector<int> node_arc_begin_;
+  std::vector<int> node_arcs_;
+
+  std::vector<int> unode_;
+  std::vector<int> vnode_;
+  std::vector<char> arc_excl_;
+  std::vector<double> excl_val_;
+  std::vector<double> pref_;
+  std::vector<double> req_pref_;
+  std::vector<int> ucap_begin_;
+  std::vector<double> ucaps_;
+  std::vector<int> vcap_begin_;
+  std::vector<double> vcaps_;
+
+  /// node indices, only used while building
+  std::unordered_map<const ExchangeNode*, int> node_index_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_FLAT_EXCHANGE_GRAPH_H_
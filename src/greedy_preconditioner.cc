@@ -44,10 +44,13 @@ GreedyPreconditioner::GreedyPreconditioner(
 
 void GreedyPreconditioner::Condition(ExchangeGraph* graph) {
   avg_prefs_.clear();
+  id_weights_.clear();  // ids are only unique within a graph
 
   std::vector<RequestGroup::Ptr>& groups =
       const_cast<std::vector<RequestGroup::Ptr>&>(graph->request_groups());
 
+  // the graph's FlatExchangeGraph is only discarded if its order changes
+  bool reordered = false;
   std::vector<RequestGroup::Ptr>::iterator it;
   for (it = groups.begin(); it != groups.end(); ++it) {
     std::vector<ExchangeNode::Ptr>& nodes =
@@ -59,9 +62,14 @@ void GreedyPreconditioner::Condition(ExchangeGraph* graph) {
     }
 
     // sort nodes by weight
-    std::stable_sort(
-        nodes.begin(), nodes.end(),
-        l::bind(&GreedyPreconditioner::NodeComp, this, l::_1, l::_2));
+    if (!std::is_sorted(
+            nodes.begin(), nodes.end(),
+            l::bind(&GreedyPreconditioner::NodeComp, this, l::_1, l::_2))) {
+      std::stable_sort(
+          nodes.begin(), nodes.end(),
+          l::bind(&GreedyPreconditioner::NodeComp, this, l::_1, l::_2));
+      reordered = true;
+    }
 
     // get avg group weights
     group_weights_[*it] = GroupWeight(*it, &commod_weights_, &avg_prefs_);
@@ -70,9 +78,17 @@ void GreedyPreconditioner::Condition(ExchangeGraph* graph) {
   }
 
   // sort groups by avg weight
-  std::stable_sort(
-      groups.begin(), groups.end(),
-      l::bind(&GreedyPreconditioner::GroupComp, this, l::_1, l::_2));
+  if (!std::is_sorted(
+          groups.begin(), groups.end(),
+          l::bind(&GreedyPreconditioner::GroupComp, this, l::_1, l::_2))) {
+    std::stable_sort(
+        groups.begin(), groups.end(),
+        l::bind(&GreedyPreconditioner::GroupComp, this, l::_1, l::_2));
+    reordered = true;
+  }
+  if (reordered) {
+    graph->ClearFlat();
+  }
 
   // clear graph-specific state
   group_weights_.clear();
@@ -114,6 +130,24 @@ void GreedyPreconditioner::ProcessWeights_(WgtOrder order) {
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double GreedyPreconditioner::CommodWeight_(const ExchangeNode::Ptr& n) {
+  if (commod_weights_.size() == 0) {
+    return 1;
+  }
+  int id = n->commod_id;
+  if (id < 0) {
+    return commod_weights_[n->commod];
+  }
+  if (id >= id_weights_.size()) {
+    id_weights_.resize(id + 1, -1);
+  }
+  if (id_weights_[id] < 0) {
+    id_weights_[id] = commod_weights_[n->commod];
+  }
+  return id_weights_[id];
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double GroupWeight(RequestGroup::Ptr g,
                    std::map<std::string, double>* weights,
@@ -134,6 +168,11 @@ double NodeWeight(ExchangeNode::Ptr n,
                   std::map<std::string, double>* weights,
                   double avg_pref) {
   double commod_weight = (weights->size() != 0) ? (*weights)[n->commod] : 1;
+  return NodeWeight(commod_weight, avg_pref);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double NodeWeight(double commod_weight, double avg_pref) {
   double node_weight = commod_weight * (1 + avg_pref / (1 + avg_pref));
 
   CLOG(LEV_DEBUG5) << "Determining node weight: ";
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "exchange_graph.h"
 
@@ -13,6 +14,9 @@ double NodeWeight(ExchangeNode::Ptr n,
                   std::map<std::string, double>* weights,
                   double avg_pref);
 
+/// @returns the weight of a node given the weight of its commodity
+double NodeWeight(double commod_weight, double avg_pref);
+
 /// @returns average RequestGroup weight
 double GroupWeight(RequestGroup::Ptr g,
                    std::map<std::string, double>* weights,
@@ -87,8 +91,8 @@ class GreedyPreconditioner {
   inline bool NodeComp(const ExchangeNode::Ptr l,
                        const ExchangeNode::Ptr r) {
     return
-        NodeWeight(l, &commod_weights_, avg_prefs_[l]) >
-        NodeWeight(r, &commod_weights_, avg_prefs_[r]);
+        NodeWeight(CommodWeight_(l), avg_prefs_[l]) >
+        NodeWeight(CommodWeight_(r), avg_prefs_[r]);
   }
 
   /// @brief a comparitor for ordering containers of Request::Ptrs in
@@ -103,9 +107,15 @@ class GreedyPreconditioner {
   /// direction
   void ProcessWeights_(WgtOrder order);
 
+  /// @brief the weight of a node's commodity, which is looked up by name once
+  /// per interned commodity id and graph
+  double CommodWeight_(const ExchangeNode::Ptr& n);
+
   bool apply_commod_weights_;
   std::map<ExchangeNode::Ptr, double> avg_prefs_;
   std::map<std::string, double> commod_weights_;
+  /// commodity weights by interned id, -1 if not yet looked up
+  std::vector<double> id_weights_;
   std::map<RequestGroup::Ptr, double> group_weights_;
 };
 
@@ -8,6 +8,7 @@
 
 #include "cyc_limits.h"
 #include "error.h"
+#include "flat_exchange_graph.h"
 #include "logger.h"
 
 namespace cyclus {
@@ -38,6 +39,16 @@ GreedySolver::~GreedySolver() {
     delete conditioner_;
 }
 
+ExchangeSolver* GreedySolver::Clone() const {
+  GreedyPreconditioner* c = NULL;
+  if (conditioner_ != NULL) {
+    c = new GreedyPreconditioner(*conditioner_);
+  }
+  GreedySolver* s = new GreedySolver(exclusive_orders_, c);
+  s->verbose_ = verbose_;
+  return s;
+}
+
 void GreedySolver::Condition() {
   if (conditioner_ != NULL)
     conditioner_->Condition(graph_);
@@ -62,15 +73,19 @@ double GreedySolver::SolveGraph() {
   Condition();
   obj_ = 0;
   unmatched_ = 0;
-  n_qty_.clear();
-  
-  Init();
- 
-  std::for_each(graph_->request_groups().begin(),
-                graph_->request_groups().end(),
-                std::bind1st(
-                    std::mem_fun(&GreedySolver::GreedilySatisfySet),
-                    this));
+
+  flat_ = graph_->flat();
+  flat_qty_.assign(flat_->n_nodes(), 0);
+  flat_caps_ = flat_->capacities();
+  try {
+    for (int g = 0; g < flat_->n_req_groups(); g++) {
+      GreedilySatisfySet_(g);
+    }
+  } catch (...) {
+    flat_.reset();
+    throw;
+  }
+  flat_.reset();
 
   obj_ += unmatched_ * pseudo_cost;
   return obj_;
@@ -100,142 +115,237 @@ double GreedySolver::Capacity(ExchangeNode::Ptr n, const Arc& a, bool min_cap,
     return n->qty - curr_qty;
   }
 
-  std::vector<double>& unit_caps = n->unit_capacities[a];
+  const std::vector<double>& unit_caps = n->unit_capacities[a];
   const std::vector<double>& group_caps = grp_caps_[n->group];
-  std::vector<double> caps;
-  double grp_cap, u_cap, cap;
-
+  double cap = min_cap ? std::numeric_limits<double>::max() :
+               -std::numeric_limits<double>::max();
   for (int i = 0; i < unit_caps.size(); i++) {
-    grp_cap = group_caps[i];
-    u_cap = unit_caps[i];
-    cap = grp_cap / u_cap;
+    double grp_cap = group_caps[i];
+    double u_cap = unit_caps[i];
+    // special case for unlimited capacities
+    double c = (grp_cap == std::numeric_limits<double>::max()) ?
+               std::numeric_limits<double>::max() : grp_cap / u_cap;
     CLOG(cyclus::LEV_DEBUG1) << "Capacity for node: ";
     CLOG(cyclus::LEV_DEBUG1) << "   group capacity: " << grp_cap;
     CLOG(cyclus::LEV_DEBUG1) << "    unit capacity: " << u_cap;
-    CLOG(cyclus::LEV_DEBUG1) << "         capacity: " << cap;
-
-    // special case for unlimited capacities
-    if (grp_cap == std::numeric_limits<double>::max()) {
-      caps.push_back(std::numeric_limits<double>::max());
-    } else {
-      caps.push_back(cap);
-    }
-  }
+    CLOG(cyclus::LEV_DEBUG1) << "         capacity: " << c;
 
-  if (min_cap) {  // the smallest value is constraining (for bids)
-    cap = *std::min_element(caps.begin(), caps.end());
-  } else {  // the largest value must be met (for requests)
-    cap = *std::max_element(caps.begin(), caps.end());
+    // the smallest value is constraining (for bids), the largest value must
+    // be met (for requests)
+    cap = min_cap ? std::min(cap, c) : std::max(cap, c);
   }
   return std::min(cap, n->qty - curr_qty);
 }
 
 void GreedySolver::GetCaps(ExchangeNodeGroup::Ptr g) {
-  for (int i = 0; i != g->nodes().size(); i++) {
-    n_qty_[g->nodes()[i]] = 0;
-  }
   grp_caps_[g.get()] = g->capacities();
 }
 
-void GreedySolver::GreedilySatisfySet(RequestGroup::Ptr prs) {
-  std::vector<ExchangeNode::Ptr>& nodes = prs->nodes();
-  std::stable_sort(nodes.begin(), nodes.end(), AvgPrefComp);
+namespace {
+
+/// orders node indices like AvgPrefComp given each node's average preference
+struct FlatAvgPrefComp {
+  FlatAvgPrefComp(const FlatExchangeGraph* flat, const double* avg_prefs,
+                  int begin)
+      : flat(flat),
+        avg_prefs(avg_prefs),
+        begin(begin) {}
+
+  bool operator()(int l, int r) const {
+    double lpref = avg_prefs[l - begin];
+    double rpref = avg_prefs[r - begin];
+    return (lpref != rpref) ? (lpref > rpref) :
+        (flat->agent_id(l) > flat->agent_id(r));
+  }
+
+  const FlatExchangeGraph* flat;
+  const double* avg_prefs;
+  int begin;
+};
+
+/// orders arc indices like ReqPrefComp
+struct FlatReqPrefComp {
+  explicit FlatReqPrefComp(const FlatExchangeGraph* flat) : flat(flat) {}
+
+  bool operator()(int l, int r) const {
+    int lu = flat->agent_id(flat->unode(l));
+    int lv = flat->agent_id(flat->vnode(l));
+    int ru = flat->agent_id(flat->unode(r));
+    int rv = flat->agent_id(flat->vnode(r));
+    double lpref = flat->req_pref(l);
+    double rpref = flat->req_pref(r);
+    return (lpref != rpref) ? (lpref > rpref) :
+        (lu > ru || (lu == ru && lv > rv));
+  }
+
+  const FlatExchangeGraph* flat;
+};
+
+}  // namespace
+
+void GreedySolver::GreedilySatisfySet_(int g) {
+  // order the group's nodes by average preference, in the graph as well
+  int begin = flat_->node_begin(g);
+  int end = flat_->node_end(g);
+  std::vector<double> avg_prefs(end - begin);
+  std::vector<int> nodes(end - begin);
+  for (int i = begin; i < end; i++) {
+    avg_prefs[i - begin] = AvgPref(flat_->node(i));
+    nodes[i - begin] = i;
+  }
+  std::stable_sort(nodes.begin(), nodes.end(),
+                   FlatAvgPrefComp(flat_.get(), avg_prefs.data(), begin));
+  std::vector<ExchangeNode::Ptr>& grp_nodes =
+      graph_->request_groups()[g]->nodes();
+  bool reordered = false;
+  for (int i = 0; i < nodes.size(); i++) {
+    if (grp_nodes[i] != flat_->node(nodes[i])) {
+      grp_nodes[i] = flat_->node(nodes[i]);
+      reordered = true;
+    }
+  }
+  if (reordered) {
+    graph_->ClearFlat();  // flat_ is kept for the remaining groups
+  }
 
-  std::vector<ExchangeNode::Ptr>::iterator req_it = nodes.begin();
-  double target = prs->qty();
+  std::vector<int>::iterator req_it = nodes.begin();
+  double target = flat_->req_qty(g);
   double match = 0;
 
-  ExchangeNode::Ptr u, v;
-  std::vector<Arc>::const_iterator arc_it;
-  std::vector<Arc> sorted;
+  int u, v;
+  std::vector<int>::const_iterator arc_it;
+  std::vector<int> sorted;
   double remain, tomatch, excl_val;
 
   CLOG(LEV_DEBUG1) << "Greedy Solving for " << target
                    << " amount of a resource.";
 
   while ((match <= target) && (req_it != nodes.end())) {
-    // this if statement is needed because map.at() will throw if the key does
-    // not exist, which is a corner case for when there is a request with no bid
-    // arcs associated with it
-    if (graph_->node_arc_map().count(*req_it) > 0) {
-      const std::vector<Arc>& arcs = graph_->node_arc_map().at(*req_it);
-      sorted = std::vector<Arc>(arcs);  // make a copy for now
-      std::stable_sort(sorted.begin(), sorted.end(), ReqPrefComp);
-      arc_it = sorted.begin();
-
-      while ((match <= target) && (arc_it != sorted.end())) {
-        remain = target - match;
-        const Arc& a = *arc_it;
-        u = a.unode();
-        v = a.vnode();
-        // capacity adjustment
-        tomatch = std::min(remain, Capacity(a, n_qty_[u], n_qty_[v]));
-
-        // exclusivity adjustment
-        if (arc_it->exclusive()) {
-          excl_val = a.excl_val();
-
-          // this careful float comparison is vital for preventing false positive
-          // constraint violations w.r.t. exclusivity-related capacity.
-          double dist = boost::math::float_distance(tomatch, excl_val);
-          if (dist >= float_ulp_eq ) {
-            tomatch = 0;
-          } else {
-            tomatch = excl_val;
-          }
+    u = *req_it;
+    const int* arcs = flat_->node_arcs(u);
+    sorted.assign(arcs, arcs + flat_->n_node_arcs(u));
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     FlatReqPrefComp(flat_.get()));
+    arc_it = sorted.begin();
+
+    while ((match <= target) && (arc_it != sorted.end())) {
+      remain = target - match;
+      int a = *arc_it;
+      v = flat_->vnode(a);
+      // capacity adjustment
+      tomatch = std::min(remain, Capacity_(a, flat_qty_[u], flat_qty_[v]));
+
+      // exclusivity adjustment
+      if (flat_->arc_exclusive(a)) {
+        excl_val = flat_->excl_val(a);
+
+        // this careful float comparison is vital for preventing false positive
+        // constraint violations w.r.t. exclusivity-related capacity.
+        double dist = boost::math::float_distance(tomatch, excl_val);
+        if (dist >= float_ulp_eq ) {
+          tomatch = 0;
+        } else {
+          tomatch = excl_val;
         }
-
-        if (tomatch > eps()) {
-          CLOG(LEV_DEBUG1) << "Greedy Solver is matching " << tomatch
-                           << " amount of a resource.";
-          UpdateCapacity(u, a, tomatch);
-          UpdateCapacity(v, a, tomatch);
-          n_qty_[u] += tomatch;
-          n_qty_[v] += tomatch;
-          graph_->AddMatch(a, tomatch);
-
-          match += tomatch;
-          UpdateObj(tomatch, u->prefs[a]);
-        }
-        ++arc_it;
-      }  // while( (match =< target) && (arc_it != arcs.end()) )
-    }  // if(graph_->node_arc_map().count(*req_it) > 0)
+      }
+
+      if (tomatch > eps()) {
+        CLOG(LEV_DEBUG1) << "Greedy Solver is matching " << tomatch
+                         << " amount of a resource.";
+        UpdateCapacity_(u, flat_->ucaps(a), flat_->n_ucaps(a), tomatch);
+        UpdateCapacity_(v, flat_->vcaps(a), flat_->n_vcaps(a), tomatch);
+        flat_qty_[u] += tomatch;
+        flat_qty_[v] += tomatch;
+        graph_->AddMatch(flat_->arc(a), tomatch);
+
+        match += tomatch;
+        UpdateObj(tomatch, flat_->req_pref(a));
+      }
+      ++arc_it;
+    }  // while( (match =< target) && (arc_it != arcs.end()) )
     ++req_it;
   }  // while( (match =< target) && (req_it != nodes.end()) )
 
   unmatched_ += target - match;
 }
 
+double GreedySolver::Capacity_(int a, double u_curr_qty, double v_curr_qty) {
+  bool min = true;
+  double ucap = NodeCapacity_(flat_->unode(a), flat_->ucaps(a),
+                              flat_->n_ucaps(a), !min, u_curr_qty);
+  double vcap = NodeCapacity_(flat_->vnode(a), flat_->vcaps(a),
+                              flat_->n_vcaps(a), min, v_curr_qty);
+
+  CLOG(cyclus::LEV_DEBUG1) << "Capacity for unode of arc: " << ucap;
+  CLOG(cyclus::LEV_DEBUG1) << "Capacity for vnode of arc: " << vcap;
+  CLOG(cyclus::LEV_DEBUG1) << "Capacity for arc         : "
+                           << std::min(ucap, vcap);
+
+  return std::min(ucap, vcap);
+}
+
+double GreedySolver::NodeCapacity_(int n, const double* ucaps, int nucaps,
+                                   bool min_cap, double curr_qty) {
+  int g = flat_->group(n);
+  if (g == -1) {
+    throw cyclus::StateError("An notion of node capacity requires a nodegroup.");
+  }
+
+  if (nucaps == 0) {
+    return flat_->qty(n) - curr_qty;
+  }
+
+  const double* group_caps = &flat_caps_[flat_->cap_begin(g)];
+  double cap = min_cap ? std::numeric_limits<double>::max() :
+               -std::numeric_limits<double>::max();
+  for (int i = 0; i < nucaps; i++) {
+    double grp_cap = group_caps[i];
+    // special case for unlimited capacities
+    double c = (grp_cap == std::numeric_limits<double>::max()) ?
+               std::numeric_limits<double>::max() : grp_cap / ucaps[i];
+    CLOG(cyclus::LEV_DEBUG1) << "Capacity for node: ";
+    CLOG(cyclus::LEV_DEBUG1) << "   group capacity: " << grp_cap;
+    CLOG(cyclus::LEV_DEBUG1) << "    unit capacity: " << ucaps[i];
+    CLOG(cyclus::LEV_DEBUG1) << "         capacity: " << c;
+
+    // the smallest value is constraining (for bids), the largest value must
+    // be met (for requests)
+    cap = min_cap ? std::min(cap, c) : std::max(cap, c);
+  }
+  return std::min(cap, flat_->qty(n) - curr_qty);
+}
+
 void GreedySolver::UpdateObj(double qty, double pref) {
   // updates minimizing object (i.e., 1/pref is a cost and the objective is cost
   // * flow)
   obj_ += qty / pref;
 }
 
-void GreedySolver::UpdateCapacity(ExchangeNode::Ptr n, const Arc& a,
-                                  double qty) {
+void GreedySolver::UpdateCapacity_(int n, const double* ucaps, int nucaps,
+                                   double qty) {
   using cyclus::IsNegative;
   using cyclus::ValueError;
 
-  std::vector<double>& unit_caps = n->unit_capacities[a];
-  std::vector<double>& caps = grp_caps_[n->group];
-  assert(unit_caps.size() == caps.size());
-  for (int i = 0; i < caps.size(); i++) {
-    double prev = caps[i];
-    // special case for unlimited capacities
-    CLOG(cyclus::LEV_DEBUG1) << "Updating capacity value from: "
-                             << prev;
-    caps[i] = (prev == std::numeric_limits<double>::max()) ?
-              std::numeric_limits<double>::max() :
-              prev - qty * unit_caps[i];
-    CLOG(cyclus::LEV_DEBUG1) << "                          to: "
-                             << caps[i];
+  if (nucaps > 0) {
+    double* caps = &flat_caps_[flat_->cap_begin(flat_->group(n))];
+    assert(nucaps == flat_->n_caps(flat_->group(n)));
+    for (int i = 0; i < nucaps; i++) {
+      double prev = caps[i];
+      // special case for unlimited capacities
+      CLOG(cyclus::LEV_DEBUG1) << "Updating capacity value from: "
+                               << prev;
+      caps[i] = (prev == std::numeric_limits<double>::max()) ?
+                std::numeric_limits<double>::max() :
+                prev - qty * ucaps[i];
+      CLOG(cyclus::LEV_DEBUG1) << "                          to: "
+                               << caps[i];
+    }
   }
 
-  if (IsNegative(n->qty - qty)) {
+  if (IsNegative(flat_->qty(n) - qty)) {
     std::stringstream ss;
-    ss << "A bid for " << n->commod << " was set at " << n->qty
-       << " but has been matched to a higher value " << qty
+    ss << "A bid for " << flat_->node(n)->commod << " was set at "
+       << flat_->qty(n) << " but has been matched to a higher value " << qty
        << ". This could be due to a problem with your "
        << "bid portfolio constraints.";
     throw ValueError(ss.str());
@@ -45,6 +45,7 @@ inline bool AvgPrefComp(ExchangeNode::Ptr l, ExchangeNode::Ptr r) {
 }
 
 class ExchangeGraph;
+class FlatExchangeGraph;
 class GreedyPreconditioner;
 
 /// @brief The GreedySolver provides the implementation for a "greedy" solution
@@ -59,6 +60,11 @@ class GreedyPreconditioner;
 ///   1) All RequestGroups are satisfied
 ///   2) All SupplySets are at capacity
 ///
+/// The graph is solved using its shared FlatExchangeGraph (see
+/// ExchangeGraph::flat). The public Capacity member functions operate on the
+/// graph's nodes and arcs directly, are not used for solving, and require a
+/// call to Init.
+///
 /// @warning the GreedySolver is responsible for deleting is conditioner!
 class GreedySolver: public ExchangeSolver {
  public:
@@ -76,6 +82,9 @@ class GreedySolver: public ExchangeSolver {
   
   virtual ~GreedySolver();
 
+  /// @return a new GreedySolver with a copy of this solver's conditioner
+  virtual ExchangeSolver* Clone() const;
+
   /// Uses the provided (or a default) GreedyPreconditioner to condition the
   /// solver's ExchangeGraph so that RequestGroups are ordered by average
   /// preference and commodity weight.
@@ -132,25 +141,47 @@ class GreedySolver: public ExchangeSolver {
   /// from the beginning of the the respective request and bid containers.
   virtual double SolveGraph();
 
- private:
-  /// @brief updates the capacity of a given ExchangeNode (i.e., its max_qty and the
-  /// capacities of its ExchangeNodeGroup)
-  ///
-  /// @throws StateError if ExchangeNode does not have a ExchangeNodeGroup
-  /// @throws ValueError if the update results in a negative ExchangeNodeGroup
-  /// capacity or a negative ExchangeNode max_qty
-  /// @param n the ExchangeNode
-  /// @param qty the quantity for the node to update
-  void GetCaps(ExchangeNodeGroup::Ptr prs);
-  void GreedilySatisfySet(RequestGroup::Ptr prs);
-  void UpdateCapacity(ExchangeNode::Ptr n, const Arc& a, double qty);
+  /// @brief conditions the whole graph so that components are solved, and
+  /// their matches ordered, exactly as the whole graph would be
+  virtual void PrepareGraph() { Condition(); }
+
   void UpdateObj(double qty, double pref);
-  
+
+  /// @brief matches the nodes of the g'th request group of flat_
+  void GreedilySatisfySet_(int g);
+
+  /// @brief the capacity of arc a of flat_, see Capacity(const Arc&, double,
+  /// double)
+  double Capacity_(int a, double u_curr_qty, double v_curr_qty);
+
+  /// @brief the capacity of node n of flat_ given its unit capacities for an
+  /// arc, see Capacity(ExchangeNode::Ptr, const Arc&, bool, double)
+  double NodeCapacity_(int n, const double* ucaps, int nucaps, bool min_cap,
+                       double curr_qty);
+
+  /// @brief updates the capacities of node n's group given its unit
+  /// capacities for an arc
+  ///
+  /// @throws ValueError if the update results in a negative node quantity
+  void UpdateCapacity_(int n, const double* ucaps, int nucaps, double qty);
+
   GreedyPreconditioner* conditioner_;
-  std::map<ExchangeNode::Ptr, double> n_qty_;
-  std::map<ExchangeNodeGroup*, std::vector<double> > grp_caps_;
+
+  /// the graph being solved and its remaining node quantities and group
+  /// capacities
+  boost::shared_ptr<FlatExchangeGraph> flat_;
+  std::vector<double> flat_qty_;
+  std::vector<double> flat_caps_;
   double obj_;
   double unmatched_;
+
+ private:
+  /// @brief records the capacities of a group for the Capacity member
+  /// functions, see Init
+  void GetCaps(ExchangeNodeGroup::Ptr prs);
+
+  /// the group capacities recorded by Init, which are not used for solving
+  std::map<ExchangeNodeGroup*, std::vector<double> > grp_caps_;
 };
 
 }  // namespace cyclus
@@ -0,0 +1,195 @@
+#ifndef CYCLUS_SRC_ID_REGISTRY_H_
+#define CYCLUS_SRC_ID_REGISTRY_H_
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cyclus {
+
+/// @class IdRegistry
+///
+/// @brief A set of pointers stored contiguously and iterated in order of an
+/// integer id (e.g. agent ids), with O(1) addition and removal.
+///
+/// Objects are appended to a vector of slots and their slot index is kept in
+/// a hash map. Removing an object only clears its slot; slots are compacted
+/// once more than half of them are empty. Because ids are normally handed out
+/// in increasing order, appending keeps the slots sorted. Objects whose id is
+/// smaller than that of the last object (or whose id changed after being
+/// added, e.g. on restart) are moved into place the next time the registry
+/// is iterated. Objects with equal ids are iterated in the order they were
+/// added. An object's id must not change once it has been iterated over.
+///
+/// IdFn is a functor returning the id of a T*.
+///
+/// @warning adding or removing objects invalidates iterators.
+template <class T, class IdFn>
+class IdRegistry {
+ public:
+  class const_iterator
+      : public std::iterator<std::forward_iterator_tag, T*> {
+   public:
+    const_iterator() : reg_(NULL), i_(0) {}
+    const_iterator(const IdRegistry* reg, int i) : reg_(reg), i_(i) {
+      Skip();
+    }
+
+    inline T* operator*() const { return reg_->slots_[i_].second; }
+
+    inline const_iterator& operator++() {
+      ++i_;
+      Skip();
+      return *this;
+    }
+
+    inline const_iterator operator++(int) {
+      const_iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    inline bool operator==(const const_iterator& other) const {
+      return i_ == other.i_;
+    }
+
+    inline bool operator!=(const const_iterator& other) const {
+      return i_ != other.i_;
+    }
+
+   private:
+    /// advances past empty slots
+    inline void Skip() {
+      int n = reg_->slots_.size();
+      while (i_ < n && reg_->slots_[i_].second == NULL) {
+        ++i_;
+      }
+    }
+
+    const IdRegistry* reg_;
+    int i_;
+  };
+
+  typedef const_iterator iterator;
+
+  IdRegistry() : n_(0), sorted_(0) {}
+
+  /// adds t to the registry
+  ///
+  /// @return false if t was already registered
+  bool Add(T* t) {
+    if (index_.count(t) > 0) {
+      return false;
+    }
+    index_[t] = slots_.size();
+    slots_.push_back(std::make_pair(0, t));
+    ++n_;
+    return true;
+  }
+
+  /// removes t from the registry
+  ///
+  /// @return false if t was not registered
+  bool Remove(T* t) {
+    typename std::unordered_map<T*, int>::iterator it = index_.find(t);
+    if (it == index_.end()) {
+      return false;
+    }
+    slots_[it->second].second = NULL;
+    index_.erase(it);
+    --n_;
+    if (2 * n_ < slots_.size()) {
+      Compact();
+    }
+    return true;
+  }
+
+  /// @return true if t is registered
+  inline bool Contains(T* t) const { return index_.count(t) > 0; }
+
+  /// @return the number of registered objects
+  inline int size() const { return n_; }
+
+  inline bool empty() const { return n_ == 0; }
+
+  /// @return an iterator to the registered object with the smallest id
+  const_iterator begin() const {
+    if (sorted_ < slots_.size()) {
+      Sort();
+    }
+    return const_iterator(this, 0);
+  }
+
+  inline const_iterator end() const {
+    return const_iterator(this, slots_.size());
+  }
+
+ private:
+  /// moves every object added (or re-id'd) since the last call into its
+  /// place by id. The ids of empty slots are kept so that the slot ids stay
+  /// sorted.
+  void Sort() const {
+    IdFn id;
+    for (int i = sorted_; i < slots_.size(); ++i) {
+      if (slots_[i].second == NULL) {
+        slots_[i].first = i > 0 ? slots_[i - 1].first : 0;
+        continue;
+      }
+      slots_[i].first = id(slots_[i].second);
+      if (i == 0 || slots_[i - 1].first <= slots_[i].first) {
+        continue;
+      }
+
+      // insert after all slots with an equal or smaller id
+      typename std::vector<std::pair<int, T*> >::iterator pos =
+          std::upper_bound(slots_.begin(), slots_.begin() + i, slots_[i],
+                           CompareId);
+      int start = pos - slots_.begin();
+      std::rotate(pos, slots_.begin() + i, slots_.begin() + i + 1);
+      for (int j = start; j <= i; ++j) {
+        if (slots_[j].second != NULL) {
+          index_[slots_[j].second] = j;
+        }
+      }
+    }
+    sorted_ = slots_.size();
+  }
+
+  /// removes all empty slots
+  void Compact() {
+    int n = 0;
+    int sorted = -1;
+    for (int i = 0; i < slots_.size(); ++i) {
+      if (i == sorted_) {
+        sorted = n;
+      }
+      if (slots_[i].second == NULL) {
+        continue;
+      }
+      slots_[n] = slots_[i];
+      index_[slots_[n].second] = n;
+      ++n;
+    }
+    slots_.resize(n);
+    sorted_ = sorted == -1 ? n : sorted;
+  }
+
+  static bool CompareId(const std::pair<int, T*>& lhs,
+                        const std::pair<int, T*>& rhs) {
+    return lhs.first < rhs.first;
+  }
+
+  /// (id, object) pairs; the id is only valid for the first sorted_ slots
+  mutable std::vector<std::pair<int, T*> > slots_;
+  mutable std::unordered_map<T*, int> index_;
+  int n_;
+
+  /// number of leading slots known to be sorted by id
+  mutable int sorted_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_ID_REGISTRY_H_
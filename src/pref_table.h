@@ -0,0 +1,293 @@
+#ifndef CYCLUS_SRC_PREF_TABLE_H_
+#define CYCLUS_SRC_PREF_TABLE_H_
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "bid.h"
+#include "error.h"
+#include "request.h"
+
+namespace cyclus {
+
+class Trader;
+
+/// @brief the nested-map form of a trader's preferences: for each of its
+/// requests, the preference of each bid
+template <class T>
+struct PrefMap {
+  typedef std::map<Request<T>*, std::map<Bid<T>*, double> > type;
+};
+
+template <class T> class PrefView;
+
+/// @class PrefTable
+///
+/// @brief The preferences of an exchange, one per arc, i.e., per bid, stored
+/// in flat arrays in the order bids are added.
+///
+/// Preferences are adjusted by requesters (and their ancestors) through a
+/// PrefView of the arcs of their requests. Views group arcs by request, in
+/// the order requests first received a bid, and requests by requester. The
+/// grouping is built when the first view is taken after arcs were added.
+template <class T>
+class PrefTable {
+ public:
+  PrefTable() : built_(true) {}
+
+  /// @brief adds the arc of a bid to its request, if it is not in the table
+  /// @param b the bid
+  /// @param pref the arc's initial preference
+  void Add(Bid<T>* b, double pref) {
+    if (bid_arcs_.count(b) > 0) {
+      return;
+    }
+    Request<T>* r = b->request();
+    std::pair<typename std::unordered_map<Request<T>*, int>::iterator, bool>
+        req = req_slots_.insert(std::make_pair(r, reqs_.size()));
+    if (req.second) {
+      std::pair<std::unordered_map<Trader*, int>::iterator, bool> trader =
+          trader_slots_.insert(std::make_pair(r->requester(),
+                                              traders_.size()));
+      if (trader.second) {
+        traders_.push_back(r->requester());
+      }
+      reqs_.push_back(r);
+      req_trader_.push_back(trader.first->second);
+    }
+
+    bid_arcs_[b] = bids_.size();
+    bids_.push_back(b);
+    prefs_.push_back(pref);
+    arc_req_.push_back(req.first->second);
+    built_ = false;
+  }
+
+  /// @return the number of arcs
+  inline int size() const { return bids_.size(); }
+
+  /// @return the bid of an arc
+  inline Bid<T>* bid(int a) const { return bids_[a]; }
+
+  /// @return the preference of an arc
+  inline double& pref(int a) { return prefs_[a]; }
+
+  /// @return the arc of a bid, or -1 if it is not in the table
+  inline int Find(Bid<T>* b) const {
+    typename std::unordered_map<Bid<T>*, int>::const_iterator it =
+        bid_arcs_.find(b);
+    return it == bid_arcs_.end() ? -1 : it->second;
+  }
+
+  /// @return the preference of the arc of a bid
+  /// @throws KeyError if the bid is not in the table
+  inline double& pref(Bid<T>* b) {
+    int a = Find(b);
+    if (a < 0) {
+      throw KeyError("bid is not part of the exchange's preferences");
+    }
+    return prefs_[a];
+  }
+
+  /// @return a view of the arcs of a requester's requests, which is empty if
+  /// it received no bids. Views are invalidated by adding arcs.
+  PrefView<T> View(Trader* requester) {
+    Build_();
+    std::unordered_map<Trader*, int>::const_iterator it =
+        trader_slots_.find(requester);
+    if (it == trader_slots_.end()) {
+      return PrefView<T>(this, requester, 0, 0);
+    }
+    return PrefView<T>(this, requester, trader_begin_[it->second],
+                       trader_begin_[it->second + 1]);
+  }
+
+  /// @return the nested-map form of a requester's preferences
+  typename PrefMap<T>::type Map(Trader* requester) {
+    typename PrefMap<T>::type m;
+    View(requester).ToMap(&m);
+    return m;
+  }
+
+ private:
+  friend class PrefView<T>;
+
+  /// groups requests by requester and arcs by request
+  void Build_() {
+    if (built_) {
+      return;
+    }
+
+    // counting sorts that keep the order of addition within groups
+    trader_begin_.assign(traders_.size() + 1, 0);
+    for (int s = 0; s < reqs_.size(); ++s) {
+      ++trader_begin_[req_trader_[s] + 1];
+    }
+    for (int t = 0; t < traders_.size(); ++t) {
+      trader_begin_[t + 1] += trader_begin_[t];
+    }
+    std::vector<int> next(trader_begin_.begin(), trader_begin_.end() - 1);
+    req_order_.resize(reqs_.size());
+    std::vector<int> req_pos(reqs_.size());
+    for (int s = 0; s < reqs_.size(); ++s) {
+      req_pos[s] = next[req_trader_[s]]++;
+      req_order_[req_pos[s]] = s;
+    }
+
+    req_begin_.assign(reqs_.size() + 1, 0);
+    for (int a = 0; a < bids_.size(); ++a) {
+      ++req_begin_[req_pos[arc_req_[a]] + 1];
+    }
+    for (int i = 0; i < reqs_.size(); ++i) {
+      req_begin_[i + 1] += req_begin_[i];
+    }
+    next.assign(req_begin_.begin(), req_begin_.end() - 1);
+    arc_order_.resize(bids_.size());
+    for (int a = 0; a < bids_.size(); ++a) {
+      arc_order_[next[req_pos[arc_req_[a]]]++] = a;
+    }
+    built_ = true;
+  }
+
+  /// arcs
+  std::vector<Bid<T>*> bids_;
+  std::vector<double> prefs_;
+  std::vector<int> arc_req_;
+  std::unordered_map<Bid<T>*, int> bid_arcs_;
+
+  /// requests and requesters, by slot in order of addition
+  std::vector<Request<T>*> reqs_;
+  std::vector<int> req_trader_;
+  std::unordered_map<Request<T>*, int> req_slots_;
+  std::vector<Trader*> traders_;
+  std::unordered_map<Trader*, int> trader_slots_;
+
+  /// the requests of requester slot t are req_order_[i] for i in
+  /// [trader_begin_[t], trader_begin_[t + 1]), the arcs of the i-th of those
+  /// are arc_order_[j] for j in [req_begin_[i], req_begin_[i + 1])
+  bool built_;
+  std::vector<int> trader_begin_;
+  std::vector<int> req_order_;
+  std::vector<int> req_begin_;
+  std::vector<int> arc_order_;
+};
+
+/// @class PrefView
+///
+/// @brief A view of the preferences of a requester's arcs in a PrefTable,
+/// through which requesters and their ancestors adjust preferences, e.g.,
+///
+/// @code
+/// void MyFacility::AdjustMatlPrefs(cyclus::PrefView<cyclus::Material>& prefs) {
+///   for (int i = 0; i < prefs.size(); ++i) {
+///     cyclus::Request<cyclus::Material>* req = prefs.request(i);
+///     for (int j = 0; j < prefs.n_bids(i); ++j) {
+///       prefs.pref(i, j) *= Weight(req, prefs.bid(i, j));
+///     }
+///   }
+/// }
+/// @endcode
+///
+/// A negative preference removes an arc from the exchange.
+template <class T>
+class PrefView {
+ public:
+  PrefView(PrefTable<T>* table, Trader* requester, int begin, int end)
+      : table_(table),
+        requester_(requester),
+        begin_(begin),
+        end_(end) {}
+
+  /// @return the requester whose preferences are viewed
+  inline Trader* requester() const { return requester_; }
+
+  /// @return the number of requests with bids
+  inline int size() const { return end_ - begin_; }
+
+  /// @return whether there are no arcs
+  inline bool empty() const { return begin_ == end_; }
+
+  /// @return the i-th request
+  inline Request<T>* request(int i) const {
+    return table_->reqs_[table_->req_order_[begin_ + i]];
+  }
+
+  /// @return the number of bids for the i-th request
+  inline int n_bids(int i) const {
+    return table_->req_begin_[begin_ + i + 1] -
+        table_->req_begin_[begin_ + i];
+  }
+
+  /// @return the arc of the j-th bid for the i-th request in the table
+  inline int arc(int i, int j) const {
+    return table_->arc_order_[table_->req_begin_[begin_ + i] + j];
+  }
+
+  /// @return the j-th bid for the i-th request
+  inline Bid<T>* bid(int i, int j) const { return table_->bids_[arc(i, j)]; }
+
+  /// @return the preference of the j-th bid for the i-th request
+  inline double& pref(int i, int j) { return table_->prefs_[arc(i, j)]; }
+
+  /// @brief fills a nested map with the view's preferences
+  void ToMap(typename PrefMap<T>::type* m) const {
+    for (int i = 0; i < size(); ++i) {
+      std::map<Bid<T>*, double>& bids = (*m)[request(i)];
+      for (int j = 0; j < n_bids(i); ++j) {
+        bids.insert(std::make_pair(bid(i, j), table_->prefs_[arc(i, j)]));
+      }
+    }
+  }
+
+  /// @brief sets the view's preferences to those of a nested map, where
+  /// missing arcs have a preference of 0
+  /// @return whether any preference changed
+  bool FromMap(const typename PrefMap<T>::type& m) {
+    bool changed = false;
+    for (int i = 0; i < size(); ++i) {
+      typename PrefMap<T>::type::const_iterator rit = m.find(request(i));
+      for (int j = 0; j < n_bids(i); ++j) {
+        double p = 0;
+        if (rit != m.end()) {
+          typename std::map<Bid<T>*, double>::const_iterator bit =
+              rit->second.find(bid(i, j));
+          p = bit == rit->second.end() ? 0 : bit->second;
+        }
+        double& cur = pref(i, j);
+        changed = changed || cur != p;
+        cur = p;
+      }
+    }
+    return changed;
+  }
+
+  /// @brief adjusts the view's preferences by an agent's PrefMap preference
+  /// adjustment, which the default PrefView adjustments of Agent and Trader
+  /// call to support archetypes that only implement the PrefMap form. The
+  /// preferences are copied into a PrefMap and back.
+  template <class A>
+  void AdjustLegacy(A* a, void (A::*adjust)(typename PrefMap<T>::type&)) {
+    typename PrefMap<T>::type m;
+    ToMap(&m);
+    (a->*adjust)(m);
+    FromMap(m);
+  }
+
+ private:
+  PrefTable<T>* table_;
+  Trader* requester_;
+  int begin_;
+  int end_;
+};
+
+/// @brief the preference views of all requesters descending from an agent,
+/// which it adjusts at once (see Agent::AdjustMatlPrefs)
+template <class T>
+struct PrefBatch {
+  typedef std::vector<PrefView<T> > type;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_PREF_TABLE_H_
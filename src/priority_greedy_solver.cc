@@ -0,0 +1,199 @@
+#include "priority_greedy_solver.h"
+
+#include <algorithm>
+#include <limits>
+#include <boost/math/special_functions/next.hpp>
+
+#include "cyc_limits.h"
+#include "flat_exchange_graph.h"
+#include "logger.h"
+
+namespace cyclus {
+
+PriorityGreedySolver::PriorityGreedySolver() : GreedySolver() {}
+
+PriorityGreedySolver::PriorityGreedySolver(bool exclusive_orders)
+    : GreedySolver(exclusive_orders) {}
+
+PriorityGreedySolver::PriorityGreedySolver(bool exclusive_orders,
+                                           GreedyPreconditioner* c)
+    : GreedySolver(exclusive_orders, c) {}
+
+ExchangeSolver* PriorityGreedySolver::Clone() const {
+  GreedyPreconditioner* c = NULL;
+  if (conditioner_ != NULL) {
+    c = new GreedyPreconditioner(*conditioner_);
+  }
+  PriorityGreedySolver* s = new PriorityGreedySolver(exclusive_orders_, c);
+  s->verbose_ = verbose_;
+  return s;
+}
+
+bool PriorityGreedySolver::KeyComp(const ArcKey& l, const ArcKey& r) {
+  if (l.pref != r.pref) {
+    return l.pref > r.pref;
+  } else if (l.grp != r.grp) {
+    return l.grp < r.grp;
+  } else if (l.node != r.node) {
+    return l.node < r.node;
+  } else if (l.uid != r.uid) {
+    return l.uid > r.uid;
+  } else if (l.vid != r.vid) {
+    return l.vid > r.vid;
+  }
+  return l.arc < r.arc;
+}
+
+bool PriorityGreedySolver::RelaxedComp(const ArcKey& l, const ArcKey& r) {
+  if (l.relaxed != r.relaxed) {
+    return l.relaxed > r.relaxed;
+  }
+  return KeyComp(l, r);
+}
+
+double PriorityGreedySolver::SolveGraph() {
+  double pseudo_cost = PseudoCost();  // from ExchangeSolver API
+  Start_();
+
+  std::vector<double> grp_match(flat_->n_req_groups(), 0);
+  try {
+    for (int i = 0; i < order_.size(); i++) {
+      Match_(order_[i].arc, std::numeric_limits<double>::max(), &grp_match);
+    }
+  } catch (...) {
+    flat_.reset();
+    throw;
+  }
+  return Finish_(grp_match, pseudo_cost);
+}
+
+double PriorityGreedySolver::Repair(ExchangeGraph* graph,
+                                    const std::vector<double>& relaxed) {
+  graph_ = graph;
+  double pseudo_cost = PseudoCost();  // from ExchangeSolver API
+  Start_();
+
+  // non-exclusive arcs are integral in the relaxation, so they are rounded
+  // first
+  std::vector<ArcKey> rounded;
+  for (int i = 0; i < order_.size(); i++) {
+    ArcKey k = order_[i];
+    double x = k.arc < relaxed.size() ? relaxed[k.arc] : 0;
+    if (x > eps()) {
+      k.relaxed = flat_->arc_exclusive(k.arc) ? x : 2;
+      rounded.push_back(k);
+    }
+  }
+  std::sort(rounded.begin(), rounded.end(),
+            &PriorityGreedySolver::RelaxedComp);
+
+  std::vector<double> grp_match(flat_->n_req_groups(), 0);
+  try {
+    for (int i = 0; i < rounded.size(); i++) {
+      int a = rounded[i].arc;
+      double max_qty = flat_->arc_exclusive(a) ?
+                       std::numeric_limits<double>::max() : relaxed[a];
+      Match_(a, max_qty, &grp_match);
+    }
+    for (int i = 0; i < order_.size(); i++) {
+      Match_(order_[i].arc, std::numeric_limits<double>::max(), &grp_match);
+    }
+  } catch (...) {
+    flat_.reset();
+    throw;
+  }
+  return Finish_(grp_match, pseudo_cost);
+}
+
+void PriorityGreedySolver::Start_() {
+  Condition();
+  obj_ = 0;
+  unmatched_ = 0;
+  flat_ = graph_->flat();
+  const FlatExchangeGraph* flat = flat_.get();
+  flat_qty_.assign(flat->n_nodes(), 0);
+  flat_caps_ = flat->capacities();
+  flows_.assign(flat->n_arcs(), 0);
+  matched_.clear();
+
+  // the arcs of all request nodes in global matching order
+  order_.clear();
+  order_.reserve(flat->n_arcs());
+  for (int a = 0; a < flat->n_arcs(); a++) {
+    int u = flat->unode(a);
+    int g = flat->group(u);
+    if (g < 0 || !flat->request(g)) {
+      continue;
+    }
+    ArcKey k;
+    k.relaxed = 0;
+    k.pref = flat->req_pref(a);
+    k.grp = g;
+    k.node = u;
+    k.uid = flat->agent_id(u);
+    k.vid = flat->agent_id(flat->vnode(a));
+    k.arc = a;
+    order_.push_back(k);
+  }
+  std::sort(order_.begin(), order_.end(), &PriorityGreedySolver::KeyComp);
+}
+
+double PriorityGreedySolver::Finish_(const std::vector<double>& grp_match,
+                                     double pseudo_cost) {
+  for (int g = 0; g < grp_match.size(); g++) {
+    unmatched_ += flat_->req_qty(g) - grp_match[g];
+  }
+  for (int i = 0; i < matched_.size(); i++) {
+    graph_->AddMatch(flat_->arc(matched_[i]), flows_[matched_[i]]);
+  }
+  flat_.reset();
+  obj_ += unmatched_ * pseudo_cost;
+  return obj_;
+}
+
+void PriorityGreedySolver::Match_(int a, double max_qty,
+                                  std::vector<double>* grp_match) {
+  int u = flat_->unode(a);
+  int v = flat_->vnode(a);
+  int g = flat_->group(u);
+  double remain = flat_->req_qty(g) - (*grp_match)[g];
+  if (remain < 0) {
+    return;
+  }
+
+  // capacity adjustment
+  double tomatch = std::min(remain, Capacity_(a, flat_qty_[u], flat_qty_[v]));
+  tomatch = std::min(tomatch, max_qty);
+
+  // exclusivity adjustment
+  if (flat_->arc_exclusive(a)) {
+    double excl_val = flat_->excl_val(a);
+
+    // this careful float comparison is vital for preventing false positive
+    // constraint violations w.r.t. exclusivity-related capacity.
+    double dist = boost::math::float_distance(tomatch, excl_val);
+    if (dist >= float_ulp_eq) {
+      tomatch = 0;
+    } else {
+      tomatch = excl_val;
+    }
+  }
+
+  if (tomatch > eps()) {
+    CLOG(LEV_DEBUG1) << "Priority Greedy Solver is matching " << tomatch
+                     << " amount of a resource.";
+    UpdateCapacity_(u, flat_->ucaps(a), flat_->n_ucaps(a), tomatch);
+    UpdateCapacity_(v, flat_->vcaps(a), flat_->n_vcaps(a), tomatch);
+    flat_qty_[u] += tomatch;
+    flat_qty_[v] += tomatch;
+    if (flows_[a] == 0) {
+      matched_.push_back(a);
+    }
+    flows_[a] += tomatch;
+
+    (*grp_match)[g] += tomatch;
+    UpdateObj(tomatch, flat_->req_pref(a));
+  }
+}
+
+}  // namespace cyclus
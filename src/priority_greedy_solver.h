@@ -0,0 +1,112 @@
+#ifndef CYCLUS_SRC_PRIORITY_GREEDY_SOLVER_H_
+#define CYCLUS_SRC_PRIORITY_GREEDY_SOLVER_H_
+
+#include <vector>
+
+#include "greedy_solver.h"
+
+namespace cyclus {
+
+/// @brief The PriorityGreedySolver provides a "greedy" solution to a resource
+/// exchange graph in which arcs are matched in a single, global order of
+/// preference rather than request group by request group.
+///
+/// All arcs of the graph's request nodes are sorted once, in descending order
+/// of the requester's preference. Ties are broken by the order of the arcs'
+/// request groups (i.e., as ordered by the solver's conditioner, if any), then
+/// by the order of their request nodes in the graph, then like ReqPrefComp.
+/// Each arc is then matched as much as its remaining capacity, its request
+/// group's remaining quantity, and its exclusivity allow, exactly as the
+/// GreedySolver matches a single arc. Remaining node quantities and group
+/// capacities are tracked in flat arrays, so that solving a graph with E arcs
+/// takes O(E log E) time without any allocation per arc.
+///
+/// Because the most preferred arcs of the whole graph are matched first, a
+/// request group may be supplied by a contested supplier before a group that
+/// the GreedySolver would have visited earlier. The two solvers therefore
+/// generally find different (equally feasible) solutions.
+class PriorityGreedySolver: public GreedySolver {
+ public:
+  /// PriorityGreedySolver constructor
+  /// @param exclusive_orders a flag for enforcing integral, quantized orders
+  /// @param c a conditioner to use before solving a graph instance, which
+  /// orders request groups for breaking ties
+  /// @warning if a NULL pointer is passed as a conditioner argument,
+  /// conditioning will *NOT* occur
+  /// @{
+  PriorityGreedySolver();
+  explicit PriorityGreedySolver(bool exclusive_orders);
+  PriorityGreedySolver(bool exclusive_orders, GreedyPreconditioner* c);
+  /// @}
+
+  virtual ~PriorityGreedySolver() {}
+
+  /// @return a new PriorityGreedySolver with a copy of this solver's
+  /// conditioner
+  virtual ExchangeSolver* Clone() const;
+
+  /// @brief solves a graph by rounding a solution of its relaxation, e.g., of
+  /// the linear relaxation of the program ProgTranslator translates it to,
+  /// and repairing the result
+  ///
+  /// First, arcs with a positive relaxed value are matched in descending
+  /// order of that value, non-exclusive arcs (which are never fractional)
+  /// first and then ties broken as in the global matching order. A
+  /// non-exclusive arc is matched up to its relaxed flow and an exclusive
+  /// arc is rounded up to its exclusive quantity, both only as far as
+  /// capacities and request quantities that earlier arcs left allow.
+  /// Demand that is still unmet is then matched in the global order.
+  ///
+  /// @param graph the graph to solve
+  /// @param relaxed relaxed[i] is the relaxed value of graph->arcs()[i], its
+  /// flow for a non-exclusive arc or the fraction of its exclusive quantity
+  /// for an exclusive arc
+  /// @return the objective value of the repaired solution, like Solve
+  double Repair(ExchangeGraph* graph, const std::vector<double>& relaxed);
+
+ protected:
+  /// @brief the PriorityGreedySolver solves an ExchangeGraph by matching all
+  /// of its arcs in a global order of preference
+  virtual double SolveGraph();
+
+ private:
+  /// an arc's position in the global matching order
+  struct ArcKey {
+    double relaxed;
+    double pref;
+    int grp;
+    int node;
+    int uid;
+    int vid;
+    int arc;
+  };
+
+  /// orders ArcKeys by descending preference, then as documented above
+  static bool KeyComp(const ArcKey& l, const ArcKey& r);
+
+  /// orders ArcKeys by descending relaxed value, then like KeyComp
+  static bool RelaxedComp(const ArcKey& l, const ArcKey& r);
+
+  /// conditions graph_ and sets up flat_ and order_ for matching
+  void Start_();
+
+  /// @brief matches up to max_qty of arc a of flat_ given the matched
+  /// quantities of the request groups
+  void Match_(int a, double max_qty, std::vector<double>* grp_match);
+
+  /// adds the matched flows to graph_
+  /// @return the objective value given the matched quantities of the request
+  /// groups
+  double Finish_(const std::vector<double>& grp_match, double pseudo_cost);
+
+  std::vector<ArcKey> order_;
+
+  /// the matched flow of each arc and the arcs in the order they were first
+  /// matched
+  std::vector<double> flows_;
+  std::vector<int> matched_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_PRIORITY_GREEDY_SOLVER_H_
@@ -1,10 +1,14 @@
 #include "prog_solver.h"
 
+#include <map>
 #include <sstream>
 
+#include "CoinWarmStartBasis.hpp"
+
 #include "context.h"
 #include "prog_translator.h"
 #include "greedy_solver.h"
+#include "priority_greedy_solver.h"
 #include "solver_factory.h"
 
 namespace cyclus {
@@ -18,33 +22,64 @@ void Report(OsiSolverInterface* iface) {
 ProgSolver::ProgSolver(std::string solver_t)
     : solver_t_(solver_t),
       tmax_(ProgSolver::kDefaultTimeout),
+      budget_(-1),
       verbose_(false),
       mps_(false),
+      persistent_(false),
+      relax_(false),
+      finished_(true),
+      iface_(NULL),
       ExchangeSolver(false) {}
 
 ProgSolver::ProgSolver(std::string solver_t, bool exclusive_orders)
     : solver_t_(solver_t),
       tmax_(ProgSolver::kDefaultTimeout),
+      budget_(-1),
       verbose_(false),
       mps_(false),
+      persistent_(false),
+      relax_(false),
+      finished_(true),
+      iface_(NULL),
       ExchangeSolver(exclusive_orders) {}
 
 ProgSolver::ProgSolver(std::string solver_t, double tmax)
     : solver_t_(solver_t),
       tmax_(tmax),
+      budget_(-1),
       verbose_(false),
       mps_(false),
+      persistent_(false),
+      relax_(false),
+      finished_(true),
+      iface_(NULL),
       ExchangeSolver(false) {}
 
 ProgSolver::ProgSolver(std::string solver_t, double tmax, bool exclusive_orders,
                        bool verbose, bool mps)
     : solver_t_(solver_t),
       tmax_(tmax),
+      budget_(-1),
       verbose_(verbose),
       mps_(mps),
+      persistent_(false),
+      relax_(false),
+      finished_(true),
+      iface_(NULL),
       ExchangeSolver(exclusive_orders) {}
 
-ProgSolver::~ProgSolver() {}
+ProgSolver::~ProgSolver() {
+  delete iface_;
+}
+
+ExchangeSolver* ProgSolver::Clone() const {
+  ProgSolver* s =
+      new ProgSolver(solver_t_, tmax_, exclusive_orders_, verbose_, mps_);
+  s->persistent(persistent_);
+  s->relax(relax_);
+  s->budget(budget_);
+  return s;
+}
 
 void ProgSolver::WriteMPS() {
   std::stringstream ss;
@@ -53,8 +88,32 @@ void ProgSolver::WriteMPS() {
 }
 
 double ProgSolver::SolveGraph() {
-  SolverFactory sf(solver_t_, tmax_);
-  iface_ = sf.get();
+  if (!persistent_ || !component()) {
+    return SolveGraph_(persistent_);
+  }
+
+  // components differ from one solve to the next, so they are solved from
+  // scratch, leaving the persistent program of whole graphs untouched
+  OsiSolverInterface* kept = iface_;
+  iface_ = NULL;
+  double obj;
+  try {
+    obj = SolveGraph_(false);
+  } catch(...) {
+    iface_ = kept;
+    throw;
+  }
+  iface_ = kept;
+  return obj;
+}
+
+double ProgSolver::SolveGraph_(bool persist) {
+  bool warm = persist && iface_ != NULL;
+  if (!warm) {
+    SolverFactory sf(solver_t_, tmax_);
+    iface_ = sf.get();
+  }
+  double obj;
   try {
     // get greedy solution
     GreedySolver greedy(exclusive_orders_);
@@ -64,34 +123,134 @@ double ProgSolver::SolveGraph() {
     // translate graph to iface_ instance
     double pseudo_cost = PseudoCost(); // from ExchangeSolver API
     ProgTranslator xlator(graph_, iface_, exclusive_orders_, pseudo_cost);
-    xlator.ToProg();
+    xlator.pool(sim_ctx_ != NULL ? sim_ctx_->thread_pool() : NULL);
+    std::vector<double> x0;
+    if (!warm) {
+      xlator.ToProg();
+    } else {
+      xlator.Translate();
+      if (xlator.SameStructure(prev_)) {
+        xlator.Update(prev_);
+        x0 = prev_sol_;
+      } else {
+        Reload(&xlator, &x0);
+      }
+    }
     if (mps_)
       WriteMPS();
     
     // set noise level
-    CoinMessageHandler h;
-    h.setLogLevel(0);
+    handler_.setLogLevel(0);
     if (verbose_) {
       Report(iface_);
-      h.setLogLevel(4);
+      handler_.setLogLevel(4);
     }
-    iface_->passInMessageHandler(&h);
+    iface_->passInMessageHandler(&handler_);
     if (verbose_) {
       std::cout << "Solving problem, message handler has log level of "
                 << iface_->messageHandler()->logLevel() << "\n";
     }
         
     // solve and back translate
-    SolveProg(iface_, greedy_obj, verbose_);
+    if (relax_ && HasInt(iface_)) {
+      obj = SolveRelaxed(persist);
+    } else {
+      if (persist) {
+        finished_ = ResolveProg(iface_, greedy_obj, verbose_, x0, budget_);
+      } else {
+        finished_ = SolveProg(iface_, greedy_obj, verbose_, budget_);
+      }
+      xlator.FromProg();
+      obj = iface_->getObjValue();
+    }
 
-    xlator.FromProg();
+    if (persist) {
+      const double* sol = iface_->getColSolution();
+      prev_ = xlator.ctx();
+      prev_sol_.assign(sol, sol + iface_->getNumCols());
+    }
   } catch(...) {
     delete iface_;
+    iface_ = NULL;
     throw;
   }
-  double ret = iface_->getObjValue(); 
-  delete iface_;
-  return ret;
+  if (!persist) {
+    delete iface_;
+    iface_ = NULL;
+  }
+  return obj;
+}
+
+double ProgSolver::SolveRelaxed(bool persist) {
+  // the interface solves the linear relaxation, ignoring integrality
+  if (persist) {
+    iface_->resolve();
+  } else {
+    iface_->initialSolve();
+  }
+  finished_ = iface_->isProvenOptimal();
+
+  // arcs are the first columns of the program
+  const double* sol = iface_->getColSolution();
+  std::vector<double> relaxed(sol, sol + graph_->arcs().size());
+  PriorityGreedySolver rounder(exclusive_orders_);
+  return rounder.Repair(graph_, relaxed);
+}
+
+void ProgSolver::Reload(ProgTranslator* xlator, std::vector<double>* x0) {
+  CoinWarmStartBasis* prev_basis =
+      dynamic_cast<CoinWarmStartBasis*>(iface_->getWarmStart());
+  xlator->Populate();
+
+  const ProgTranslator::Context& ctx = xlator->ctx();
+  std::map<ProgColKey, int> prev_cols;
+  for (int i = 0; i != prev_.col_keys.size(); i++) {
+    prev_cols[prev_.col_keys[i]] = i;
+  }
+
+  // columns that are new start at their lower bound and rows are basic, as
+  // in a slack basis
+  int ncols = ctx.col_keys.size();
+  int nrows = ctx.row_lbs.size();
+  CoinWarmStartBasis basis;
+  basis.setSize(ncols, nrows);
+  for (int i = 0; i != nrows; i++) {
+    basis.setArtifStatus(i, CoinWarmStartBasis::basic);
+  }
+  x0->assign(ncols, 0);
+  std::vector<char> basic(ncols, 0);
+  for (int i = 0; i != ncols; i++) {
+    CoinWarmStartBasis::Status stat = CoinWarmStartBasis::atLowerBound;
+    std::map<ProgColKey, int>::iterator it = prev_cols.find(ctx.col_keys[i]);
+    if (it != prev_cols.end()) {
+      (*x0)[i] = prev_sol_[it->second];
+      if (prev_basis != NULL && it->second < prev_basis->getNumStructural()) {
+        stat = prev_basis->getStructStatus(it->second);
+      }
+    }
+    basic[i] = stat == CoinWarmStartBasis::basic;
+    basis.setStructStatus(i, stat == CoinWarmStartBasis::basic ?
+                          CoinWarmStartBasis::atLowerBound : stat);
+  }
+  delete prev_basis;
+
+  // every column that was basic takes the place of the slack of one of its
+  // rows, keeping the number of basic variables equal to the number of rows
+  const CoinPackedMatrix& m = ctx.m;
+  const int* ind = m.getIndices();
+  for (int i = 0; i != m.getMajorDim(); i++) {
+    int first = m.getVectorFirst(i);
+    for (int j = 0; j != m.getVectorSize(i); j++) {
+      int col = ind[first + j];
+      if (basic[col]) {
+        basic[col] = 0;
+        basis.setStructStatus(col, CoinWarmStartBasis::basic);
+        basis.setArtifStatus(i, CoinWarmStartBasis::atLowerBound);
+        break;
+      }
+    }
+  }
+  iface_->setWarmStart(&basis);
 }
 
 }  // namespace cyclus
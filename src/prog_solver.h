@@ -2,11 +2,13 @@
 #define CYCLUS_SRC_PROG_SOLVER_H_
 
 #include <string>
+#include <vector>
 
 #include "OsiSolverInterface.hpp"
 
 #include "exchange_graph.h"
 #include "exchange_solver.h"
+#include "prog_translator.h"
 
 namespace cyclus {
 
@@ -14,6 +16,23 @@ class ExchangeGraph;
 
 /// @brief The ProgSolver provides the implementation for a mathematical
 /// programming solution to a resource exchange graph.
+///
+/// A persistent ProgSolver keeps its solver interface, and the program it
+/// solved, from one solve to the next. If a graph translates to a program with
+/// the same structure as the previous one (see
+/// ProgTranslator::SameStructure), only the bounds and coefficients that
+/// changed are updated and the program is warm started from the previous
+/// basis and incumbent. Otherwise, the program is reloaded and warm started
+/// from the previous basis and incumbent of the columns whose keys (see
+/// ProgColKey) are still present. Components of decomposed graphs (see
+/// ExchangeSolver::decompose) are solved from scratch, as they differ from
+/// one solve to the next, and do not replace the kept program of whole
+/// graphs.
+///
+/// A relaxing ProgSolver does not branch on exclusive arcs. It solves the
+/// linear relaxation of the program and rounds and repairs its solution with
+/// PriorityGreedySolver::Repair, which is typically much faster for graphs
+/// with many exclusive arcs at the cost of optimality.
 class ProgSolver: public ExchangeSolver {
  public:
   static const int kDefaultTimeout = 5 * 60; // 5 * 60 s/min == 5 minutes
@@ -33,17 +52,67 @@ class ProgSolver: public ExchangeSolver {
   /// @}
   virtual ~ProgSolver();
 
+  /// @return a new ProgSolver with the same settings
+  virtual ExchangeSolver* Clone() const;
+
+  /// whether the solver interface persists between solves, default false
+  /// @{
+  inline void persistent(bool p) { persistent_ = p; }
+  inline bool persistent() const { return persistent_; }
+  /// @}
+
+  /// whether integer programs are relaxed and their solutions rounded,
+  /// default false
+  /// @{
+  inline void relax(bool r) { relax_ = r; }
+  inline bool relax() const { return relax_; }
+  /// @}
+
+  /// the wall-clock time in seconds after which the search of integer
+  /// programs is stopped, default none (negative). Without a budget, integer
+  /// programs are searched until an optimal solution is proven, whatever the
+  /// maximum solution time. Callers giving a budget must check finished().
+  /// @{
+  inline void budget(double b) { budget_ = b; }
+  inline double budget() const { return budget_; }
+  /// @}
+
+  /// @return false if the last solve ran out of time or budget before an
+  /// optimal solution was proven, in which case its matches may be
+  /// suboptimal or infeasible
+  inline bool finished() const { return finished_; }
+
  protected:
   /// @brief the ProgSolver solves an ExchangeGraph...
   virtual double SolveGraph();
   
  private:
   void WriteMPS();
-  
+
+  /// solves the graph, keeping the interface and program if persist is true
+  double SolveGraph_(bool persist);
+
+  /// solves the linear relaxation of the program in the interface and
+  /// matches the graph by rounding its solution, warm started if persist is
+  /// true
+  /// @return the objective value of the rounded solution
+  double SolveRelaxed(bool persist);
+
+  /// loads a program that is structurally different from the previous one
+  /// into the persistent interface, mapping the previous basis onto it and
+  /// the previous solution into x0
+  void Reload(ProgTranslator* xlator, std::vector<double>* x0);
+
   std::string solver_t_;
   double tmax_;
-  bool verbose_, mps_;
+  double budget_;
+  bool verbose_, mps_, persistent_, relax_, finished_;
   OsiSolverInterface* iface_;
+  CoinMessageHandler handler_;
+
+  /// the previously solved program and its solution, if persistent
+  ProgTranslator::Context prev_;
+  std::vector<double> prev_sol_;
 };
 
 }  // namespace cyclus
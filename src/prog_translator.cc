@@ -1,8 +1,11 @@
 #include "prog_translator.h"
 
 #include <algorithm>
+#include <functional>
+#include <map>
 
 #include "CoinPackedVector.hpp"
+#include "OsiClpSolverInterface.hpp"
 #include "OsiSolverInterface.hpp"
 
 #include "cyc_limits.h"
@@ -10,47 +13,72 @@
 #include "exchange_graph.h"
 #include "exchange_solver.h"
 #include "logger.h"
+#include "thread_pool.h"
 
 namespace cyclus {
 
+bool ProgColKey::operator<(const ProgColKey& other) const {
+  if (requester != other.requester) {
+    return requester < other.requester;
+  } else if (bidder != other.bidder) {
+    return bidder < other.bidder;
+  } else if (n != other.n) {
+    return n < other.n;
+  }
+  return commod < other.commod;
+}
+
+bool ProgColKey::operator==(const ProgColKey& other) const {
+  return requester == other.requester && bidder == other.bidder &&
+         n == other.n && commod == other.commod;
+}
+
 ProgTranslator::ProgTranslator(ExchangeGraph* g, OsiSolverInterface* iface)
     : g_(g),
+      fg_(g->flat()),
       iface_(iface),
       excl_(false),
-      pseudo_cost_(std::numeric_limits<double>::max()) {
+      pseudo_cost_(std::numeric_limits<double>::max()),
+      pool_(NULL) {
   Init();
 }
 
 ProgTranslator::ProgTranslator(ExchangeGraph* g, OsiSolverInterface* iface,
                                bool exclusive)
     : g_(g),
+      fg_(g->flat()),
       iface_(iface),
       excl_(exclusive),
-      pseudo_cost_(std::numeric_limits<double>::max()) {
+      pseudo_cost_(std::numeric_limits<double>::max()),
+      pool_(NULL) {
   Init();
 }
 
 ProgTranslator::ProgTranslator(ExchangeGraph* g, OsiSolverInterface* iface,
                                double pseudo_cost)
     : g_(g),
+      fg_(g->flat()),
       iface_(iface),
       excl_(false),
-      pseudo_cost_(pseudo_cost) {
+      pseudo_cost_(pseudo_cost),
+      pool_(NULL) {
   Init();
 }
 
 ProgTranslator::ProgTranslator(ExchangeGraph* g, OsiSolverInterface* iface,
                                bool exclusive, double pseudo_cost)
     : g_(g),
+      fg_(g->flat()),
       iface_(iface),
       excl_(exclusive),
-      pseudo_cost_(pseudo_cost) {
+      pseudo_cost_(pseudo_cost),
+      pool_(NULL) {
   Init();
 }
 
 void ProgTranslator::Init() {
-  arc_offset_ = g_->arcs().size();
-  int n_cols = arc_offset_ + g_->request_groups().size();
+  arc_offset_ = fg_->n_arcs();
+  int n_cols = arc_offset_ + fg_->n_req_groups();
   ctx_.obj_coeffs.resize(n_cols);
   ctx_.col_ubs.resize(n_cols);
   ctx_.col_lbs.resize(n_cols);
@@ -70,35 +98,245 @@ void ProgTranslator::CheckPref(double pref) {
 }
 
 void ProgTranslator::Translate() {
-  // number of variables = number of arcs + 1 faux arc per request group with arcs
-  int nfalse = 0;
-  std::vector<RequestGroup::Ptr>& rgs = g_->request_groups();
-  for (int i = 0; i != g_->request_groups().size(); ++i)
-    nfalse += rgs[i].get()->HasArcs() ? 1 : 0;
-  int n_cols = g_->arcs().size() + nfalse;
-  ctx_.m.setDimensions(0, n_cols);
+  TranslateCols_();
+
+  // rows are ordered by group, supply groups first, and each group's rows and
+  // elements are stored contiguously, so that groups can be filled
+  // independently once they have been sized
+  Assembly a;
+  for (int g = fg_->n_req_groups(); g != fg_->n_groups(); g++) {
+    a.grps.push_back(g);
+  }
+  for (int g = 0; g != fg_->n_req_groups(); g++) {
+    if (faux_[g] >= 0) {
+      a.grps.push_back(g);
+    }
+  }
+
+  int ngrps = a.grps.size();
+  a.row_begin.assign(ngrps + 1, 0);
+  a.el_begin.assign(ngrps + 1, 0);
+  for (int i = 0; i != ngrps; i++) {
+    int nrows;
+    int nels;
+    SizeGrp_(a.grps[i], &nrows, &nels);
+    a.row_begin[i + 1] = a.row_begin[i] + nrows;
+    a.el_begin[i + 1] = a.el_begin[i] + nels;
+  }
+
+  int nrows = a.row_begin[ngrps];
+  int nels = a.el_begin[ngrps];
+  a.starts.resize(nrows);
+  a.lens.resize(nrows);
+  a.ind.resize(nels);
+  a.els.resize(nels);
+  ctx_.row_lbs.resize(nrows);
+  ctx_.row_ubs.resize(nrows);
+
+  if (pool_ != NULL && ngrps > 1) {
+    pool_->ParallelFor(ngrps, std::bind(&ProgTranslator::FillGrp_, this, &a,
+                                        std::placeholders::_1));
+  } else {
+    for (int i = 0; i != ngrps; i++) {
+      FillGrp_(&a, i);
+    }
+  }
+
+  int ncols = ctx_.col_keys.size();
+  ctx_.m = CoinPackedMatrix(false, ncols, nrows, nels, a.els.data(),
+                            a.ind.data(), a.starts.data(), a.lens.data());
+  arc_offset_ = ncols;
+  TranslateFaux_();
+}
+
+void ProgTranslator::TranslateByRow() {
+  TranslateCols_();
+  ctx_.m.setDimensions(0, ctx_.col_keys.size());
 
   bool request;
-  std::vector<ExchangeNodeGroup::Ptr>& sgs = g_->supply_groups();
-  for (int i = 0; i != sgs.size(); i++) {
+  for (int i = fg_->n_req_groups(); i != fg_->n_groups(); i++) {
     request = false;
-    XlateGrp_(sgs[i].get(), request);
+    XlateGrp_(i, request);
   }
 
-  for (int i = 0; i != rgs.size(); i++) {
+  for (int i = 0; i != fg_->n_req_groups(); i++) {
     request = true;
-    XlateGrp_(rgs[i].get(), request);
+    XlateGrp_(i, request);
+  }
+
+  TranslateFaux_();
+}
+
+void ProgTranslator::TranslateCols_() {
+  // number of variables = number of arcs + 1 faux arc per request group with arcs
+  int n_cols = fg_->n_arcs();
+  std::vector<RequestGroup::Ptr>& rgs = g_->request_groups();
+  faux_.assign(rgs.size(), -1);
+  for (int i = 0; i != rgs.size(); ++i) {
+    if (rgs[i]->HasArcs()) {
+      faux_[i] = n_cols++;
+    }
+  }
+
+  ctx_.col_keys.resize(n_cols);
+  ctx_.col_ints.assign(n_cols, 0);
+  for (int i = 0; i != fg_->n_arcs(); i++) {
+    int u = fg_->unode(i);
+    ctx_.col_keys[i] = ProgColKey(fg_->agent_id(u),
+                                  fg_->agent_id(fg_->vnode(i)),
+                                  fg_->commod_id(u));
+    ctx_.col_ints[i] = excl_ && fg_->arc_exclusive(i);
   }
+  for (int i = 0; i != rgs.size(); ++i) {
+    if (faux_[i] >= 0) {
+      int n = fg_->node_begin(i);
+      ctx_.col_keys[faux_[i]] =
+          ProgColKey(fg_->agent_id(n), -1, fg_->commod_id(n));
+    }
+  }
+}
 
+void ProgTranslator::TranslateFaux_() {
   // add each false arc
-  CLOG(LEV_DEBUG1) << "Adding " << arc_offset_ - g_->arcs().size()
+  CLOG(LEV_DEBUG1) << "Adding " << arc_offset_ - fg_->n_arcs()
                    << " false arcs.";
   double inf = iface_->getInfinity();
-  for (int i = g_->arcs().size(); i != arc_offset_; i++) {
+  for (int i = fg_->n_arcs(); i != arc_offset_; i++) {
     ctx_.obj_coeffs[i] = pseudo_cost_;
     ctx_.col_lbs[i] = 0;
     ctx_.col_ubs[i] = inf;
   }
+
+  // number columns with equal keys
+  std::map<ProgColKey, int> nkeys;
+  for (int i = 0; i != ctx_.col_keys.size(); i++) {
+    ctx_.col_keys[i].n = nkeys[ctx_.col_keys[i]]++;
+  }
+}
+
+void ProgTranslator::SizeGrp_(int g, int* nrows, int* nels) {
+  bool request = fg_->request(g);
+  int ncaps = fg_->n_caps(g);
+  *nrows = ncaps;
+  *nels = request ? ncaps : 0;  // faux arc
+  for (int n = fg_->node_begin(g); n != fg_->node_end(g); n++) {
+    const int* arcs = fg_->node_arcs(n);
+    for (int k = 0; k != fg_->n_node_arcs(n); k++) {
+      *nels += std::min(NUnitCaps_(n, arcs[k]), ncaps);
+    }
+  }
+
+  if (excl_) {
+    for (int e = fg_->excl_begin(g); e != fg_->excl_end(g); e++) {
+      int nexcl = NExclArcs_(e);
+      *nrows += nexcl > 0 ? 1 : 0;
+      *nels += nexcl;
+    }
+  }
+}
+
+void ProgTranslator::FillGrp_(Assembly* a, int i) {
+  int g = a->grps[i];
+  int row = a->row_begin[i];
+  int el = a->el_begin[i];
+  bool request = fg_->request(g);
+  double inf = iface_->getInfinity();
+  const double* caps = fg_->capacities().data() + fg_->cap_begin(g);
+  int ncaps = fg_->n_caps(g);
+
+  // capacity rows
+  std::vector<int> next(ncaps, 0);
+  for (int n = fg_->node_begin(g); n != fg_->node_end(g); n++) {
+    const int* arcs = fg_->node_arcs(n);
+    for (int k = 0; k != fg_->n_node_arcs(n); k++) {
+      int nucaps = std::min(NUnitCaps_(n, arcs[k]), ncaps);
+      for (int j = 0; j != nucaps; j++) {
+        next[j]++;
+      }
+    }
+  }
+  for (int j = 0; j != ncaps; j++) {
+    int len = next[j] + (request ? 1 : 0);
+    a->starts[row + j] = el;
+    a->lens[row + j] = len;
+    next[j] = el;
+    el += len;
+  }
+
+  for (int n = fg_->node_begin(g); n != fg_->node_end(g); n++) {
+    const int* arcs = fg_->node_arcs(n);
+    for (int k = 0; k != fg_->n_node_arcs(n); k++) {
+      int arc_id = arcs[k];
+      bool unode = fg_->unode(arc_id) == n;
+      const double* ucaps = unode ? fg_->ucaps(arc_id) : fg_->vcaps(arc_id);
+      int nucaps = std::min(NUnitCaps_(n, arc_id), ncaps);
+      bool excl = excl_ && fg_->arc_exclusive(arc_id);
+      double factor = excl ? fg_->excl_val(arc_id) : 1;
+      for (int j = 0; j != nucaps; j++) {
+        a->ind[next[j]] = arc_id;
+        a->els[next[j]++] = ucaps[j] * factor;
+      }
+
+      if (request) {
+        CheckPref(fg_->pref(arc_id));
+        ctx_.obj_coeffs[arc_id] = ExchangeSolver::Cost(fg_->arc(arc_id), excl_);
+        ctx_.col_lbs[arc_id] = 0;
+        ctx_.col_ubs[arc_id] = excl ? 1 : std::min(fg_->qty(n), inf);
+      }
+    }
+  }
+
+  for (int j = 0; j != ncaps; j++) {
+    if (request) {
+      a->ind[next[j]] = faux_[g];
+      a->els[next[j]] = 1.0;
+    }
+
+    // 1e15 is the largest value that doesn't make the solver fall over
+    // (by emperical testing)
+    ctx_.row_lbs[row + j] = request ? std::min(caps[j], 1e15) : 0;
+    ctx_.row_ubs[row + j] = request ? inf : caps[j];
+  }
+  row += ncaps;
+
+  if (!excl_) {
+    return;
+  }
+
+  // exclusive rows
+  for (int e = fg_->excl_begin(g); e != fg_->excl_end(g); e++) {
+    int nexcl = NExclArcs_(e);
+    if (nexcl == 0) {
+      continue;
+    }
+
+    a->starts[row] = el;
+    a->lens[row] = nexcl;
+    const int* nodes = fg_->excl_nodes(e);
+    for (int j = 0; j != fg_->n_excl_nodes(e); j++) {
+      const int* arcs = fg_->node_arcs(nodes[j]);
+      for (int k = 0; k != fg_->n_node_arcs(nodes[j]); k++) {
+        a->ind[el] = arcs[k];
+        a->els[el++] = 1.0;
+      }
+    }
+    ctx_.row_lbs[row] = 0.0;
+    ctx_.row_ubs[row] = 1.0;
+    row++;
+  }
+}
+
+int ProgTranslator::NUnitCaps_(int n, int arc_id) const {
+  return fg_->unode(arc_id) == n ? fg_->n_ucaps(arc_id) : fg_->n_vcaps(arc_id);
+}
+
+int ProgTranslator::NExclArcs_(int e) const {
+  int narcs = 0;
+  const int* nodes = fg_->excl_nodes(e);
+  for (int j = 0; j != fg_->n_excl_nodes(e); j++) {
+    narcs += fg_->n_node_arcs(nodes[j]);
+  }
+  return narcs;
 }
 
 void ProgTranslator::Populate() {
@@ -109,16 +347,11 @@ void ProgTranslator::Populate() {
                       &ctx_.obj_coeffs[0], &ctx_.row_lbs[0], &ctx_.row_ubs[0]);
 
   
-  if (excl_) {
-    std::vector<Arc>& arcs = g_->arcs();
-    for (int i = 0; i != arcs.size(); i++) {
-      Arc& a = arcs[i];
-      if (a.exclusive()) {
-        iface_->setInteger(g_->arc_ids()[a]);
-      }
+  for (int i = 0; i != ctx_.col_ints.size(); i++) {
+    if (ctx_.col_ints[i]) {
+      iface_->setInteger(i);
     }
   }
-
 }
 
 void ProgTranslator::ToProg() {
@@ -126,46 +359,105 @@ void ProgTranslator::ToProg() {
   Populate();
 }
 
-void ProgTranslator::XlateGrp_(ExchangeNodeGroup* grp, bool request) {
+bool ProgTranslator::SameStructure(const Context& prev) const {
+  const CoinPackedMatrix& m = ctx_.m;
+  const CoinPackedMatrix& pm = prev.m;
+  if (ctx_.col_keys != prev.col_keys || ctx_.col_ints != prev.col_ints ||
+      m.getMajorDim() != pm.getMajorDim() ||
+      m.getNumElements() != pm.getNumElements()) {
+    return false;
+  }
+
+  const int* ind = m.getIndices();
+  const int* pind = pm.getIndices();
+  for (int i = 0; i != m.getMajorDim(); i++) {
+    int n = m.getVectorSize(i);
+    if (n != pm.getVectorSize(i) ||
+        !std::equal(ind + m.getVectorFirst(i), ind + m.getVectorFirst(i) + n,
+                    pind + pm.getVectorFirst(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ProgTranslator::Update(const Context& prev) {
+  for (int i = 0; i != ctx_.col_keys.size(); i++) {
+    if (ctx_.obj_coeffs[i] != prev.obj_coeffs[i]) {
+      iface_->setObjCoeff(i, ctx_.obj_coeffs[i]);
+    }
+    if (ctx_.col_lbs[i] != prev.col_lbs[i] ||
+        ctx_.col_ubs[i] != prev.col_ubs[i]) {
+      iface_->setColBounds(i, ctx_.col_lbs[i], ctx_.col_ubs[i]);
+    }
+  }
+
+  for (int i = 0; i != ctx_.row_lbs.size(); i++) {
+    if (ctx_.row_lbs[i] != prev.row_lbs[i] ||
+        ctx_.row_ubs[i] != prev.row_ubs[i]) {
+      iface_->setRowBounds(i, ctx_.row_lbs[i], ctx_.row_ubs[i]);
+    }
+  }
+
+  // the generic interface has no way of changing single coefficients
+  OsiClpSolverInterface* clp = dynamic_cast<OsiClpSolverInterface*>(iface_);
+  const int* ind = ctx_.m.getIndices();
+  const double* el = ctx_.m.getElements();
+  const double* pel = prev.m.getElements();
+  for (int i = 0; i != ctx_.m.getMajorDim(); i++) {
+    int first = ctx_.m.getVectorFirst(i);
+    int pfirst = prev.m.getVectorFirst(i);
+    for (int j = 0; j != ctx_.m.getVectorSize(i); j++) {
+      if (el[first + j] == pel[pfirst + j]) {
+        continue;
+      } else if (clp == NULL) {
+        throw StateError("Only Clp interfaces can be updated in place");
+      }
+      clp->modifyCoefficient(i, ind[first + j], el[first + j]);
+    }
+  }
+}
+
+void ProgTranslator::XlateGrp_(int g, bool request) {
   double inf = iface_->getInfinity();
-  std::vector<double>& caps = grp->capacities();
+  const double* caps = fg_->capacities().data() + fg_->cap_begin(g);
+  int ncaps = fg_->n_caps(g);
 
-  if (request && !grp->HasArcs())
+  if (request && !g_->request_groups()[g]->HasArcs())
     return; // no arcs, no reason to add variables/constraints
   
   std::vector<CoinPackedVector> cap_rows;
   std::vector<CoinPackedVector> excl_rows;
-  for (int i = 0; i != caps.size(); i++) {
+  for (int i = 0; i != ncaps; i++) {
     cap_rows.push_back(CoinPackedVector());
   }
 
-  std::vector<ExchangeNode::Ptr>& nodes = grp->nodes();
-  for (int i = 0; i != nodes.size(); i++) {
-    std::map<Arc, std::vector<double> >& ucap_map = nodes[i]->unit_capacities;
-    std::map<Arc, std::vector<double> >::iterator cap_it;
+  for (int n = fg_->node_begin(g); n != fg_->node_end(g); n++) {
+    const int* arcs = fg_->node_arcs(n);
 
     // add each arc
-    for (cap_it = ucap_map.begin(); cap_it != ucap_map.end(); ++cap_it) {
-      const Arc& a = cap_it->first;
-      std::vector<double>& ucaps = cap_it->second;
-      int arc_id = g_->arc_ids()[a];
+    for (int k = 0; k != fg_->n_node_arcs(n); k++) {
+      int arc_id = arcs[k];
+      bool unode = fg_->unode(arc_id) == n;
+      const double* ucaps = unode ? fg_->ucaps(arc_id) : fg_->vcaps(arc_id);
+      int nucaps = unode ? fg_->n_ucaps(arc_id) : fg_->n_vcaps(arc_id);
+      bool excl = excl_ && fg_->arc_exclusive(arc_id);
 
       // add each unit capacity coefficient
-      for (int j = 0; j != ucaps.size(); j++) {
+      for (int j = 0; j != nucaps; j++) {
         double coeff = ucaps[j];
-        if (excl_ && a.exclusive()) {
-          coeff *= a.excl_val();
+        if (excl) {
+          coeff *= fg_->excl_val(arc_id);
         }
 
         cap_rows[j].insert(arc_id, coeff);
       }
 
       if (request) {
-        CheckPref(a.pref());
-        ctx_.obj_coeffs[arc_id] = ExchangeSolver::Cost(a, excl_);
+        CheckPref(fg_->pref(arc_id));
+        ctx_.obj_coeffs[arc_id] = ExchangeSolver::Cost(fg_->arc(arc_id), excl_);
         ctx_.col_lbs[arc_id] = 0;
-        ctx_.col_ubs[arc_id] = (excl_ && a.exclusive()) ? 1 :
-                               std::min(nodes[i]->qty, inf);
+        ctx_.col_ubs[arc_id] = excl ? 1 : std::min(fg_->qty(n), inf);
       }
     }
   }
@@ -191,15 +483,13 @@ void ProgTranslator::XlateGrp_(ExchangeNodeGroup* grp, bool request) {
 
   if (excl_) {
     // add exclusive arcs
-    std::vector< std::vector<ExchangeNode::Ptr> >& exngs =
-        grp->excl_node_groups();
-    for (int i = 0; i != exngs.size(); i++) {
+    for (int e = fg_->excl_begin(g); e != fg_->excl_end(g); e++) {
       CoinPackedVector excl_row;
-      std::vector<ExchangeNode::Ptr>& nodes = exngs[i];
-      for (int j = 0; j != nodes.size(); j++) {
-        std::vector<Arc>& arcs = g_->node_arc_map()[nodes[j]];
-        for (int k = 0; k != arcs.size(); k++) {
-          excl_row.insert(g_->arc_ids()[arcs[k]], 1.0);
+      const int* nodes = fg_->excl_nodes(e);
+      for (int j = 0; j != fg_->n_excl_nodes(e); j++) {
+        const int* arcs = fg_->node_arcs(nodes[j]);
+        for (int k = 0; k != fg_->n_node_arcs(nodes[j]); k++) {
+          excl_row.insert(arcs[k], 1.0);
         }
       }
       if (excl_row.getNumElements() > 0) {
@@ -218,14 +508,12 @@ void ProgTranslator::XlateGrp_(ExchangeNodeGroup* grp, bool request) {
 
 void ProgTranslator::FromProg() {
   const double* sol = iface_->getColSolution();
-  std::vector<Arc>& arcs = g_->arcs();
   double flow;
-  for (int i = 0; i < arcs.size(); i++) {
-    Arc& a = g_->arc_by_id().at(i);
+  for (int i = 0; i < fg_->n_arcs(); i++) {
     flow = sol[i];
-    flow = (excl_ && a.exclusive()) ? flow * a.excl_val() : flow;
+    flow = (excl_ && fg_->arc_exclusive(i)) ? flow * fg_->excl_val(i) : flow;
     if (flow > cyclus::eps()) {
-      g_->AddMatch(a, flow);
+      g_->AddMatch(fg_->arc(i), flow);
     }
   }
 }
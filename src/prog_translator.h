@@ -1,16 +1,41 @@
 #ifndef CYCLUS_SRC_PROG_TRANSLATOR_H_
 #define CYCLUS_SRC_PROG_TRANSLATOR_H_
 
+#include <string>
 #include <vector>
 
 #include "CoinPackedMatrix.hpp"
 
+#include "flat_exchange_graph.h"
+
 class OsiSolverInterface;
 
 namespace cyclus {
 
-class ExchangeGraph;
-class ExchangeNodeGroup;
+class ThreadPool;
+
+
+/// @brief identifies a column of a program across timesteps by the agent ids
+/// of the requester and bidder of its arc and the id of the requested
+/// commodity (see ExchangeNode::commod_id). Faux arcs have a bidder of -1.
+/// Columns with otherwise equal keys are numbered by n in the order they
+/// appear in the program.
+struct ProgColKey {
+  ProgColKey() : requester(-1), bidder(-1), commod(-1), n(0) {}
+  ProgColKey(int requester, int bidder, int commod)
+      : requester(requester), bidder(bidder), commod(commod), n(0) {}
+
+  bool operator<(const ProgColKey& other) const;
+  bool operator==(const ProgColKey& other) const;
+  inline bool operator!=(const ProgColKey& other) const {
+    return !(*this == other);
+  }
+
+  int requester;
+  int bidder;
+  int commod;
+  int n;
+};
 
 /// @brief struct to hold all problem instance state
 struct ProgTranslatorContext {
@@ -19,6 +44,10 @@ struct ProgTranslatorContext {
   std::vector<double> row_lbs;
   std::vector<double> col_ubs;
   std::vector<double> col_lbs;
+  /// the key of each column
+  std::vector<ProgColKey> col_keys;
+  /// whether each column is integer-valued
+  std::vector<char> col_ints;
   CoinPackedMatrix m;
 };
 
@@ -51,9 +80,21 @@ class ProgTranslator {
   ProgTranslator(ExchangeGraph* g, OsiSolverInterface* iface,
                  bool exclusive, double pseudo_cost);
 
-  /// @brief translates the graph, filling the translators Context
+  /// @brief translates the graph, filling the translators Context. All rows,
+  /// columns, and matrix elements are sized up front and the matrix is
+  /// assembled from a single row-ordered buffer, group by group (concurrently
+  /// if a thread pool is set).
   void Translate();
 
+  /// @brief translates the graph like Translate, but appends the matrix one
+  /// row at a time. It produces the same program and is kept as a reference
+  /// for testing and benchmarking.
+  void TranslateByRow();
+
+  /// @brief sets a thread pool used to translate groups concurrently, or NULL
+  /// to translate serially (the default)
+  inline void pool(ThreadPool* p) { pool_ = p; }
+
   /// @brief populates the solver interface with values from the translators
   /// Context
   void Populate();
@@ -62,6 +103,20 @@ class ProgTranslator {
   /// equivalent to calling Translate(), then Populate().
   void ToProg();
 
+  /// @return true if the translated program has the same columns (by key),
+  /// integer columns, rows, and matrix sparsity pattern as prev
+  bool SameStructure(const Context& prev) const;
+
+  /// @brief updates the solver interface, which must hold the program
+  /// translated into prev, to the translated program by changing only the
+  /// bounds and coefficients that differ. The program must have the same
+  /// structure as prev (see SameStructure). The interface keeps its basis, so
+  /// that it can be warm started.
+  ///
+  /// @throws StateError if coefficients differ and the interface is not a Clp
+  /// interface
+  void Update(const Context& prev);
+
   /// @brief translates solution from iface back into graph matches
   void FromProg();
 
@@ -73,17 +128,55 @@ class ProgTranslator {
   /// @throws if preference is unsatisfactory (i.e., not greater than 0)
   void CheckPref(double pref);
   
+  /// @brief the matrix buffer and the position of each group's rows and
+  /// elements in it
+  struct Assembly {
+    /// group indices, in row order
+    std::vector<int> grps;
+    /// rows and elements of the i'th group start at row_begin[i] and
+    /// el_begin[i]
+    std::vector<int> row_begin;
+    std::vector<int> el_begin;
+    std::vector<CoinBigIndex> starts;
+    std::vector<int> lens;
+    std::vector<int> ind;
+    std::vector<double> els;
+  };
+
+  /// keys all columns and numbers the faux arc columns
+  void TranslateCols_();
+
+  /// sets the bounds and costs of faux arcs and numbers equal column keys
+  void TranslateFaux_();
+
+  /// computes the number of rows and matrix elements of a group
+  void SizeGrp_(int g, int* nrows, int* nels);
+
+  /// fills the rows and elements of the i'th group of an assembly, as well as
+  /// the bounds and costs of the arcs of request groups
+  void FillGrp_(Assembly* a, int i);
+
+  /// @return the number of unit capacities node n has for an arc
+  int NUnitCaps_(int n, int arc_id) const;
+
+  /// @return the number of arcs of the nodes of exclusive node group e
+  int NExclArcs_(int e) const;
+
   /// perform all translation for a node group
-  /// @param grp a pointer to the node group
+  /// @param g the index of the node group in fg_
   /// @param req a boolean flag, true if grp is a request group
-  void XlateGrp_(ExchangeNodeGroup* grp, bool req);
+  void XlateGrp_(int g, bool req);
 
   ExchangeGraph* g_;
+  boost::shared_ptr<FlatExchangeGraph> fg_;
   OsiSolverInterface* iface_;
   bool excl_;
   int arc_offset_;
   ProgTranslator::Context ctx_;
   double pseudo_cost_;
+  ThreadPool* pool_;
+  /// the faux arc column of each request group, or -1 if it has no arcs
+  std::vector<int> faux_;
 };
 
 }  // namespace cyclus
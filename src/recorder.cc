@@ -10,6 +10,9 @@
 
 namespace cyclus {
 
+// buffer that Datum objects created on this thread are deferred into
+static thread_local DatumList* deferred_data = NULL;
+
 Recorder::Recorder() : index_(0), inject_sim_id_(true) {
   uuid_ = boost::uuids::random_generator()();
   set_dump_count(kDefaultDumpCount);
@@ -67,6 +70,15 @@ void Recorder::set_dump_count(unsigned int count) {
 }
 
 Datum* Recorder::NewDatum(std::string title) {
+  if (deferred_data != NULL) {
+    Datum* d = new Datum(this, title);
+    if (inject_sim_id_) {
+      d->AddVal("SimId", uuid_);
+    }
+    deferred_data->push_back(d);
+    return d;
+  }
+
   Datum* d = data_[index_];
   d->title_ = title;
   if (inject_sim_id_) {
@@ -82,6 +94,9 @@ Datum* Recorder::NewDatum(std::string title) {
 }
 
 void Recorder::AddDatum(Datum* d) {
+  if (deferred_data != NULL) {
+    return;  // deferred data reaches backends via CommitDeferred
+  }
   if (index_ >= data_.size()) {
     NotifyBackends();
   }
@@ -100,6 +115,26 @@ void Recorder::Flush() {
   }
 }
 
+void Recorder::BeginDeferred(DatumList* buf) {
+  deferred_data = buf;
+}
+
+void Recorder::EndDeferred() {
+  deferred_data = NULL;
+}
+
+void Recorder::CommitDeferred(DatumList* buf) {
+  for (int i = 0; i < buf->size(); ++i) {
+    Datum* src = (*buf)[i];
+    Datum* d = NewDatum(src->title_);
+    d->vals_ = src->vals_;
+    d->shapes_ = src->shapes_;
+    AddDatum(d);
+    delete src;
+  }
+  buf->clear();
+}
+
 void Recorder::NotifyBackends() {
   index_ = 0;
   std::list<RecBackend*>::iterator it;
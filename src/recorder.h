@@ -110,6 +110,22 @@ class Recorder {
   /// Flushes all buffered Datum objects and flushes all registered backends.
   void Flush();
 
+  /// Redirects all Datum objects created via NewDatum on the calling thread
+  /// into buf until EndDeferred is called on the same thread. Deferred Datum
+  /// objects are not seen by backends until they are passed to
+  /// CommitDeferred. This allows agents running concurrently to record data
+  /// while the order in which their data reaches the backends stays
+  /// deterministic.
+  void BeginDeferred(DatumList* buf);
+
+  /// Stops redirecting Datum objects created on the calling thread.
+  void EndDeferred();
+
+  /// Records all Datum objects in buf (in order) as if they had been created
+  /// and recorded right now, and clears buf. This must not be called while
+  /// the calling thread is deferring.
+  void CommitDeferred(DatumList* buf);
+
   /// Flushes all buffered Datum objects and flushes all registered backends.
   /// Unregisters all backends and resets.
   void Close();
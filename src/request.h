@@ -64,7 +64,14 @@ class Request {
   inline Trader* requester() const { return requester_; }
 
   /// @return the commodity associated with this request
-  inline std::string commodity() const { return commodity_; }
+  inline const std::string& commodity() const { return commodity_; }
+
+  /// @return the interned id of the request's commodity (see CommodityTable),
+  /// which is set when the request is added to an exchange context, or -1
+  inline int commod_id() const { return commod_id_; }
+
+  /// @brief sets the interned id of the request's commodity
+  inline void commod_id(int id) { commod_id_ = id; }
 
   /// @return the preference value for this request
   inline double preference() const { return preference_; }
@@ -78,6 +85,9 @@ class Request {
   inline bool exclusive() const { return exclusive_; }
 
  private:
+  /// portfolios construct their own in place
+  friend class RequestPortfolio<T>;
+
   /// @brief constructors are private to require use of factory methods
   Request(boost::shared_ptr<T> target, Trader* requester,
           std::string commodity = "", double preference = kDefaultPref,
@@ -85,6 +95,7 @@ class Request {
       : target_(target),
         requester_(requester),
         commodity_(commodity),
+        commod_id_(-1),
         preference_(preference),
         exclusive_(exclusive) {}
 
@@ -95,6 +106,7 @@ class Request {
       : target_(target),
         requester_(requester),
         commodity_(commodity),
+        commod_id_(-1),
         preference_(preference),
         portfolio_(portfolio),
         exclusive_(exclusive) {}
@@ -103,6 +115,7 @@ class Request {
   Trader* requester_;
   double preference_;
   std::string commodity_;
+  int commod_id_;
   boost::weak_ptr<RequestPortfolio<T> > portfolio_;
   bool exclusive_;
 };
@@ -1,6 +1,7 @@
 #ifndef CYCLUS_SRC_REQUEST_PORTFOLIO_H_
 #define CYCLUS_SRC_REQUEST_PORTFOLIO_H_
 
+#include <new>
 #include <numeric>
 #include <set>
 #include <string>
@@ -9,6 +10,7 @@
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/shared_ptr.hpp>
 
+#include "arena.h"
 #include "capacity_constraint.h"
 #include "error.h"
 #include "logger.h"
@@ -90,11 +92,11 @@ public boost::enable_shared_from_this< RequestPortfolio<T> > {
 
   RequestPortfolio() : requester_(NULL), qty_(0) {}
 
-  /// deletes all requests associated with it
+  /// destroys all requests associated with it
   ~RequestPortfolio() {
     typename std::vector<Request<T>*>::iterator it;
     for (it = requests_.begin(); it != requests_.end(); ++it) {
-      delete *it;
+      (*it)->~Request<T>();
     }
   }
 
@@ -112,10 +114,11 @@ public boost::enable_shared_from_this< RequestPortfolio<T> > {
                          std::string commodity = "",
                          double preference = kDefaultPref,
                          bool exclusive = false) {
-    Request<T>* r =
-        Request<T>::Create(target, requester, this->shared_from_this(),
-                           commodity, preference, exclusive);
-    VerifyRequester_(r);
+    VerifyRequester_(requester);
+    void* mem = arena_.Allocate(sizeof(Request<T>), alignof(Request<T>));
+    Request<T>* r = new (mem) Request<T>(target, requester,
+                                         this->shared_from_this(), commodity,
+                                         preference, exclusive);
     requests_.push_back(r);
     mass_coeffs_[r] = 1;
     qty_ += target->quantity();
@@ -190,15 +193,18 @@ public boost::enable_shared_from_this< RequestPortfolio<T> > {
   /// requester
   /// @throws KeyError if a request is added from a different requester than the
   /// original
-  void VerifyRequester_(const Request<T>* r) {
+  void VerifyRequester_(Trader* requester) {
     if (requester_ == NULL) {
-      requester_ = r->requester();
-    } else if (requester_ != r->requester()) {
+      requester_ = requester;
+    } else if (requester_ != requester) {
       std::string msg = "Insertion error: requesters do not match.";
       throw KeyError(msg);
     }
   }
 
+  /// the memory of the requests
+  Arena arena_;
+
   /// requests_ is a vector because many requests may be identical, i.e., a set
   /// is not appropriate
   std::vector<Request<T>*> requests_;
@@ -3,14 +3,20 @@
 
 #include <algorithm>
 #include <functional>
+#include <map>
 #include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "bid_portfolio.h"
 #include "context.h"
 #include "exchange_context.h"
 #include "product.h"
 #include "material.h"
+#include "recorder.h"
 #include "request_portfolio.h"
+#include "thread_pool.h"
 #include "trader.h"
 #include "trader_management.h"
 
@@ -19,17 +25,19 @@ namespace cyclus {
 /// @brief Preference adjustment method helpers to convert from templates to the
 /// Agent inheritance hierarchy
 template<class T>
-inline static void AdjustPrefs(Agent* m, typename PrefMap<T>::type& prefs) {}
-inline static void AdjustPrefs(Agent* m, PrefMap<Material>::type& prefs) {
+inline static void AdjustPrefs(Agent* m, std::vector<PrefView<T> >& prefs) {}
+inline static void AdjustPrefs(Agent* m, PrefBatch<Material>::type& prefs) {
   m->AdjustMatlPrefs(prefs);
 }
-inline static void AdjustPrefs(Agent* m, PrefMap<Product>::type& prefs) {
+inline static void AdjustPrefs(Agent* m, PrefBatch<Product>::type& prefs) {
   m->AdjustProductPrefs(prefs);
 }
-inline static void AdjustPrefs(Trader* t, PrefMap<Material>::type& prefs) {
+template<class T>
+inline static void AdjustPrefs(Trader* t, PrefView<T>& prefs) {}
+inline static void AdjustPrefs(Trader* t, PrefView<Material>& prefs) {
   t->AdjustMatlPrefs(prefs);
 }
-inline static void AdjustPrefs(Trader* t, PrefMap<Product>::type& prefs) {
+inline static void AdjustPrefs(Trader* t, PrefView<Product>& prefs) {
   t->AdjustProductPrefs(prefs);
 }
 
@@ -57,13 +65,31 @@ inline static void AdjustPrefs(Trader* t, PrefMap<Product>::type& prefs) {
 /// exchng.AddAllBids();
 /// exchng.AdjustAll();
 /// @endcode
+///
+/// If the simulation runs with more than one thread (see SimInfo::threads),
+/// traders whose managers' archetypes are annotated as thread-safe are queried
+/// for their requests and bids concurrently. Their portfolios and any data
+/// they record are buffered per trader and added to the exchange context in
+/// trader id order, interleaved with the serially queried traders, so that
+/// the exchange context and the output are identical to those of a serial
+/// run. Thread-safe traders must therefore only read the exchange's commodity
+/// request map when bidding (e.g. using find rather than operator[]), and
+/// must not create resources or compositions while they are queried, because
+/// their ids are allocated from unsynchronized global counters. The targets
+/// and offers of their portfolios must be built beforehand, e.g. when they
+/// are constructed or while trades are executed, which is always serial.
+///
+/// Traders that memoize their portfolios (see Trader::MemoizesPortfolios) and
+/// declare them unchanged since the last exchange (see
+/// Trader::MatlRequestsUnchanged and Trader::MatlBidsUnchanged) are not
+/// queried again; the portfolios they last returned are reused instead.
 template <class T>
 class ResourceExchange {
  public:
   /// @brief default constructor
   ///
   /// @param ctx the simulation context
-  ResourceExchange(Context* ctx) {
+  ResourceExchange(Context* ctx) : ex_ctx_(&ctx->commodities()) {
     sim_ctx_ = ctx;
   }
 
@@ -73,34 +99,69 @@ class ResourceExchange {
 
   /// @brief queries traders and collects all requests for bids
   void AddAllRequests() {
-    InitTraders();
+    if (sim_ctx_->thread_pool() != NULL) {
+      AddAllConcurrent_(&ResourceExchange<T>::QueryRequests_);
+      return;
+    }
+
+    const TraderRegistry& traders = sim_ctx_->traders();
     std::for_each(
-        traders_.begin(),
-        traders_.end(),
+        traders.begin(),
+        traders.end(),
         std::bind1st(std::mem_fun(&cyclus::ResourceExchange<T>::AddRequests_),
                      this));
   }
 
   /// @brief queries traders and collects all responses to requests for bids
   void AddAllBids() {
-    InitTraders();
+    FindReused_();
+    if (sim_ctx_->thread_pool() != NULL) {
+      AddAllConcurrent_(&ResourceExchange<T>::QueryBids_);
+      return;
+    }
+
+    const TraderRegistry& traders = sim_ctx_->traders();
     std::for_each(
-        traders_.begin(),
-        traders_.end(),
+        traders.begin(),
+        traders.end(),
         std::bind1st(std::mem_fun(&cyclus::ResourceExchange<T>::AddBids_),
                      this));
   }
 
   /// @brief adjust preferences for requests given bid responses
+  ///
+  /// Each requester adjusts its own preferences. Then each of their ancestors
+  /// (e.g., institutions and regions) is called once with the preferences of
+  /// all of its descending requesters, deeper ancestors before shallower ones
+  /// (and by agent id for equal depths), so that the preferences of a
+  /// requester are adjusted by its parent before its grandparent.
   void AdjustAll() {
-    InitTraders();
-    std::set<Trader*> traders = ex_ctx_.requesters;
-    std::for_each(
-        traders.begin(),
-        traders.end(),
-        std::bind1st(
-            std::mem_fun(&cyclus::ResourceExchange<T>::AdjustPrefs_),
-            this));
+    // batches of ancestors, keyed by (-depth, id)
+    std::map<std::pair<int, int>, AncestorBatch> batches;
+    std::vector<Agent*> chain;
+    std::set<Trader*>::iterator it;
+    for (it = ex_ctx_.requesters.begin(); it != ex_ctx_.requesters.end();
+         ++it) {
+      PrefView<T> view = ex_ctx_.prefs.View(*it);
+      AdjustPrefs(*it, view);
+
+      chain.clear();
+      for (Agent* m = (*it)->manager()->parent(); m != NULL; m = m->parent()) {
+        chain.push_back(m);
+      }
+      for (int i = 0; i < chain.size(); ++i) {
+        std::pair<int, int> key(i + 1 - static_cast<int>(chain.size()),
+                                chain[i]->id());
+        AncestorBatch& b = batches[key];
+        b.agent = chain[i];
+        b.prefs.push_back(view);
+      }
+    }
+
+    typename std::map<std::pair<int, int>, AncestorBatch>::iterator bit;
+    for (bit = batches.begin(); bit != batches.end(); ++bit) {
+      AdjustPrefs(bit->second.agent, bit->second.prefs);
+    }
   }
 
   /// return true if this is an empty exchange (i.e., no requests exist,
@@ -108,67 +169,226 @@ class ResourceExchange {
   inline bool Empty() { return ex_ctx_.bids_by_request.empty(); }
 
  private:
-  void InitTraders() {
-    if (traders_.size() == 0) {
-      std::set<Trader*> orig = sim_ctx_->traders();
-      std::set<Trader*>::iterator it;
-      for (it = orig.begin(); it != orig.end(); ++it) {
-        traders_.insert(*it);
+  /// @brief queries a given facility agent for
+  void AddRequests_(Trader* t) {
+    std::set<typename RequestPortfolio<T>::Ptr> rp;
+    QueryRequests_(t, &rp);
+    AddPortfolios_(rp);
+  }
+
+  /// @brief queries a given facility agent for
+  void AddBids_(Trader* t) {
+    std::set<typename BidPortfolio<T>::Ptr> bp;
+    QueryBids_(t, &bp);
+    AddPortfolios_(bp);
+  }
+
+  /// @brief queries a trader for its requests, or reuses those it returned
+  /// last if it declares them unchanged
+  void QueryRequests_(Trader* t,
+                      std::set<typename RequestPortfolio<T>::Ptr>* ports) {
+    PortfolioMemo<T>& memo = Memo<T>(t);
+    if (!t->MemoizesPortfolios()) {
+      ClearMemo_(&memo);
+      *ports = QueryRequests<T>(t);
+      return;
+    }
+    memo.requests_reused = !memo.requests.empty() && RequestsUnchanged<T>(t);
+    if (memo.requests_reused) {
+      *ports = memo.requests;
+      return;
+    }
+    *ports = QueryRequests<T>(t);
+    memo.requests = *ports;
+  }
+
+  /// @brief queries a trader for its bids, or reuses those it returned last
+  /// if it declares them unchanged and the requests they bid on are
+  void QueryBids_(Trader* t, std::set<typename BidPortfolio<T>::Ptr>* ports) {
+    if (!t->MemoizesPortfolios()) {
+      *ports = QueryBids<T>(t, ex_ctx_.commod_requests);
+      return;
+    }
+    PortfolioMemo<T>& memo = Memo<T>(t);
+    if (!memo.bids.empty() && BidsUnchanged<T>(t) && Reusable_(memo)) {
+      *ports = memo.bids;
+      return;
+    }
+    *ports = QueryBids<T>(t, ex_ctx_.commod_requests);
+
+    memo.bids = *ports;
+    memo.bid_ports.clear();
+    memo.bid_commods.clear();
+    typename std::set<typename BidPortfolio<T>::Ptr>::const_iterator it;
+    for (it = ports->begin(); it != ports->end(); ++it) {
+      const std::set<Bid<T>*>& bids = (*it)->bids();
+      typename std::set<Bid<T>*>::const_iterator bit;
+      for (bit = bids.begin(); bit != bids.end(); ++bit) {
+        Request<T>* r = (*bit)->request();
+        memo.bid_ports.insert(r->portfolio());
+        int c = r->commod_id();
+        memo.bid_commods[c] = NRequests_(c);
       }
     }
   }
 
-  /// @brief queries a given facility agent for
-  void AddRequests_(Trader* t) {
-    std::set<typename RequestPortfolio<T>::Ptr> rp = QueryRequests<T>(t);
-    typename std::set<typename RequestPortfolio<T>::Ptr>::iterator it;
-    for (it = rp.begin(); it != rp.end(); ++it) {
-      ex_ctx_.AddRequestPortfolio(*it);
+  /// @brief finds the request portfolios that were reused and the
+  /// commodities of those that were not, after all requests were added
+  void FindReused_() {
+    reused_.clear();
+    changed_commods_.assign(ex_ctx_.commodities->size(), 0);
+    const TraderRegistry& traders = sim_ctx_->traders();
+    TraderRegistry::const_iterator t;
+    for (t = traders.begin(); t != traders.end(); ++t) {
+      if ((*t)->MemoizesPortfolios()) {
+        break;
+      }
+    }
+    if (t == traders.end()) {
+      return;  // no bids can be reused
+    }
+
+    for (int i = 0; i < ex_ctx_.requests.size(); ++i) {
+      const typename RequestPortfolio<T>::Ptr& p = ex_ctx_.requests[i];
+      if (p->requester() != NULL && Memo<T>(p->requester()).requests_reused) {
+        reused_.insert(p.get());
+        continue;
+      }
+      const std::vector<Request<T>*>& reqs = p->requests();
+      for (int j = 0; j < reqs.size(); ++j) {
+        changed_commods_[reqs[j]->commod_id()] = 1;
+      }
     }
   }
 
-  /// @brief queries a given facility agent for
-  void AddBids_(Trader* t) {
-    std::set<typename BidPortfolio<T>::Ptr> bp =
-        QueryBids<T>(t, ex_ctx_.commod_requests);
-    typename std::set<typename BidPortfolio<T>::Ptr>::iterator it;
-    for (it = bp.begin(); it != bp.end(); ++it) {
-      ex_ctx_.AddBidPortfolio(*it);
+  /// @brief releases the portfolios of a trader that does not memoize them
+  static void ClearMemo_(PortfolioMemo<T>* memo) {
+    if (!memo->requests.empty() || !memo->bids.empty()) {
+      *memo = PortfolioMemo<T>();
     }
   }
 
-  /// @brief allows a trader and its parents to adjust any preferences in the
-  /// system
-  void AdjustPrefs_(Trader* t) {
-    typename PrefMap<T>::type& prefs = ex_ctx_.trader_prefs[t];
-    AdjustPrefs(t, prefs);
-    Agent* m = t->manager()->parent();
-    while (m != NULL) {
-      AdjustPrefs(m, prefs);
-      m = m->parent();
+  /// @return whether the bids of a memo may be reused in this exchange
+  bool Reusable_(const PortfolioMemo<T>& memo) const {
+    typename std::set<typename RequestPortfolio<T>::Ptr>::const_iterator it;
+    for (it = memo.bid_ports.begin(); it != memo.bid_ports.end(); ++it) {
+      if (reused_.count(it->get()) == 0) {
+        return false;
+      }
+    }
+    std::map<int, int>::const_iterator cit;
+    for (cit = memo.bid_commods.begin(); cit != memo.bid_commods.end();
+         ++cit) {
+      int c = cit->first;
+      if (c < 0 || c >= changed_commods_.size() || changed_commods_[c] ||
+          NRequests_(c) == 0 || NRequests_(c) != cit->second) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// @return the number of requests for a commodity in this exchange
+  inline int NRequests_(int commod_id) const {
+    return commod_id >= 0 && commod_id < ex_ctx_.n_commod_requests.size() ?
+        ex_ctx_.n_commod_requests[commod_id] : 0;
+  }
+
+  inline void AddPortfolio_(const typename RequestPortfolio<T>::Ptr& p) {
+    ex_ctx_.AddRequestPortfolio(p);
+  }
+
+  inline void AddPortfolio_(const typename BidPortfolio<T>::Ptr& p) {
+    ex_ctx_.AddBidPortfolio(p);
+  }
+
+  template <class P>
+  void AddPortfolios_(const std::set<P>& ports) {
+    typename std::set<P>::const_iterator it;
+    for (it = ports.begin(); it != ports.end(); ++it) {
+      AddPortfolio_(*it);
     }
   }
 
-  struct trader_compare {
-    bool operator()(Trader* lhs, Trader* rhs) const {
-      int left = lhs->manager()->id();
-      int right = rhs->manager()->id();
-      if (left != right) {
-        return left < right;
+  /// @brief queries the thread-safe traders concurrently using query, then
+  /// adds the portfolios of all traders in trader id order, querying the
+  /// remaining traders serially along the way
+  template <class P>
+  void AddAllConcurrent_(
+      void (ResourceExchange<T>::*query)(Trader*, std::set<P>*)) {
+    const TraderRegistry& traders = sim_ctx_->traders();
+    TraderRegistry::iterator it;
+    std::vector<Trader*> safe;
+    for (it = traders.begin(); it != traders.end(); ++it) {
+      Agent* m = (*it)->manager();
+      if (m != NULL && sim_ctx_->ThreadSafe(m)) {
+        safe.push_back(*it);
+      }
+    }
+
+    std::vector<std::set<P> > ports(safe.size());
+    std::vector<DatumList> bufs(safe.size());
+    std::vector<ThreadPool::Task> tasks;
+    tasks.reserve(safe.size());
+    for (int i = 0; i < safe.size(); ++i) {
+      tasks.push_back(std::bind(&ResourceExchange<T>::QueryDeferred_<P>, this,
+                                query, safe[i], &ports[i], &bufs[i]));
+    }
+    try {
+      if (!tasks.empty()) {
+        sim_ctx_->thread_pool()->Run(tasks);
+      }
+    } catch (...) {
+      for (int i = 0; i < bufs.size(); ++i) {
+        for (int j = 0; j < bufs[i].size(); ++j) {
+          delete bufs[i][j];
+        }
+      }
+      throw;
+    }
+
+    int next = 0;
+    for (it = traders.begin(); it != traders.end(); ++it) {
+      if (next < safe.size() && *it == safe[next]) {
+        sim_ctx_->rec_->CommitDeferred(&bufs[next]);
+        AddPortfolios_(ports[next]);
+        ++next;
       } else {
-        return lhs < rhs;
+        std::set<P> p;
+        (this->*query)(*it, &p);
+        AddPortfolios_(p);
       }
     }
-  };
+  }
 
-  // this sorts traders (and results in iteration...) based on traders'
-  // manager id.  Iterating over traders in this order helps increase the
-  // determinism of Cyclus overall.  This allows all traders' resource
-  // exchange functions are called in a much closer to deterministic order.
-  std::set<Trader*, trader_compare> traders_;
+  /// @brief calls query for a trader, buffering any data it records in buf
+  template <class P>
+  void QueryDeferred_(void (ResourceExchange<T>::*query)(Trader*,
+                                                         std::set<P>*),
+                      Trader* t, std::set<P>* ports, DatumList* buf) {
+    sim_ctx_->rec_->BeginDeferred(buf);
+    try {
+      (this->*query)(t, ports);
+    } catch (...) {
+      sim_ctx_->rec_->EndDeferred();
+      throw;
+    }
+    sim_ctx_->rec_->EndDeferred();
+  }
+
+  /// @brief the preferences an ancestor of requesters adjusts
+  struct AncestorBatch {
+    Agent* agent;
+    typename PrefBatch<T>::type prefs;
+  };
 
   Context* sim_ctx_;
   ExchangeContext<T> ex_ctx_;
+
+  /// the request portfolios of this exchange that were reused, and whether
+  /// each commodity, by commod_id, is requested by those that were not
+  std::set<RequestPortfolio<T>*> reused_;
+  std::vector<char> changed_commods_;
 };
 
 }  // namespace cyclus
@@ -1,7 +1,9 @@
 #include "sim_init.h"
 
+#include "adaptive_solver.h"
 #include "greedy_preconditioner.h"
 #include "greedy_solver.h"
+#include "priority_greedy_solver.h"
 #include "prog_solver.h"
 #include "region.h"
 
@@ -76,9 +78,8 @@ void SimInit::Snapshot(Context* ctx) {
      ->Record();
 
   // snapshot all agent internal state
-  std::set<Agent*> mlist = ctx->agent_list_;
-  std::set<Agent*>::iterator it;
-  for (it = mlist.begin(); it != mlist.end(); ++it) {
+  AgentRegistry::iterator it;
+  for (it = ctx->agent_list_.begin(); it != ctx->agent_list_.end(); ++it) {
     Agent* m = *it;
     if (m->enter_time() != -1) {
       SimInit::SnapAgent(m);
@@ -162,6 +163,14 @@ void SimInit::LoadInfo() {
   qr = b_->Query("InfoExplicitInv", NULL);
   si_.explicit_inventory = qr.GetVal<bool>("RecordInventory");
   si_.explicit_inventory_compact = qr.GetVal<bool>("RecordInventoryCompact");
+  try {
+    si_.explicit_inventory_changes = qr.GetVal<bool>("RecordInventoryChanges");
+  } catch (std::exception err) {}  // recorded by an older version (okay)
+
+  try {
+    qr = b_->Query("InfoTimings", NULL);
+    si_.record_timings = qr.GetVal<bool>("RecordTimings");
+  } catch (std::exception err) {}  // table doesn't exist (okay)
 
   ctx_->InitSim(si_);
 }
@@ -210,7 +219,8 @@ void* SimInit::LoadPreconditioner(std::string name) {
 }
 
 ExchangeSolver* SimInit::LoadGreedySolver(bool exclusive, 
-                                          std::set<std::string> tables) {
+                                          std::set<std::string> tables,
+                                          bool priority) {
   using std::set;
   using std::string;
   ExchangeSolver* solver;
@@ -226,7 +236,10 @@ ExchangeSolver* SimInit::LoadGreedySolver(bool exclusive,
   }
 
   precon = LoadPreconditioner(precon_name);
-  if (precon == NULL) {
+  if (priority) {
+    solver = new PriorityGreedySolver(exclusive,
+      reinterpret_cast<GreedyPreconditioner*>(precon));
+  } else if (precon == NULL) {
     solver = new GreedySolver(exclusive);
   } else {
     solver = new GreedySolver(exclusive,
@@ -237,9 +250,11 @@ ExchangeSolver* SimInit::LoadGreedySolver(bool exclusive,
 
 ExchangeSolver* SimInit::LoadCoinSolver(bool exclusive, 
                                         std::set<std::string> tables) {
-  ExchangeSolver* solver;
+  ProgSolver* solver;
   double timeout;
   bool verbose, mps;
+  bool persistent = false;
+  bool relax = false;
   
   std::string solver_info = "CoinSolverInfo";
   if (0 < tables.count(solver_info)) {
@@ -247,14 +262,40 @@ ExchangeSolver* SimInit::LoadCoinSolver(bool exclusive,
     timeout = qr.GetVal<double>("Timeout");
     verbose = qr.GetVal<bool>("Verbose");
     mps = qr.GetVal<bool>("Mps");
+    try {
+      persistent = qr.GetVal<bool>("Persistent");
+      relax = qr.GetVal<bool>("Relax");
+    } catch (std::exception err) {}  // recorded by an older version (okay)
   }
 
   // set timeout to default if input value is non-positive
   timeout = timeout <= 0 ? ProgSolver::kDefaultTimeout : timeout;
   solver = new ProgSolver("cbc", timeout, exclusive, verbose, mps);
+  solver->persistent(persistent);
+  solver->relax(relax);
   return solver;
 }
 
+ExchangeSolver* SimInit::LoadAdaptiveSolver(bool exclusive,
+                                            std::set<std::string> tables) {
+  double budget = AdaptiveSolver::kDefaultBudget;
+  int max_arcs = AdaptiveSolver::kDefaultMaxArcs;
+
+  std::string solver_info = "AdaptiveSolverInfo";
+  if (0 < tables.count(solver_info)) {
+    QueryResult qr = b_->Query(solver_info, NULL);
+    if (qr.rows.size() > 0) {
+      budget = qr.GetVal<double>("Budget");
+      max_arcs = qr.GetVal<int>("MaxArcs");
+    }
+  }
+
+  // set defaults if input values are non-positive
+  budget = budget <= 0 ? AdaptiveSolver::kDefaultBudget : budget;
+  max_arcs = max_arcs <= 0 ? AdaptiveSolver::kDefaultMaxArcs : max_arcs;
+  return new AdaptiveSolver(budget, max_arcs, exclusive);
+}
+
 void SimInit::LoadSolverInfo() {
   using std::set;
   using std::string;
@@ -262,6 +303,10 @@ void SimInit::LoadSolverInfo() {
   ExchangeSolver* solver;
   string solver_name;
   bool exclusive_orders;
+  bool decompose = false;
+  bool aggregate = false;
+  bool incremental = false;
+  bool concurrent_markets = false;
 
   // load in possible Solver info, needs to be optional to
   // maintain backwards compatibility, defaults above.
@@ -272,17 +317,31 @@ void SimInit::LoadSolverInfo() {
     if (qr.rows.size() > 0) {
       solver_name = qr.GetVal<string>("Solver");
       exclusive_orders = qr.GetVal<bool>("ExclusiveOrders");
+      try {
+        decompose = qr.GetVal<bool>("Decompose");
+        aggregate = qr.GetVal<bool>("Aggregate");
+        incremental = qr.GetVal<bool>("Incremental");
+        concurrent_markets = qr.GetVal<bool>("ConcurrentMarkets");
+      } catch (std::exception err) {}  // recorded by an older version (okay)
     }
   }
 
   if (solver_name == "greedy") {
     solver = LoadGreedySolver(exclusive_orders, tables);
+  } else if (solver_name == "priority-greedy") {
+    solver = LoadGreedySolver(exclusive_orders, tables, true);
   } else if (solver_name == "coin-or") {
     solver = LoadCoinSolver(exclusive_orders, tables);
+  } else if (solver_name == "adaptive") {
+    solver = LoadAdaptiveSolver(exclusive_orders, tables);
   } else {
     throw ValueError("The name of the solver was not recognized, "
                      "got '" + solver_name + "'.");
   }
+  solver->decompose(decompose);
+  solver->aggregate(aggregate);
+  solver->incremental(incremental);
+  solver->concurrent_markets(concurrent_markets);
 
   ctx_->solver(solver);
 }
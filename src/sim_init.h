@@ -89,8 +89,11 @@ class SimInit {
   void LoadNextIds();
 
   void* LoadPreconditioner(std::string name);
-  ExchangeSolver* LoadGreedySolver(bool exclusive, std::set<std::string> tables);
+  ExchangeSolver* LoadGreedySolver(bool exclusive, std::set<std::string> tables,
+                                   bool priority = false);
   ExchangeSolver* LoadCoinSolver(bool exclusive, std::set<std::string> tables);
+  ExchangeSolver* LoadAdaptiveSolver(bool exclusive,
+                                     std::set<std::string> tables);
   static Resource::Ptr LoadResource(Context* ctx, QueryableBackend* b, int resid);
   static Material::Ptr LoadMaterial(Context* ctx, QueryableBackend* b, int resid);
   static Product::Ptr LoadProduct(Context* ctx, QueryableBackend* b, int resid);
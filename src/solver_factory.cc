@@ -30,12 +30,16 @@ int CbcCallBack(CbcModel * model, int from) {
 ObjValueHandler::ObjValueHandler(double obj, double time, bool found)
   : obj_(obj),
     time_(time),
-    found_(found) { };
+    deadline_(-1),
+    found_(found),
+    stopped_(false) { };
 
 ObjValueHandler::ObjValueHandler(double obj)
   : obj_(obj),
     time_(0),
-    found_(false) { };
+    deadline_(-1),
+    found_(false),
+    stopped_(false) { };
     
 ObjValueHandler::~ObjValueHandler() { };
 
@@ -43,6 +47,8 @@ ObjValueHandler::ObjValueHandler(const ObjValueHandler& other): CbcEventHandler(
   obj_ = other.obj();
   time_ = other.time();
   found_ = other.found();
+  deadline_ = other.deadline();
+  stopped_ = other.stopped();
 }
   
 ObjValueHandler& ObjValueHandler::operator=(const ObjValueHandler& other) {
@@ -50,6 +56,8 @@ ObjValueHandler& ObjValueHandler::operator=(const ObjValueHandler& other) {
     obj_ = other.obj();
     time_ = other.time();
     found_ = other.found();
+    deadline_ = other.deadline();
+    stopped_ = other.stopped();
     CbcEventHandler::operator=(other);
   }
   return *this;
@@ -60,6 +68,10 @@ CbcEventHandler* ObjValueHandler::clone() {
 }
 
 CbcEventHandler::CbcAction ObjValueHandler::event(CbcEvent e) {
+  if (deadline_ >= 0 && CoinGetTimeOfDay() > deadline_) {
+    stopped_ = true;
+    return stop;
+  }
   if (!found_ && (e == solution || e == heuristicSolution)) {
     const CbcModel* m = getModel();
     double cbcobj = m->getObjValue();
@@ -119,48 +131,106 @@ void ReportProg(OsiSolverInterface* si) {
   m->dumpMatrix();
 }
 
-void SolveProg(OsiSolverInterface* si, double greedy_obj, bool verbose) {
+/// solves an integer program with cbc, starting from x0 if it is not NULL
+///
+/// @param budget the wall-clock time in seconds after which the search is
+/// stopped, or a negative value for none
+/// @return false if the search was stopped at the budget
+bool SolveMIP(OsiSolverInterface* si, double greedy_obj, bool verbose,
+              const std::vector<double>* x0, double budget) {
+  const char *argv[] = {"exchng", "-log", "0", "-solve","-quit"};
+  int argc = 3;
+  double start = CoinGetTimeOfDay();
+  CbcModel model(*si);
+  if (x0 != NULL && x0->size() == si->getNumCols() && !x0->empty()) {
+    const double* obj = si->getObjCoefficients();
+    double x0_obj = 0;
+    for (int i = 0; i != x0->size(); i++) {
+      x0_obj += obj[i] * (*x0)[i];
+    }
+    bool check = true;  // cbc discards it if it is infeasible
+    model.setBestSolution(&(*x0)[0], x0->size(), x0_obj, check);
+  }
+  ObjValueHandler handler(greedy_obj);
+  if (budget >= 0) {
+    handler.deadline(start + budget);
+  }
+  CbcMain0(model);
+  model.passInEventHandler(&handler);
+  CbcMain1(argc, argv, model, CbcCallBack);
+  si->setColSolution(model.getColSolution());
+  if (verbose) {
+    std::cout << "Greedy equivalent time: " << handler.time()
+              << " and obj " << handler.obj()
+              << " and found " << std::boolalpha << handler.found() << "\n";
+  }
+  return !handler.stopped();
+}
+
+void ReportSoln(OsiSolverInterface* si) {
+  const double* soln = si->getColSolution();
+  for (int i = 0; i != si->getNumCols(); i ++) {
+    std::cout << "soln " << i << ": " << soln[i]
+              << " integer: " << std::boolalpha << si->isInteger(i) << "\n";
+  }
+}
+
+bool SolveProg(OsiSolverInterface* si, double greedy_obj, bool verbose,
+               double budget) {
   if (verbose)
     ReportProg(si);
 
+  bool finished;
   if (HasInt(si)) {
-    const char *argv[] = {"exchng", "-log", "0", "-solve","-quit"};
-    int argc = 3;
-    CbcModel model(*si);
-    ObjValueHandler handler(greedy_obj);
-    CbcMain0(model);
-    model.passInEventHandler(&handler);
-    CbcMain1(argc, argv, model, CbcCallBack);
-    si->setColSolution(model.getColSolution());
-    if (verbose) {
-      std::cout << "Greedy equivalent time: " << handler.time()
-                << " and obj " << handler.obj()
-                << " and found " << std::boolalpha << handler.found() << "\n";
-    }
+    finished = SolveMIP(si, greedy_obj, verbose, NULL, budget);
   } else {
     // no ints, just solve 'initial lp relaxation' 
     si->initialSolve();
+    finished = si->isProvenOptimal();
   }
   
-  if (verbose) {
-    const double* soln = si->getColSolution();
-    for (int i = 0; i != si->getNumCols(); i ++) {
-      std::cout << "soln " << i << ": " << soln[i]
-                << " integer: " << std::boolalpha << si->isInteger(i) << "\n";
-    }
+  if (verbose)
+    ReportSoln(si);
+  return finished;
+}
+
+bool ResolveProg(OsiSolverInterface* si, double greedy_obj, bool verbose,
+                 const std::vector<double>& x0, double budget) {
+  if (verbose)
+    ReportProg(si);
+
+  // the relaxation is solved by si itself, rather than a copy, so that its
+  // basis is kept for the next resolve
+  si->resolve();
+  bool finished = si->isProvenOptimal();
+  if (HasInt(si)) {
+    finished = SolveMIP(si, greedy_obj, verbose, &x0, budget);
   }
+
+  if (verbose)
+    ReportSoln(si);
+  return finished;
+}
+
+bool ResolveProg(OsiSolverInterface* si, double greedy_obj, bool verbose,
+                 const std::vector<double>& x0) {
+  return ResolveProg(si, greedy_obj, verbose, x0, -1);
+}
+
+bool SolveProg(OsiSolverInterface* si) {
+  return SolveProg(si, si->getInfinity(), false, -1);
 }
 
-void SolveProg(OsiSolverInterface* si) {
-  SolveProg(si, si->getInfinity(), false);
+bool SolveProg(OsiSolverInterface* si, bool verbose) {
+  return SolveProg(si, si->getInfinity(), verbose, -1);
 }
 
-void SolveProg(OsiSolverInterface* si, bool verbose) {
-  SolveProg(si, si->getInfinity(), verbose);
+bool SolveProg(OsiSolverInterface* si, double greedy_obj) {
+  return SolveProg(si, greedy_obj, false, -1);
 }
 
-void SolveProg(OsiSolverInterface* si, double greedy_obj) {
-  SolveProg(si, greedy_obj, false);
+bool SolveProg(OsiSolverInterface* si, double greedy_obj, bool verbose) {
+  return SolveProg(si, greedy_obj, verbose, -1);
 }
 
 bool HasInt(OsiSolverInterface* si) {
@@ -2,6 +2,7 @@
 #define CYCLUS_SRC_SOLVER_FACTORY_H_
 
 #include <string>
+#include <vector>
 
 #include "CbcEventHandler.hpp"
 
@@ -12,7 +13,8 @@ namespace cyclus {
 /// this is taken exactly from driver4.cpp in the Cbc examples
 static int CbcCallBack(CbcModel * model, int from);
   
-/// An event handler that records the time that a better solution is found  
+/// An event handler that records the time that a better solution is found
+/// and, if given a deadline, stops the search once it has passed
 class ObjValueHandler: public CbcEventHandler {
  public:
   ObjValueHandler(double obj, double time, bool found);
@@ -25,10 +27,20 @@ class ObjValueHandler: public CbcEventHandler {
   inline double time() const { return time_; }
   inline double obj() const { return obj_; }
   inline bool found() const { return found_; }
+
+  /// the wall-clock time (see CoinGetTimeOfDay) after which the search is
+  /// stopped, default none
+  /// @{
+  inline void deadline(double t) { deadline_ = t; }
+  inline double deadline() const { return deadline_; }
+  /// @}
+
+  /// @return whether the search was stopped at the deadline
+  inline bool stopped() const { return stopped_; }
     
  private:
-  double obj_, time_;
-  bool found_;
+  double obj_, time_, deadline_;
+  bool found_, stopped_;
 };
 
 /// A factory class that, given a configuration, returns a
@@ -58,10 +70,35 @@ class SolverFactory {
   double tmax_;
 };
 
-void SolveProg(OsiSolverInterface* si);
-void SolveProg(OsiSolverInterface* si, bool verbose);
-void SolveProg(OsiSolverInterface* si, double greedy_obj);
-void SolveProg(OsiSolverInterface* si, double greedy_obj, bool verbose);
+/// solves a program within the maximum solution time of the interface (see
+/// SolverFactory), which bounds linear programs and relaxations. The search
+/// of integer programs is only stopped if it is given a wall-clock budget.
+///
+/// @param budget the wall-clock time in seconds after which the search of an
+/// integer program is stopped, default none (negative)
+/// @return false if the solution time or budget ran out before an optimal
+/// solution was proven, in which case the interface's solution may be
+/// suboptimal or infeasible, e.g., a fractional relaxation
+/// @{
+bool SolveProg(OsiSolverInterface* si);
+bool SolveProg(OsiSolverInterface* si, bool verbose);
+bool SolveProg(OsiSolverInterface* si, double greedy_obj);
+bool SolveProg(OsiSolverInterface* si, double greedy_obj, bool verbose);
+bool SolveProg(OsiSolverInterface* si, double greedy_obj, bool verbose,
+               double budget);
+/// @}
+
+/// solves a program warm started from the interface's current basis, e.g.,
+/// after it has been solved and then modified, leaving the basis of its
+/// relaxation in the interface. Integer programs are additionally started
+/// from the incumbent solution x0 if it has a value for every column and is
+/// feasible. Takes a budget and returns like SolveProg.
+/// @{
+bool ResolveProg(OsiSolverInterface* si, double greedy_obj, bool verbose,
+                 const std::vector<double>& x0);
+bool ResolveProg(OsiSolverInterface* si, double greedy_obj, bool verbose,
+                 const std::vector<double>& x0, double budget);
+/// @}
 bool HasInt(OsiSolverInterface* si);
 
 }  // namespace cyclus
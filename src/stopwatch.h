@@ -0,0 +1,43 @@
+#ifndef CYCLUS_SRC_STOPWATCH_H_
+#define CYCLUS_SRC_STOPWATCH_H_
+
+#include <chrono>
+#include <ctime>
+
+namespace cyclus {
+
+/// @class Stopwatch
+///
+/// @brief Measures the wall-clock and processor time elapsed since it was
+/// last started. A default constructed stopwatch is not started, so that it
+/// costs nothing when timing is disabled.
+class Stopwatch {
+ public:
+  Stopwatch() : cpu_start_(0) {}
+
+  /// (re)starts the stopwatch
+  inline void Start() {
+    wall_start_ = std::chrono::steady_clock::now();
+    cpu_start_ = std::clock();
+  }
+
+  /// @return the wall-clock time in seconds since the last call to Start
+  inline double wall() const {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - wall_start_).count();
+  }
+
+  /// @return the processor time in seconds used by the process (i.e. summed
+  /// over all of its threads) since the last call to Start
+  inline double cpu() const {
+    return static_cast<double>(std::clock() - cpu_start_) / CLOCKS_PER_SEC;
+  }
+
+ private:
+  std::chrono::steady_clock::time_point wall_start_;
+  std::clock_t cpu_start_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_STOPWATCH_H_
@@ -0,0 +1,162 @@
+#include "thread_pool.h"
+
+namespace cyclus {
+
+namespace {
+
+/// true while the current thread executes a task of a batch
+thread_local bool in_task = false;
+
+}  // namespace
+
+ThreadPool::ThreadPool(int nthreads)
+    : remaining_(0),
+      batch_(0),
+      stop_(false) {
+  nthreads = nthreads < 1 ? 1 : nthreads;
+  for (int i = 0; i < nthreads; ++i) {
+    queues_.push_back(new WorkQueue());
+  }
+  // queue 0 belongs to the thread calling Run
+  for (int i = 1; i < nthreads; ++i) {
+    workers_.push_back(std::thread(&ThreadPool::WorkerLoop, this, i));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  for (int i = 0; i < workers_.size(); ++i) {
+    workers_[i].join();
+  }
+  for (int i = 0; i < queues_.size(); ++i) {
+    delete queues_[i];
+  }
+}
+
+void ThreadPool::Run(const std::vector<Task>& tasks) {
+  if (tasks.empty()) {
+    return;
+  }
+
+  if (workers_.empty() || in_task) {
+    for (int i = 0; i < tasks.size(); ++i) {
+      tasks[i]();
+    }
+    return;
+  }
+
+  err_ = std::exception_ptr();
+  remaining_ = tasks.size();
+
+  // deal out contiguous chunks so that neighboring tasks tend to run on the
+  // same thread
+  int nq = queues_.size();
+  int n = tasks.size();
+  for (int q = 0; q < nq; ++q) {
+    int begin = static_cast<long>(n) * q / nq;
+    int end = static_cast<long>(n) * (q + 1) / nq;
+    std::lock_guard<std::mutex> lk(queues_[q]->mu);
+    for (int i = begin; i < end; ++i) {
+      queues_[q]->tasks.push_back(&tasks[i]);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    ++batch_;
+  }
+  work_cv_.notify_all();
+
+  while (RunOne(0)) {}
+
+  std::unique_lock<std::mutex> lk(mu_);
+  while (remaining_ > 0) {
+    done_cv_.wait(lk);
+  }
+
+  if (err_) {
+    std::exception_ptr err = err_;
+    err_ = std::exception_ptr();
+    std::rethrow_exception(err);
+  }
+}
+
+void ThreadPool::ParallelFor(int n, const std::function<void(int)>& f) {
+  std::vector<Task> tasks;
+  tasks.reserve(n);
+  for (int i = 0; i < n; ++i) {
+    tasks.push_back(std::bind(f, i));
+  }
+  Run(tasks);
+}
+
+void ThreadPool::WorkerLoop(int id) {
+  unsigned long seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lk(mu_);
+      while (!stop_ && batch_ == seen) {
+        work_cv_.wait(lk);
+      }
+      if (stop_) {
+        return;
+      }
+      seen = batch_;
+    }
+
+    while (RunOne(id)) {}
+  }
+}
+
+bool ThreadPool::RunOne(int id) {
+  const Task* t = NULL;
+  int nq = queues_.size();
+
+  // own work is taken from the back, stolen work from the front
+  {
+    WorkQueue* q = queues_[id];
+    std::lock_guard<std::mutex> lk(q->mu);
+    if (!q->tasks.empty()) {
+      t = q->tasks.back();
+      q->tasks.pop_back();
+    }
+  }
+  for (int i = 1; t == NULL && i < nq; ++i) {
+    WorkQueue* q = queues_[(id + i) % nq];
+    std::lock_guard<std::mutex> lk(q->mu);
+    if (!q->tasks.empty()) {
+      t = q->tasks.front();
+      q->tasks.pop_front();
+    }
+  }
+
+  if (t == NULL) {
+    return false;
+  }
+  Execute(t);
+  return true;
+}
+
+void ThreadPool::Execute(const Task* t) {
+  in_task = true;
+  try {
+    (*t)();
+  } catch (...) {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!err_) {
+      err_ = std::current_exception();
+    }
+  }
+  in_task = false;
+
+  if (--remaining_ == 0) {
+    std::lock_guard<std::mutex> lk(mu_);
+    done_cv_.notify_all();
+  }
+}
+
+}  // namespace cyclus
@@ -0,0 +1,92 @@
+#ifndef CYCLUS_SRC_THREAD_POOL_H_
+#define CYCLUS_SRC_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cyclus {
+
+/// @class ThreadPool
+///
+/// @brief A fixed-size pool of worker threads that executes batches of
+/// independent tasks.
+///
+/// Every thread in the pool (including the thread calling Run) owns a task
+/// queue. The tasks of a batch are dealt out to the queues in contiguous
+/// chunks; each thread works through its own queue and, once it runs dry,
+/// steals work from the other queues. This keeps all threads busy even when
+/// task costs are very uneven (e.g. a handful of expensive reactors among
+/// thousands of cheap sinks).
+///
+/// @code
+/// ThreadPool pool(4);
+/// std::vector<ThreadPool::Task> tasks;
+/// // fill tasks
+/// pool.Run(tasks);  // blocks until all tasks are done
+/// @endcode
+///
+/// A pool constructed with fewer than two threads starts no workers and runs
+/// every batch serially, in order, on the calling thread.
+class ThreadPool {
+ public:
+  typedef std::function<void()> Task;
+
+  /// @param nthreads the total number of threads tasks are executed on,
+  /// including the thread calling Run
+  explicit ThreadPool(int nthreads);
+
+  /// stops and joins all worker threads
+  ~ThreadPool();
+
+  /// @return the number of threads tasks are executed on
+  inline int size() const { return queues_.size(); }
+
+  /// @brief executes all tasks, blocking until every one of them has
+  /// finished. If Run is called from within a task, the tasks are executed
+  /// serially, in order, on the calling thread.
+  ///
+  /// @throws the first exception thrown by any task; it is rethrown after
+  /// the whole batch has completed
+  void Run(const std::vector<Task>& tasks);
+
+  /// @brief calls f(i) for every i in [0, n) using Run
+  void ParallelFor(int n, const std::function<void(int)>& f);
+
+ private:
+  struct WorkQueue {
+    std::mutex mu;
+    std::deque<const Task*> tasks;
+  };
+
+  /// waits for batches and helps execute them until the pool is stopped
+  void WorkerLoop(int id);
+
+  /// pops a task from the id'th queue or steals one from another queue and
+  /// executes it
+  ///
+  /// @return false if no task could be found
+  bool RunOne(int id);
+
+  void Execute(const Task* t);
+
+  std::vector<WorkQueue*> queues_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mu_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  std::atomic<int> remaining_;
+  unsigned long batch_;
+  bool stop_;
+  std::exception_ptr err_;
+};
+
+}  // namespace cyclus
+
+#endif  // CYCLUS_SRC_THREAD_POOL_H_
@@ -20,6 +20,14 @@ namespace cyclus {
 /// }
 ///
 /// @endcode
+///
+/// Archetypes annotated as thread-safe (e.g. with
+/// ``#pragma cyclus note {"thread_safe": true}``) may have their Tick and
+/// Tock invoked concurrently with those of other thread-safe agents when the
+/// simulation is run with more than one thread. Such agents may only modify
+/// their own state and record data; they must not create or transact
+/// resources, interact with other agents, or schedule builds and
+/// decommissionings from Tick or Tock.
 class TimeListener: virtual public Ider {
  public:
   /// Simulation agents do their beginning-of-timestep activities in the Tick
@@ -33,6 +41,17 @@ class TimeListener: virtual public Ider {
   ///
   /// @param time is the current simulation timestep
   virtual void Tock() = 0;
+
+  /// Returns the timestep at which the listener next needs its Tick and Tock
+  /// invoked. It is queried at the end of every timestep in which the
+  /// listener was awake. Agents that only need to act periodically can return
+  /// e.g. time + period; returning a time past the end of the simulation puts
+  /// the listener to sleep until it is explicitly woken via Context::Wake.
+  /// Listeners are automatically woken when they take part in a trade. The
+  /// default wakes every timestep.
+  ///
+  /// @param time is the current simulation timestep
+  virtual int NextWake(int time) { return time + 1; }
 };
 
 }  // namespace cyclus
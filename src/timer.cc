@@ -1,8 +1,12 @@
 // Implements the Timer class
 #include "timer.h"
 
+#include <algorithm>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "agent.h"
 #include "error.h"
@@ -18,23 +22,43 @@ void Timer::RunSim() {
 
   ExchangeManager<Material> matl_manager(ctx_);
   ExchangeManager<Product> genrsrc_manager(ctx_);
+  ThreadPool pool(si_.threads);
+  pool_ = si_.threads > 1 ? &pool : NULL;
+
+  // markets are solved concurrently only if each can have its own solver
+  std::vector<Market*> markets;
+  markets.push_back(&matl_manager);
+  markets.push_back(&genrsrc_manager);
+  ExchangeSolver* solver = ctx_->solver();
+  ClearMarketSolvers();
+  concurrent_markets_ = pool_ != NULL && solver != NULL &&
+                        solver->concurrent_markets();
   while (time_ < si_.duration) {
     CLOG(LEV_INFO1) << "Current time: " << time_;
+    if (si_.record_timings) {
+      phase_sw_.Start();
+    }
 
     if (want_snapshot_) {
       want_snapshot_ = false;
       SimInit::Snapshot(ctx_);
+      RecordPhase("Snapshot");
     }
 
     // run through phases
+    WakeListeners();
     DoBuild();
+    RecordPhase("Build");
     CLOG(LEV_INFO2) << "Beginning Tick for time: " << time_;
     DoTick();
+    RecordPhase("Tick");
     CLOG(LEV_INFO2) << "Beginning DRE for time: " << time_;
-    DoResEx(&matl_manager, &genrsrc_manager);
+    DoResEx(markets);
+    RecordPhase("ResEx");
     CLOG(LEV_INFO2) << "Beginning Tock for time: " << time_;
     DoTock();
     DoDecom();
+    RecordPhase("Decom");
 
     time_++;
 
@@ -43,22 +67,28 @@ void Timer::RunSim() {
     }
   }
 
+  CommitInventories();
   ctx_->NewDatum("Finish")
       ->AddVal("EarlyTerm", want_kill_)
       ->AddVal("EndTime", time_-1)
       ->Record();
 
+  pool_ = NULL;
+  concurrent_markets_ = false;
+  ClearMarketSolvers();
   SimInit::Snapshot(ctx_);  // always do a snapshot at the end of every simulation
 }
 
 void Timer::DoBuild() {
   // build queued agents
-  std::vector<std::pair<std::string, Agent*> > build_list = build_queue_[time_];
-  for (int i = 0; i < build_list.size(); ++i) {
-    Agent* m = ctx_->CreateAgent<Agent>(build_list[i].first);
-    Agent* parent = build_list[i].second;
-    CLOG(LEV_INFO3) << "Building a " << build_list[i].first
-                    << " from parent " << build_list[i].second;
+  while (!build_queue_.empty() && build_queue_.begin()->first <= time_) {
+    std::string proto = build_queue_.begin()->second.first;
+    Agent* parent = build_queue_.begin()->second.second;
+    build_queue_.erase(build_queue_.begin());
+
+    Agent* m = ctx_->CreateAgent<Agent>(proto);
+    CLOG(LEV_INFO3) << "Building a " << proto
+                    << " from parent " << parent;
     m->Build(parent);
     if (parent != NULL) {
       parent->BuildNotify(m);
@@ -69,92 +99,467 @@ void Timer::DoBuild() {
 }
 
 void Timer::DoTick() {
-  for (std::map<int, TimeListener*>::iterator agent = tickers_.begin();
-       agent != tickers_.end();
+  if ((pool_ != NULL && !concurrent_.empty()) || si_.record_timings) {
+    RunListeners(&TimeListener::Tick, "Tick");
+    return;
+  }
+
+  for (std::map<int, TimeListener*>::iterator agent = awake_.begin();
+       agent != awake_.end();
        agent++) {
     agent->second->Tick();
   }
 }
 
-void Timer::DoResEx(ExchangeManager<Material>* matmgr,
-                    ExchangeManager<Product>* genmgr) {
-  matmgr->Execute();
-  genmgr->Execute();
+void Timer::DoResEx(const std::vector<Market*>& builtin) {
+  std::vector<Market*> markets(builtin);
+  markets.insert(markets.end(), markets_.begin(), markets_.end());
+  if (!concurrent_markets_) {
+    for (int i = 0; i < markets.size(); ++i) {
+      markets[i]->Execute();
+    }
+    return;
+  }
+
+  // the first market is solved by the simulation's solver
+  for (int i = 1; i < markets.size(); ++i) {
+    boost::shared_ptr<ExchangeSolver>& s = market_solvers_[markets[i]];
+    if (s == NULL) {
+      s.reset(ctx_->solver()->CloneWithOptions());
+      markets[i]->solver(s.get());
+    }
+  }
+
+  for (int i = 0; i < markets.size(); ++i) {
+    markets[i]->Collect();
+  }
+
+  std::vector<DatumList> bufs(markets.size());
+  std::vector<ThreadPool::Task> tasks;
+  for (int i = 0; i < markets.size(); ++i) {
+    tasks.push_back(std::bind(&Timer::SolveDeferred, this, markets[i],
+                              &bufs[i]));
+  }
+  try {
+    pool_->Run(tasks);
+  } catch (...) {
+    for (int i = 0; i < bufs.size(); ++i) {
+      for (int j = 0; j < bufs[i].size(); ++j) {
+        delete bufs[i][j];
+      }
+    }
+    throw;
+  }
+  for (int i = 0; i < markets.size(); ++i) {
+    ctx_->rec_->CommitDeferred(&bufs[i]);
+  }
+
+  for (int i = 0; i < markets.size(); ++i) {
+    markets[i]->ExecuteTrades();
+  }
+}
+
+void Timer::RegisterMarket(Market* m) {
+  if (std::find(markets_.begin(), markets_.end(), m) == markets_.end()) {
+    markets_.push_back(m);
+  }
+}
+
+void Timer::UnregisterMarket(Market* m) {
+  std::vector<Market*>::iterator it =
+      std::find(markets_.begin(), markets_.end(), m);
+  if (it == markets_.end()) {
+    return;
+  }
+  markets_.erase(it);
+  if (market_solvers_.erase(m) > 0) {
+    m->solver(NULL);
+  }
+}
+
+void Timer::ClearMarketSolvers() {
+  // the built-in markets of a previous run no longer exist
+  for (int i = 0; i < markets_.size(); ++i) {
+    if (market_solvers_.count(markets_[i]) > 0) {
+      markets_[i]->solver(NULL);
+    }
+  }
+  market_solvers_.clear();
+}
+
+void Timer::SolveDeferred(Market* m, DatumList* buf) {
+  ctx_->rec_->BeginDeferred(buf);
+  try {
+    m->Solve();
+  } catch (...) {
+    ctx_->rec_->EndDeferred();
+    throw;
+  }
+  ctx_->rec_->EndDeferred();
 }
 
 void Timer::DoTock() {
-  for (std::map<int, TimeListener*>::iterator agent = tickers_.begin();
-       agent != tickers_.end();
-       agent++) {
-    agent->second->Tock();
+  if ((pool_ != NULL && !concurrent_.empty()) || si_.record_timings) {
+    RunListeners(&TimeListener::Tock, "Tock");
+  } else {
+    for (std::map<int, TimeListener*>::iterator agent = awake_.begin();
+         agent != awake_.end();
+         agent++) {
+      agent->second->Tock();
+    }
   }
+  SleepListeners();
+  RecordPhase("Tock");
 
   if (si_.explicit_inventory || si_.explicit_inventory_compact) {
-    std::set<Agent*> ags = ctx_->agent_list_;
-    std::set<Agent*>::iterator it;
-    for (it = ags.begin(); it != ags.end(); ++it) {
-      Agent* a = *it;
-      if (a->enter_time() == -1) {
-        continue; // skip agents that aren't alive
+    RecordInventories();
+    RecordPhase("Inventory");
+  }
+}
+
+
+void Timer::RunListeners(void (TimeListener::*phase)(), const char* name) {
+  bool timed = si_.record_timings;
+  std::vector<TimeListener*> safe;
+  std::map<int, TimeListener*>::iterator it;
+  if (pool_ != NULL) {
+    for (it = awake_.begin(); it != awake_.end(); ++it) {
+      if (concurrent_.count(it->first) > 0) {
+        safe.push_back(it->second);
       }
-      RecordInventories(a);
     }
   }
+
+  std::vector<DatumList> bufs(safe.size());
+  std::vector<double> walls(safe.size(), 0);
+  std::vector<ThreadPool::Task> tasks;
+  tasks.reserve(safe.size());
+  for (int i = 0; i < safe.size(); ++i) {
+    tasks.push_back(std::bind(&Timer::RunDeferred, this, phase, safe[i],
+                              &bufs[i], timed ? &walls[i] : NULL));
+  }
+  try {
+    if (!tasks.empty()) {
+      pool_->Run(tasks);
+    }
+  } catch (...) {
+    for (int i = 0; i < bufs.size(); ++i) {
+      for (int j = 0; j < bufs[i].size(); ++j) {
+        delete bufs[i][j];
+      }
+    }
+    throw;
+  }
+
+  // run everyone else serially, interleaving the buffered data so that the
+  // output order matches a fully serial run
+  // std::map<spec, std::pair<number of agents, wall time> >
+  std::map<std::string, std::pair<int, double> > costs;
+  Stopwatch sw;
+  int next = 0;
+  for (it = awake_.begin(); it != awake_.end(); ++it) {
+    double wall = 0;
+    if (next < safe.size() && it->second == safe[next]) {
+      ctx_->rec_->CommitDeferred(&bufs[next]);
+      wall = walls[next];
+      ++next;
+    } else if (timed) {
+      sw.Start();
+      (it->second->*phase)();
+      wall = sw.wall();
+    } else {
+      (it->second->*phase)();
+    }
+
+    if (timed) {
+      std::pair<int, double>& cost = costs[ListenerSpec(it->second)];
+      cost.first++;
+      cost.second += wall;
+    }
+  }
+
+  std::map<std::string, std::pair<int, double> >::iterator c;
+  for (c = costs.begin(); c != costs.end(); ++c) {
+    ctx_->NewDatum("ArchetypeTimings")
+        ->AddVal("Time", time_)
+        ->AddVal("Phase", std::string(name))
+        ->AddVal("Spec", c->first)
+        ->AddVal("NumAgents", c->second.first)
+        ->AddVal("WallTime", c->second.second)
+        ->Record();
+  }
+}
+
+void Timer::RunDeferred(void (TimeListener::*phase)(), TimeListener* tl,
+                        DatumList* buf, double* wall) {
+  Stopwatch sw;
+  if (wall != NULL) {
+    sw.Start();
+  }
+  ctx_->rec_->BeginDeferred(buf);
+  try {
+    (tl->*phase)();
+  } catch (...) {
+    ctx_->rec_->EndDeferred();
+    throw;
+  }
+  ctx_->rec_->EndDeferred();
+  if (wall != NULL) {
+    *wall = sw.wall();
+  }
+}
+
+void Timer::RecordPhase(const char* phase) {
+  if (!si_.record_timings) {
+    return;
+  }
+  ctx_->NewDatum("PhaseTimings")
+      ->AddVal("Time", time_)
+      ->AddVal("Phase", std::string(phase))
+      ->AddVal("WallTime", phase_sw_.wall())
+      ->AddVal("CpuTime", phase_sw_.cpu())
+      ->Record();
+  phase_sw_.Start();  // excludes the recording itself from the next phase
+}
+
+std::string Timer::ListenerSpec(TimeListener* tl) {
+  Agent* a = dynamic_cast<Agent*>(tl);
+  return a == NULL ? std::string() : a->spec();
+}
+
+void Timer::WakeListeners() {
+  while (!wake_queue_.empty() && wake_queue_.begin()->first <= time_) {
+    std::set<int>& ids = wake_queue_.begin()->second;
+    for (std::set<int>::iterator it = ids.begin(); it != ids.end(); ++it) {
+      awake_[*it] = tickers_[*it];
+      sleeping_.erase(*it);
+    }
+    wake_queue_.erase(wake_queue_.begin());
+  }
 }
 
+void Timer::SleepListeners() {
+  std::map<int, TimeListener*>::iterator it = awake_.begin();
+  while (it != awake_.end()) {
+    int t = it->second->NextWake(time_);
+    if (t > time_ + 1) {
+      sleeping_[it->first] = t;
+      wake_queue_[t].insert(it->first);
+      awake_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void Timer::Wake(TimeListener* tl) {
+  std::map<int, int>::iterator it = sleeping_.find(tl->id());
+  if (it == sleeping_.end()) {
+    return;
+  }
+
+  std::map<int, std::set<int> >::iterator q = wake_queue_.find(it->second);
+  q->second.erase(tl->id());
+  if (q->second.empty()) {
+    wake_queue_.erase(q);
+  }
+  sleeping_.erase(it);
+  awake_[tl->id()] = tl;
+}
+
+bool Timer::ThreadSafe(Agent* a) {
+  std::string spec = a->spec();
+  std::map<std::string, bool>::iterator it = safe_specs_.find(spec);
+  if (it != safe_specs_.end()) {
+    return it->second;
+  }
+
+  Json::Value anno = a->annotations();
+  bool safe = anno.isObject() && anno.isMember("thread_safe") &&
+              anno["thread_safe"].asBool();
+  safe_specs_[spec] = safe;
+  return safe;
+}
+
+void Timer::RecordInventories() {
+  CommitInventories();
+
+  bool changes = si_.explicit_inventory_changes;
+  std::vector<InvTally> tallies;
+  std::map<std::pair<int, std::string>, std::vector<int> > prints;
+  std::set<int> live;
+  AgentRegistry::iterator it;
+  for (it = ctx_->live_agents_.begin(); it != ctx_->live_agents_.end(); ++it) {
+    Agent* a = *it;
+    TallyInventories(a, &tallies, &prints);
+    if (changes) {
+      live.insert(a->id());
+    }
+  }
+
+  if (changes) {
+    // inventories of live agents that were emptied since last recorded
+    std::map<std::pair<int, std::string>, std::vector<int> >::iterator p;
+    for (p = inv_prints_.begin(); p != inv_prints_.end(); ++p) {
+      if (prints.count(p->first) == 0 && live.count(p->first.first) > 0) {
+        InvTally t;
+        t.agent = p->first.first;
+        t.name = p->first.second;
+        tallies.push_back(t);
+      }
+    }
+    inv_prints_.swap(prints);
+  }
 
-void Timer::RecordInventories(Agent* a) {
+  if (pool_ != NULL) {
+    inv_done_ = std::async(std::launch::async, &Timer::RecordTalliesDeferred,
+                           this, std::move(tallies), time_);
+  } else {
+    RecordTallies(tallies, time_);
+  }
+}
+
+void Timer::TallyInventories(
+    Agent* a, std::vector<InvTally>* tallies,
+    std::map<std::pair<int, std::string>, std::vector<int> >* prints) {
+  bool changes = si_.explicit_inventory_changes;
+  bool lazy = si_.decay == "lazy";
   Inventories invs = a->SnapshotInv();
   Inventories::iterator it2;
   for (it2 = invs.begin(); it2 != invs.end(); ++it2) {
-    std::string name = it2->first;
-    std::vector<Resource::Ptr> mats = it2->second;
+    std::vector<Resource::Ptr>& mats = it2->second;
     if (mats.empty() || ResCast<Material>(mats[0]) == NULL) {
       continue; // skip non-material inventories
     }
 
-    Material::Ptr m = ResCast<Material>(mats[0]->Clone());
-    for (int i = 1; i < mats.size(); i++) {
-      m->Absorb(ResCast<Material>(mats[i]->Clone()));
+    InvTally t;
+    t.agent = a->id();
+    t.name = it2->first;
+    t.mats.reserve(mats.size());
+    std::vector<int> print;
+    for (int i = 0; i < mats.size(); i++) {
+      Material::Ptr m = ResCast<Material>(mats[i]);
+      // lazily decayed materials are decayed on a copy so that recording
+      // doesn't modify the agent's inventory
+      Composition::Ptr c = lazy ? ResCast<Material>(m->Clone())->comp() :
+                                  m->comp();
+      c->mass();  // force lazy evaluation before c may be read on another thread
+      t.mats.push_back(std::make_pair(m->quantity(), c));
+      if (changes) {
+        print.push_back(m->state_id());
+        print.push_back(c->id());
+      }
     }
-    RecordInventory(a, name, m);
+
+    if (changes) {
+      std::pair<int, std::string> key(t.agent, t.name);
+      std::map<std::pair<int, std::string>, std::vector<int> >::iterator old =
+          inv_prints_.find(key);
+      bool same = old != inv_prints_.end() && old->second == print;
+      (*prints)[key].swap(print);
+      if (same) {
+        continue;
+      }
+    }
+    tallies->push_back(t);
   }
 }
 
-void Timer::RecordInventory(Agent* a, std::string name, Material::Ptr m) {
-  if (si_.explicit_inventory) {
-    CompMap c = m->comp()->mass();
-    compmath::Normalize(&c, m->quantity());
-    CompMap::iterator it;
-    for (it = c.begin(); it != c.end(); ++it) {
-      ctx_->NewDatum("ExplicitInventory")
-          ->AddVal("AgentId", a->id())
-          ->AddVal("Time", time_)
-          ->AddVal("InventoryName", name)
-          ->AddVal("NucId", it->first)
-          ->AddVal("Quantity", it->second)
+void Timer::RecordTallies(const std::vector<InvTally>& tallies, int time) {
+  bool changes = si_.explicit_inventory_changes;
+  for (int i = 0; i < tallies.size(); ++i) {
+    const InvTally& t = tallies[i];
+
+    // sum up the materials' compositions as Material::Absorb would, without
+    // creating any intermediate materials
+    CompMap c;
+    double qty = 0;
+    for (int j = 0; j < t.mats.size(); ++j) {
+      const CompMap& m = t.mats[j].second->mass();
+      double tot = 0;
+      CompMap::const_iterator it;
+      for (it = m.begin(); it != m.end(); ++it) {
+        tot += it->second;
+      }
+      if (tot <= 0) {
+        continue;
+      }
+      double scale = t.mats[j].first / tot;
+      for (it = m.begin(); it != m.end(); ++it) {
+        c[it->first] += it->second * scale;
+      }
+      qty += t.mats[j].first;
+    }
+
+    if (si_.explicit_inventory) {
+      CompMap rows = c;
+      if (changes) {
+        // nuclides that have left the inventory are recorded as zero
+        std::set<Nuc>& nucs = inv_nucs_[std::make_pair(t.agent, t.name)];
+        std::set<Nuc>::iterator n;
+        for (n = nucs.begin(); n != nucs.end(); ++n) {
+          rows.insert(std::make_pair(*n, 0.0));
+        }
+        nucs.clear();
+        CompMap::iterator it;
+        for (it = c.begin(); it != c.end(); ++it) {
+          nucs.insert(nucs.end(), it->first);
+        }
+      }
+
+      CompMap::iterator it;
+      for (it = rows.begin(); it != rows.end(); ++it) {
+        ctx_->NewDatum("ExplicitInventory")
+            ->AddVal("AgentId", t.agent)
+            ->AddVal("Time", time)
+            ->AddVal("InventoryName", t.name)
+            ->AddVal("NucId", it->first)
+            ->AddVal("Quantity", it->second)
+            ->Record();
+      }
+    }
+
+    if (si_.explicit_inventory_compact) {
+      if (!c.empty()) {
+        compmath::Normalize(&c, 1);
+      }
+      ctx_->NewDatum("ExplicitInventoryCompact")
+          ->AddVal("AgentId", t.agent)
+          ->AddVal("Time", time)
+          ->AddVal("InventoryName", t.name)
+          ->AddVal("Quantity", qty)
+          ->AddVal("Composition", c)
           ->Record();
     }
   }
+}
 
-  if (si_.explicit_inventory_compact) {
-    CompMap c = m->comp()->mass();
-    compmath::Normalize(&c, 1);
-    ctx_->NewDatum("ExplicitInventoryCompact")
-        ->AddVal("AgentId", a->id())
-        ->AddVal("Time", time_)
-        ->AddVal("InventoryName", name)
-        ->AddVal("Quantity", m->quantity())
-        ->AddVal("Composition", c)
-        ->Record();
+void Timer::RecordTalliesDeferred(std::vector<InvTally> tallies, int time) {
+  ctx_->rec_->BeginDeferred(&inv_buf_);
+  try {
+    RecordTallies(tallies, time);
+  } catch (...) {
+    ctx_->rec_->EndDeferred();
+    throw;
   }
+  ctx_->rec_->EndDeferred();
+}
+
+void Timer::CommitInventories() {
+  if (!inv_done_.valid()) {
+    return;
+  }
+  inv_done_.get();
+  ctx_->rec_->CommitDeferred(&inv_buf_);
 }
 
 void Timer::DoDecom() {
   // decommission queued agents
-  std::vector<Agent*> decom_list = decom_queue_[time_];
-  for (int i = 0; i < decom_list.size(); ++i) {
-    Agent* m = decom_list[i];
+  while (!decom_queue_.empty() && decom_queue_.begin()->first.first <= time_) {
+    Agent* m = decom_queue_.begin()->second;
+    decom_queue_.erase(decom_queue_.begin());
+    decom_index_.erase(m);
+
     if (m->parent() != NULL) {
       m->parent()->DecomNotify(m);
     }
@@ -164,17 +569,41 @@ void Timer::DoDecom() {
 
 void Timer::RegisterTimeListener(TimeListener* agent) {
   tickers_[agent->id()] = agent;
+  awake_[agent->id()] = agent;
+  Agent* a = dynamic_cast<Agent*>(agent);
+  if (a != NULL && ThreadSafe(a)) {
+    concurrent_.insert(agent->id());
+  }
 }
 
 void Timer::UnregisterTimeListener(TimeListener* tl) {
+  Wake(tl);  // removes it from the wake queue
+  awake_.erase(tl->id());
   tickers_.erase(tl->id());
+  concurrent_.erase(tl->id());
 }
 
 void Timer::SchedBuild(Agent* parent, std::string proto_name, int t) {
   if (t <= time_) {
     throw ValueError("Cannot schedule build for t < [current-time]");
   }
-  build_queue_[t].push_back(std::make_pair(proto_name, parent));
+  build_queue_.insert(build_queue_.upper_bound(t),
+                      std::make_pair(t, std::make_pair(proto_name, parent)));
+}
+
+void Timer::SchedBuilds(Agent* parent, const std::vector<std::string>& protos,
+                        int t) {
+  if (t <= time_) {
+    throw ValueError("Cannot schedule build for t < [current-time]");
+  }
+  // inserting just before the hint appends each build after those already
+  // scheduled for t in amortized constant time
+  std::multimap<int, std::pair<std::string, Agent*> >::iterator hint =
+      build_queue_.upper_bound(t);
+  for (int i = 0; i < protos.size(); ++i) {
+    build_queue_.insert(hint,
+                        std::make_pair(t, std::make_pair(protos[i], parent)));
+  }
 }
 
 void Timer::SchedDecom(Agent* m, int t) {
@@ -187,25 +616,33 @@ void Timer::SchedDecom(Agent* m, int t) {
   // - the duplicate entries will result in a double delete attempt and
   // segfaults and otherwise bad things.  Remove previous decommissionings
   // before scheduling this new one.
-  std::map<int, std::vector<Agent*> >::iterator it;
-  bool done = false;
-  for (it = decom_queue_.begin(); it != decom_queue_.end(); ++it) {
-    int t = it->first;
-    std::vector<Agent*> ags = it->second;
-    for (int i = 0; i < ags.size(); i++) {
-      if (ags[i] == m) {
-        CLOG(LEV_WARN) << "scheduled over previous decommissioning of " << m->id();
-        decom_queue_[t].erase(decom_queue_[t].begin()+i);
-        done = true;
-        break;
-      }
-    }
-    if (done) {
-      break;
-    }
+  if (CancelDecom(m)) {
+    CLOG(LEV_WARN) << "scheduled over previous decommissioning of " << m->id();
+  }
+
+  std::pair<int, unsigned long> key = std::make_pair(t, decom_seq_++);
+  decom_queue_[key] = m;
+  decom_index_[m] = key;
+}
+
+void Timer::SchedDecoms(const std::vector<Agent*>& ms, int t) {
+  if (t < time_) {
+    throw ValueError("Cannot schedule decommission for t < [current-time]");
+  }
+  for (int i = 0; i < ms.size(); ++i) {
+    SchedDecom(ms[i], t);
   }
+}
 
-  decom_queue_[t].push_back(m);
+bool Timer::CancelDecom(Agent* m) {
+  std::map<Agent*, std::pair<int, unsigned long> >::iterator it =
+      decom_index_.find(m);
+  if (it == decom_index_.end()) {
+    return false;
+  }
+  decom_queue_.erase(it->second);
+  decom_index_.erase(it);
+  return true;
 }
 
 int Timer::time() {
@@ -214,8 +651,18 @@ int Timer::time() {
 
 void Timer::Reset() {
   tickers_.clear();
+  awake_.clear();
+  sleeping_.clear();
+  wake_queue_.clear();
+  concurrent_.clear();
+  safe_specs_.clear();
+  market_solvers_.clear();
+  markets_.clear();
+  inv_prints_.clear();
+  inv_nucs_.clear();
   build_queue_.clear();
   decom_queue_.clear();
+  decom_index_.clear();
   si_ = SimInfo(0);
 }
 
@@ -238,6 +685,13 @@ int Timer::dur() {
   return si_.duration;
 }
 
-Timer::Timer() : time_(0), si_(0), want_snapshot_(false), want_kill_(false) {}
+Timer::Timer()
+    : time_(0),
+      si_(0),
+      want_snapshot_(false),
+      want_kill_(false),
+      pool_(NULL),
+      concurrent_markets_(false),
+      decom_seq_(0) {}
 
 }  // namespace cyclus
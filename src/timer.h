@@ -1,6 +1,10 @@
 #ifndef CYCLUS_SRC_TIMER_H_
 #define CYCLUS_SRC_TIMER_H_
 
+#include <future>
+#include <map>
+#include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -9,6 +13,9 @@
 #include "product.h"
 #include "material.h"
 #include "infile_tree.h"
+#include "recorder.h"
+#include "stopwatch.h"
+#include "thread_pool.h"
 #include "time_listener.h"
 #include "comp_math.h"
 
@@ -43,15 +50,43 @@ class Timer {
   /// Agents should unregister from their Decommission method.
   void UnregisterTimeListener(TimeListener* tl);
 
+  /// Wakes a sleeping listener (see TimeListener::NextWake) so that it takes
+  /// part in all phases of the current timestep that have not yet run. Does
+  /// nothing if the listener is already awake.
+  void Wake(TimeListener* tl);
+
+  /// Registers a market to be executed every timestep after the Material and
+  /// Product markets, in registration order. If markets are solved
+  /// concurrently (see ExchangeSolver::concurrent_markets), it is given its
+  /// own clone of the simulation's solver while the simulation runs.
+  void RegisterMarket(Market* m);
+
+  /// Removes a market from being executed every timestep.
+  void UnregisterMarket(Market* m);
+
 
   /// Schedules the named prototype to be built for the specified parent at
   /// timestep t.
   void SchedBuild(Agent* parent, std::string proto_name, int t);
 
+  /// Schedules each of the named prototypes to be built for the specified
+  /// parent at timestep t. Builds are performed in the given order.
+  void SchedBuilds(Agent* parent, const std::vector<std::string>& protos,
+                   int t);
+
   /// Schedules the given Agent to be decommissioned at the specified
-  /// timestep t.
+  /// timestep t. Any previously scheduled decommissioning of the agent is
+  /// replaced.
   void SchedDecom(Agent* m, int time);
 
+  /// Schedules each of the given agents to be decommissioned at timestep t.
+  void SchedDecoms(const std::vector<Agent*>& ms, int t);
+
+  /// Cancels the scheduled decommissioning of the given agent.
+  ///
+  /// @return false if no decommissioning was scheduled for the agent
+  bool CancelDecom(Agent* m);
+
   /// Schedules a snapshot of simulation state to output database to occur at
   /// the beginning of the next timestep.
   void Snapshot() { want_snapshot_ = true; }
@@ -69,6 +104,18 @@ class Timer {
   /// @return the duration, in months
   int dur();
 
+  /// Sets the number of threads used to run the Tick and Tock phases of
+  /// thread-safe agents. Takes effect at the next call to RunSim.
+  void threads(int n) { si_.threads = n; }
+
+  /// Returns the thread pool of the running simulation, or NULL if the
+  /// simulation runs serially or isn't running.
+  ThreadPool* pool() { return pool_; }
+
+  /// Returns true if the agent's archetype is annotated as thread-safe (i.e.
+  /// has a true "thread_safe" class-level annotation).
+  bool ThreadSafe(Agent* a);
+
  private:
   /// builds all agents queued for the current timestep.
   void DoBuild();
@@ -77,16 +124,85 @@ class Timer {
   /// notifications.
   void DoTick();
 
-  /// Runs the resource exchange process for all traders.
-  void DoResEx(ExchangeManager<Material>* matmgr,
-               ExchangeManager<Product>* genmgr);
+  /// Runs the resource exchange process for all traders, one market (i.e.
+  /// resource type) after another, the built-in markets followed by the
+  /// registered ones. If concurrent_markets_ is set, the requests and bids
+  /// of all markets are collected first, in order, then the markets are
+  /// solved concurrently, and then their trades are executed in order.
+  /// Agents are never called concurrently and the output is deterministic,
+  /// but a market is collected before the trades of the markets before it
+  /// are executed, so the output may differ from that of a serial run (see
+  /// ExchangeSolver::concurrent_markets).
+  void DoResEx(const std::vector<Market*>& builtin);
+
+  /// Resets the solvers of the registered markets and discards the clones
+  /// that solve the markets concurrently.
+  void ClearMarketSolvers();
+
+  /// Solves a market, deferring its recorded data into buf.
+  void SolveDeferred(Market* m, DatumList* buf);
 
   /// sends the tock signal to all of the agents receiving time
   /// notifications.
   void DoTock();
 
-  void RecordInventories(Agent* a);
-  void RecordInventory(Agent* a, std::string name, Material::Ptr m);
+  /// Invokes phase (i.e. Tick or Tock) on every awake listener in id order.
+  /// If a thread pool is in use, the listeners in concurrent_ are run on it
+  /// first, with their recorded data buffered and committed at their position
+  /// in the id order so that output is identical to a serial run. If timings
+  /// are recorded, the time spent in each archetype is recorded under the
+  /// given phase name.
+  void RunListeners(void (TimeListener::*phase)(), const char* name);
+
+  /// Runs phase for a single listener, deferring its recorded data into buf.
+  /// If wall is not NULL, it is set to the wall-clock time of the call.
+  void RunDeferred(void (TimeListener::*phase)(), TimeListener* tl,
+                   DatumList* buf, double* wall);
+
+  /// Records the time elapsed since the last recorded phase in the
+  /// PhaseTimings table, if timings are enabled.
+  void RecordPhase(const char* phase);
+
+  /// Returns the spec of the listener's archetype (empty for non-agents).
+  std::string ListenerSpec(TimeListener* tl);
+
+  /// moves all listeners due to wake at the current time into awake_.
+  void WakeListeners();
+
+  /// queries every awake listener for its next wake time and moves those that
+  /// are not needed next timestep into the wake queue.
+  void SleepListeners();
+
+  /// the materials of one named agent inventory, captured for recording
+  struct InvTally {
+    int agent;
+    std::string name;
+    /// the quantity and composition of each material in the inventory
+    std::vector<std::pair<double, Composition::Ptr> > mats;
+  };
+
+  /// records the explicit inventories of all live agents. The inventories
+  /// are captured on the calling thread, but the per-nuclide totals are
+  /// computed and recorded in the background if a thread pool is in use.
+  void RecordInventories();
+
+  /// captures the material inventories of a into tallies without copying
+  /// any materials. If only changes are recorded, the state of each
+  /// inventory is fingerprinted into prints and unchanged ones are skipped.
+  void TallyInventories(Agent* a, std::vector<InvTally>* tallies,
+                        std::map<std::pair<int, std::string>,
+                                 std::vector<int> >* prints);
+
+  /// computes the nuclide totals of the tallied inventories and records them.
+  /// Only touches tallies and inv_nucs_, so it may run on another thread.
+  void RecordTallies(const std::vector<InvTally>& tallies, int time);
+
+  /// RecordTallies with the recorded data deferred into inv_buf_.
+  void RecordTalliesDeferred(std::vector<InvTally> tallies, int time);
+
+  /// waits for any background inventory recording to finish and commits its
+  /// data to the recorder.
+  void CommitInventories();
 
   /// decommissions all agents queued for the current timestep.
   void DoDecom();
@@ -105,11 +221,63 @@ class Timer {
   /// Concrete agents that desire to receive tick and tock notifications
   std::map<int, TimeListener*> tickers_;
 
-  // std::map<time,std::vector<std::pair<prototype, parent> > >
-  std::map<int, std::vector<std::pair<std::string, Agent*> > > build_queue_;
+  /// listeners (by id) that receive tick and tock notifications this timestep
+  std::map<int, TimeListener*> awake_;
+
+  /// wake time of each sleeping listener (by id)
+  std::map<int, int> sleeping_;
+
+  // std::map<time, ids of listeners waking at time>
+  std::map<int, std::set<int> > wake_queue_;
+
+  /// ids of listeners that may be ticked and tocked concurrently
+  std::set<int> concurrent_;
+
+  /// cache of whether an archetype (by spec) is annotated as thread-safe
+  std::map<std::string, bool> safe_specs_;
+
+  /// the pool running concurrent listeners, NULL when running serially
+  ThreadPool* pool_;
+
+  /// markets executed after the built-in Material and Product markets
+  std::vector<Market*> markets_;
+
+  /// whether the markets of the running simulation are solved concurrently
+  bool concurrent_markets_;
+
+  /// the clones of the simulation's solver that solve the markets after the
+  /// first, by market, if they are solved concurrently
+  std::map<Market*, boost::shared_ptr<ExchangeSolver> > market_solvers_;
+
+  /// measures the time spent in the current phase when recording timings
+  Stopwatch phase_sw_;
+
+  // std::map<std::pair<agent id, inventory name>, resource state ids and
+  // composition ids of the inventory when it was last recorded>
+  std::map<std::pair<int, std::string>, std::vector<int> > inv_prints_;
+
+  // std::map<std::pair<agent id, inventory name>, nuclides last recorded>
+  std::map<std::pair<int, std::string>, std::set<Nuc> > inv_nucs_;
+
+  /// background inventory recording of the previous time step, if any
+  std::future<void> inv_done_;
+
+  /// data recorded by background inventory recording
+  DatumList inv_buf_;
+
+  // std::multimap<time, std::pair<prototype, parent> >, in scheduling order
+  // for each time
+  std::multimap<int, std::pair<std::string, Agent*> > build_queue_;
+
+  // std::map<std::pair<time, sequence number>, agent>
+  std::map<std::pair<int, unsigned long>, Agent*> decom_queue_;
+
+  // std::map<agent, key of the agent's entry in decom_queue_>
+  std::map<Agent*, std::pair<int, unsigned long> > decom_index_;
 
-  // std::map<time,std::vector<config> >
-  std::map<int, std::vector<Agent*> > decom_queue_;
+  /// sequence number of the next scheduled decommissioning; keeps
+  /// decommissionings at the same time in scheduling order
+  unsigned long decom_seq_;
 };
 
 }  // namespace cyclus
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "context.h"
+#include "time_listener.h"
 #include "trade.h"
 #include "trader.h"
 #include "trader_management.h"
@@ -68,6 +69,23 @@ class TradeExecutor {
       RecordTrades(ctx);
     }
     SendTradeResources(trade_ctx_);
+    if (ctx != NULL) {
+      WakeTraders(ctx);
+    }
+  }
+
+  /// @brief Wakes all sleeping traders that took part in a trade so that
+  /// they can handle the traded resources in their Tock
+  void WakeTraders(Context* ctx) {
+    std::set<Trader*>::iterator it;
+    for (it = trade_ctx_.suppliers.begin(); it != trade_ctx_.suppliers.end();
+         ++it) {
+      Wake(ctx, *it);
+    }
+    for (it = trade_ctx_.requesters.begin();
+         it != trade_ctx_.requesters.end(); ++it) {
+      Wake(ctx, *it);
+    }
   }
 
   /// @brief Record all trades with the appropriate backends
@@ -109,6 +127,13 @@ class TradeExecutor {
   }
 
  private:
+  void Wake(Context* ctx, Trader* trader) {
+    TimeListener* tl = dynamic_cast<TimeListener*>(trader->manager());
+    if (tl != NULL) {
+      ctx->Wake(tl);
+    }
+  }
+
   const std::vector< Trade<T> >& trades_;
   TradeExecutionContext<T> trade_ctx_;
 };
@@ -1,7 +1,9 @@
 #ifndef CYCLUS_SRC_TRADER_H_
 #define CYCLUS_SRC_TRADER_H_
 
+#include <map>
 #include <set>
+#include <string>
 
 #include "bid_portfolio.h"
 #include "composition.h"
@@ -13,6 +15,28 @@
 
 namespace cyclus {
 
+/// @brief the portfolios a trader returned in the last exchange of a resource
+/// type, which ResourceExchange reuses while the trader declares them
+/// unchanged (see Trader::MatlRequestsUnchanged and Trader::MatlBidsUnchanged)
+template <class T>
+struct PortfolioMemo {
+  PortfolioMemo() : requests_reused(false) {}
+
+  std::set<typename RequestPortfolio<T>::Ptr> requests;
+
+  /// whether the requests were reused in the current exchange
+  bool requests_reused;
+
+  std::set<typename BidPortfolio<T>::Ptr> bids;
+
+  /// the portfolios of the requests that the bids were made for
+  std::set<typename RequestPortfolio<T>::Ptr> bid_ports;
+
+  /// the number of requests of each of the bids' commodities, by commod_id,
+  /// in the exchange the bids were made in
+  std::map<int, int> bid_commods;
+};
+
 /// @class Trader
 ///
 /// @brief A simple API for agents that wish to exchange resources in the
@@ -53,10 +77,72 @@ class Trader {
     return std::set<BidPortfolio<Product>::Ptr>();
   }
 
-  /// default implementation for material preferences.
+  /// @brief whether ResourceExchange keeps the portfolios the trader returns
+  /// (see matl_memo), so that they can be reused in the next exchange if the
+  /// trader declares them unchanged, default false. Traders overriding
+  /// MatlRequestsUnchanged or the other *Unchanged functions must return true;
+  /// the portfolios of other traders are neither kept nor reused.
+  virtual bool MemoizesPortfolios() { return false; }
+
+  /// @brief whether the material requests of the trader are the same as those
+  /// it returned from GetMatlRequests in the last material exchange, default
+  /// false. If so, and the trader memoizes its portfolios (see
+  /// MemoizesPortfolios), GetMatlRequests is not called and the returned
+  /// portfolios are reused, so traders must not change them after returning
+  /// them. Portfolios are only reused if there are any.
+  virtual bool MatlRequestsUnchanged() { return false; }
+
+  /// @brief whether the product requests of the trader are the same as those
+  /// it returned from GetProductRequests in the last product exchange (see
+  /// MatlRequestsUnchanged), default false.
+  virtual bool ProductRequestsUnchanged() { return false; }
+
+  /// @brief whether the material bids of the trader are the same as those it
+  /// returned from GetMatlBids in the last material exchange, provided the
+  /// requests are, default false. If so, the returned portfolios are reused
+  /// instead of calling GetMatlBids when every request they bid on was reused
+  /// (see MatlRequestsUnchanged) and no requests of their commodities were
+  /// added or removed. Traders must not change the portfolios after
+  /// returning them. Portfolios are only reused if there are any.
+  virtual bool MatlBidsUnchanged() { return false; }
+
+  /// @brief whether the product bids of the trader are the same as those it
+  /// returned from GetProductBids in the last product exchange (see
+  /// MatlBidsUnchanged), default false.
+  virtual bool ProductBidsUnchanged() { return false; }
+
+  /// @brief the portfolios the trader returned in the last exchange of each
+  /// resource type, kept by ResourceExchange if the trader memoizes them
+  /// @{
+  inline PortfolioMemo<Material>& matl_memo() { return matl_memo_; }
+  inline PortfolioMemo<Product>& product_memo() { return product_memo_; }
+  /// @}
+
+  /// @brief default implementation for material preferences, which adjusts
+  /// them by the PrefMap form of AdjustMatlPrefs. Overrides of this form avoid
+  /// copying preferences into and out of a PrefMap and should not call the
+  /// default.
+  virtual void AdjustMatlPrefs(PrefView<Material>& prefs) {
+    void (Trader::*legacy)(PrefMap<Material>::type&) = &Trader::AdjustMatlPrefs;
+    prefs.AdjustLegacy(this, legacy);
+  }
+
+  /// @brief default implementation for product preferences, which adjusts
+  /// them by the PrefMap form of AdjustProductPrefs. Overrides of this form
+  /// avoid copying preferences into and out of a PrefMap and should not call
+  /// the default.
+  virtual void AdjustProductPrefs(PrefView<Product>& prefs) {
+    void (Trader::*legacy)(PrefMap<Product>::type&) =
+        &Trader::AdjustProductPrefs;
+    prefs.AdjustLegacy(this, legacy);
+  }
+
+  /// default implementation for material preferences in PrefMap form, which
+  /// does nothing.
   virtual void AdjustMatlPrefs(PrefMap<Material>::type& prefs) {}
 
-  /// default implementation for material preferences.
+  /// default implementation for product preferences in PrefMap form, which
+  /// does nothing.
   virtual void AdjustProductPrefs(PrefMap<Product>::type& prefs) {}
 
   /// @brief default implementation for responding to material trades
@@ -88,6 +174,9 @@ class Trader {
   Agent* manager_;
 
  private:
+  PortfolioMemo<Material> matl_memo_;
+  PortfolioMemo<Product> product_memo_;
+
   /// @warning this function is hidden to prevent an invalid signature that can
   /// raise difficult to find bugs
   virtual std::set<BidPortfolio<Material>::Ptr>
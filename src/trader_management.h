@@ -46,6 +46,52 @@ inline std::set<BidPortfolio<Product>::Ptr>
   return t->GetProductBids(map);
 }
 
+template<class T>
+inline static bool RequestsUnchanged(Trader* t) {
+  throw StateError("Non-specialized version of RequestsUnchanged not "
+                   "supported");
+}
+
+template<>
+inline bool RequestsUnchanged<Material>(Trader* t) {
+  return t->MatlRequestsUnchanged();
+}
+
+template<>
+inline bool RequestsUnchanged<Product>(Trader* t) {
+  return t->ProductRequestsUnchanged();
+}
+
+template<class T>
+inline static bool BidsUnchanged(Trader* t) {
+  throw StateError("Non-specialized version of BidsUnchanged not supported");
+}
+
+template<>
+inline bool BidsUnchanged<Material>(Trader* t) {
+  return t->MatlBidsUnchanged();
+}
+
+template<>
+inline bool BidsUnchanged<Product>(Trader* t) {
+  return t->ProductBidsUnchanged();
+}
+
+template<class T>
+inline static PortfolioMemo<T>& Memo(Trader* t) {
+  throw StateError("Non-specialized version of Memo not supported");
+}
+
+template<>
+inline PortfolioMemo<Material>& Memo<Material>(Trader* t) {
+  return t->matl_memo();
+}
+
+template<>
+inline PortfolioMemo<Product>& Memo<Product>(Trader* t) {
+  return t->product_memo();
+}
+
 template<class T>
 inline static void PopulateTradeResponses(
     Trader* trader,
@@ -216,8 +216,14 @@ void XMLFileLoader::LoadSolver() {
   string config = "config";
   string greedy = "greedy";
   string coinor = "coin-or";
+  string priority_greedy = "priority-greedy";
+  string adaptive = "adaptive";
   string solver_name = greedy;
   bool exclusive = ExchangeSolver::kDefaultExclusive;
+  bool decompose = false;
+  bool aggregate = false;
+  bool incremental = false;
+  bool concurrent_markets = false;
   if (xqe.NMatches("/*/control/solver") == 1) {
     qe = xqe.SubTree("/*/control/solver");
     if (qe->NMatches(config) == 1) {
@@ -225,6 +231,12 @@ void XMLFileLoader::LoadSolver() {
     }
     exclusive = cyclus::OptionalQuery<bool>(qe, "allow_exclusive_orders", 
                                             exclusive);
+    decompose = cyclus::OptionalQuery<bool>(qe, "decompose", decompose);
+    aggregate = cyclus::OptionalQuery<bool>(qe, "aggregate", aggregate);
+    incremental = cyclus::OptionalQuery<bool>(qe, "incremental",
+                                              incremental);
+    concurrent_markets = cyclus::OptionalQuery<bool>(
+        qe, "concurrent_markets", concurrent_markets);
     
     // @TODO remove this after release 1.5
     // check for deprecated input values
@@ -247,11 +259,15 @@ void XMLFileLoader::LoadSolver() {
   ctx_->NewDatum("SolverInfo")
       ->AddVal("Solver", solver_name)
       ->AddVal("ExclusiveOrders", exclusive)
+      ->AddVal("Decompose", decompose)
+      ->AddVal("Aggregate", aggregate)
+      ->AddVal("Incremental", incremental)
+      ->AddVal("ConcurrentMarkets", concurrent_markets)
       ->Record();  
   
   // now load the actual solver
-  if (solver_name == greedy) {
-    query = string("/*/control/solver/config/greedy/preconditioner");
+  if (solver_name == greedy || solver_name == priority_greedy) {
+    query = "/*/control/solver/config/" + solver_name + "/preconditioner";
     string precon_name = cyclus::OptionalQuery<string>(&xqe, query, greedy);
     ctx_->NewDatum("GreedySolverInfo")
       ->AddVal("Preconditioner", precon_name)
@@ -263,10 +279,25 @@ void XMLFileLoader::LoadSolver() {
     bool verbose = cyclus::OptionalQuery<bool>(&xqe, query, false);
     query = string("/*/control/solver/config/coin-or/mps");
     bool mps = cyclus::OptionalQuery<bool>(&xqe, query, false);
+    query = string("/*/control/solver/config/coin-or/persistent");
+    bool persistent = cyclus::OptionalQuery<bool>(&xqe, query, false);
+    query = string("/*/control/solver/config/coin-or/relax");
+    bool relax = cyclus::OptionalQuery<bool>(&xqe, query, false);
     ctx_->NewDatum("CoinSolverInfo")
       ->AddVal("Timeout", timeout)
       ->AddVal("Verbose", verbose)
       ->AddVal("Mps", mps)
+      ->AddVal("Persistent", persistent)
+      ->AddVal("Relax", relax)
+      ->Record();
+  } else if (solver_name == adaptive) {
+    query = string("/*/control/solver/config/adaptive/budget");
+    double budget = cyclus::OptionalQuery<double>(&xqe, query, -1);
+    query = string("/*/control/solver/config/adaptive/max_arcs");
+    int max_arcs = cyclus::OptionalQuery<int>(&xqe, query, -1);
+    ctx_->NewDatum("AdaptiveSolverInfo")
+      ->AddVal("Budget", budget)
+      ->AddVal("MaxArcs", max_arcs)
       ->Record();
   } else {
     throw ValueError("unknown solver name: " + solver_name);
@@ -423,6 +454,8 @@ void XMLFileLoader::LoadControlParams() {
 
   si.explicit_inventory = OptionalQuery<bool>(qe, "explicit_inventory", false);
   si.explicit_inventory_compact = OptionalQuery<bool>(qe, "explicit_inventory_compact", false);
+  si.explicit_inventory_changes = OptionalQuery<bool>(qe, "explicit_inventory_changes", false);
+  si.record_timings = OptionalQuery<bool>(qe, "record_timings", false);
 
   // get time step duration
   si.dt = OptionalQuery<int>(qe, "dt", kDefaultTimeStepDur);
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "adaptive_solver.h"
+#include "exchange_graph.h"
+#include "exchange_test_cases.h"
+#include "greedy_solver.h"
+
+using cyclus::AdaptiveSolver;
+using cyclus::Arc;
+using cyclus::ExchangeGraph;
+using cyclus::ExchangeNode;
+using cyclus::ExchangeNodeGroup;
+using cyclus::GreedySolver;
+using cyclus::Match;
+using cyclus::RequestGroup;
+
+namespace {
+
+/// n requesters of exclusive orders of 1 contest a supplier of n / 2
+void ConstructExclusive(ExchangeGraph* g, int n) {
+  ExchangeNode::Ptr v(new ExchangeNode(n / 2.0));
+  ExchangeNodeGroup::Ptr sup(new ExchangeNodeGroup());
+  sup->AddExchangeNode(v);
+  sup->AddCapacity(n / 2.0);
+  g->AddSupplyGroup(sup);
+  for (int i = 0; i < n; i++) {
+    ExchangeNode::Ptr u(new ExchangeNode(1, true, "commod", i));
+    Arc a(u, v);
+    a.pref(1 + i % 3);
+    u->prefs[a] = a.pref();
+    u->unit_capacities[a].push_back(1);
+    v->unit_capacities[a].push_back(1);
+    RequestGroup::Ptr req(new RequestGroup(1));
+    req->AddExchangeNode(u);
+    req->AddCapacity(1);
+    g->AddRequestGroup(req);
+    g->AddArc(a);
+  }
+}
+
+}  // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(AdaptiveSolverTests, Defaults) {
+  AdaptiveSolver s;
+  EXPECT_EQ(AdaptiveSolver::kDefaultBudget, s.budget());
+  EXPECT_EQ(AdaptiveSolver::kDefaultMaxArcs, s.max_arcs());
+  EXPECT_EQ("", s.path());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(AdaptiveSolverTests, Paths) {
+  ExchangeGraph g;
+  cyclus::ConstructMarkets(&g, 2);
+  AdaptiveSolver lp(true);
+  lp.Solve(&g);
+  EXPECT_EQ("lp", lp.path());
+  EXPECT_FALSE(g.matches().empty());
+
+  ExchangeGraph excl;
+  ConstructExclusive(&excl, 6);
+  AdaptiveSolver milp(true);
+  milp.Solve(&excl);
+  EXPECT_EQ("milp", milp.path());
+  EXPECT_EQ(3, excl.matches().size());
+
+  // exclusive arcs are relaxed if exclusive orders are not allowed
+  excl.ClearMatches();
+  AdaptiveSolver relaxed(false);
+  relaxed.Solve(&excl);
+  EXPECT_EQ("lp", relaxed.path());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(AdaptiveSolverTests, Greedy) {
+  ExchangeGraph g;
+  cyclus::ConstructMarkets(&g, 3);
+  GreedySolver greedy(true);
+  double exp_obj = greedy.Solve(&g);
+  std::vector<Match> exp = g.matches();
+  g.ClearMatches();
+
+  AdaptiveSolver s(AdaptiveSolver::kDefaultBudget, g.arcs().size() - 1, true);
+  EXPECT_DOUBLE_EQ(exp_obj, s.Solve(&g));
+  EXPECT_EQ("greedy", s.path());
+  EXPECT_EQ(exp, g.matches());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(AdaptiveSolverTests, Fallback) {
+  ExchangeGraph g;
+  ConstructExclusive(&g, 20);
+  GreedySolver greedy(true);
+  greedy.Solve(&g);
+  std::vector<Match> exp = g.matches();
+  g.ClearMatches();
+
+  // the budget runs out before the program's first solution is found
+  AdaptiveSolver s(1e-9, AdaptiveSolver::kDefaultMaxArcs, true);
+  s.Solve(&g);
+  EXPECT_EQ("milp-fallback", s.path());
+  EXPECT_EQ(exp, g.matches());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(AdaptiveSolverTests, Clone) {
+  AdaptiveSolver s(10, 100, false);
+  cyclus::ExchangeSolver* c = s.Clone();
+  AdaptiveSolver* a = dynamic_cast<AdaptiveSolver*>(c);
+  ASSERT_TRUE(a != NULL);
+  EXPECT_EQ(10, a->budget());
+  EXPECT_EQ(100, a->max_arcs());
+  delete c;
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include "arena.h"
+#include "exchange_graph.h"
+
+using cyclus::Arena;
+using cyclus::ArenaAllocator;
+using cyclus::ExchangeNode;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ArenaTests, Allocate) {
+  Arena a;
+  EXPECT_EQ(0, a.n_blocks());
+  char* c = static_cast<char*>(a.Allocate(1, 1));
+  double* d = static_cast<double*>(a.Allocate(sizeof(double), alignof(double)));
+  EXPECT_EQ(1, a.n_blocks());
+  EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(d) % alignof(double));
+  EXPECT_TRUE(reinterpret_cast<char*>(d) > c);
+  *d = 1.5;
+  *c = 'a';
+  EXPECT_DOUBLE_EQ(1.5, *d);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ArenaTests, Blocks) {
+  Arena a(1024);
+  // blocks of 256, 512, 1024, and 1024 bytes
+  for (int i = 0; i < 22; i++) {
+    a.Allocate(128, 8);
+  }
+  EXPECT_EQ(4, a.n_blocks());
+
+  // larger allocations get a block of their own
+  a.Allocate(4096, 8);
+  EXPECT_EQ(5, a.n_blocks());
+
+  a.Reset();
+  EXPECT_EQ(1, a.n_blocks());
+  for (int i = 0; i < 32; i++) {
+    a.Allocate(128, 8);
+  }
+  EXPECT_EQ(1, a.n_blocks());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ArenaTests, Allocator) {
+  boost::shared_ptr<Arena> arena(new Arena());
+  boost::weak_ptr<Arena> weak = arena;
+  ExchangeNode::Ptr n = boost::allocate_shared<ExchangeNode>(
+      ArenaAllocator<ExchangeNode>(arena), 2, true, "commod", 3);
+  EXPECT_DOUBLE_EQ(2, n->qty);
+  EXPECT_TRUE(n->exclusive);
+  EXPECT_EQ("commod", n->commod);
+  EXPECT_EQ(3, n->agent_id);
+  EXPECT_EQ(1, arena->n_blocks());
+
+  // the arena is kept alive by the node
+  arena.reset();
+  EXPECT_FALSE(weak.expired());
+  n.reset();
+  EXPECT_TRUE(weak.expired());
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+
+#include "commodity_table.h"
+#include "error.h"
+
+using cyclus::CommodityTable;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CommodityTableTests, Intern) {
+  CommodityTable t;
+  EXPECT_EQ(0, t.size());
+  EXPECT_EQ(0, t.Intern("uox"));
+  EXPECT_EQ(1, t.Intern("mox"));
+  EXPECT_EQ(0, t.Intern("uox"));
+  EXPECT_EQ(2, t.Intern(""));
+  EXPECT_EQ(3, t.size());
+  EXPECT_EQ("uox", t.Name(0));
+  EXPECT_EQ("mox", t.Name(1));
+  EXPECT_EQ("", t.Name(2));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CommodityTableTests, Find) {
+  CommodityTable t;
+  EXPECT_EQ(-1, t.Find("uox"));
+  t.Intern("uox");
+  EXPECT_EQ(0, t.Find("uox"));
+  EXPECT_EQ(-1, t.Find("mox"));
+  EXPECT_EQ(1, t.size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(CommodityTableTests, BadId) {
+  CommodityTable t;
+  t.Intern("uox");
+  EXPECT_THROW(t.Name(-1), cyclus::KeyError);
+  EXPECT_THROW(t.Name(1), cyclus::KeyError);
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include "conversion_cache.h"
+
+using cyclus::ConversionCache;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ConversionCacheTests, Offers) {
+  ConversionCache cache;
+  int conv1, conv2, offer1, offer2;
+  double val = -1;
+  EXPECT_FALSE(cache.Find(&conv1, &offer1, -1, 1, &val));
+  cache.Add(&conv1, &offer1, -1, 1, 3);
+  EXPECT_EQ(1, cache.n_converted());
+
+  EXPECT_TRUE(cache.Find(&conv1, &offer1, -1, 1, &val));
+  EXPECT_DOUBLE_EQ(3, val);
+  EXPECT_EQ(1, cache.n_reused());
+
+  // conversions are kept per converter and, without a composition, per offer
+  EXPECT_FALSE(cache.Find(&conv2, &offer1, -1, 1, &val));
+  EXPECT_FALSE(cache.Find(&conv1, &offer2, -1, 1, &val));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ConversionCacheTests, Compositions) {
+  ConversionCache cache;
+  int conv1, conv2, offer1, offer2, offer3;
+  double val = -1;
+  cache.Add(&conv1, &offer1, 7, 2, 5);
+
+  // offers of the same composition and quantity share their conversion
+  EXPECT_TRUE(cache.Find(&conv1, &offer2, 7, 2, &val));
+  EXPECT_DOUBLE_EQ(5, val);
+  EXPECT_FALSE(cache.Find(&conv1, &offer3, 7, 3, &val));
+  EXPECT_FALSE(cache.Find(&conv1, &offer3, 8, 2, &val));
+  EXPECT_FALSE(cache.Find(&conv2, &offer3, 7, 2, &val));
+  EXPECT_EQ(1, cache.n_reused());
+  EXPECT_EQ(1, cache.n_converted());
+}
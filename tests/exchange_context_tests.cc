@@ -111,6 +111,37 @@ TEST_F(ExchangeContextTests, AddRequest2) {
   EXPECT_EQ(vr, context.commod_requests[commod1]);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ExchangeContextTests, CommodIds) {
+  Request<Resource>* req3 = rp2->AddRequest(get_mat(), fac2, "commod3");
+  EXPECT_EQ(-1, req1->commod_id());
+
+  // contexts sharing a table agree on ids
+  cyclus::CommodityTable table;
+  table.Intern("commod3");
+  ExchangeContext<Resource> context1(&table);
+  ExchangeContext<Resource> context2(&table);
+  context1.AddRequestPortfolio(rp1);
+  context2.AddRequestPortfolio(rp2);
+  EXPECT_EQ(1, req1->commod_id());
+  EXPECT_EQ(1, req2->commod_id());
+  EXPECT_EQ(0, req3->commod_id());
+  EXPECT_EQ(2, table.size());
+  ASSERT_EQ(2, context1.n_commod_requests.size());
+  EXPECT_EQ(0, context1.n_commod_requests[0]);
+  EXPECT_EQ(1, context1.n_commod_requests[1]);
+  ASSERT_EQ(2, context2.n_commod_requests.size());
+  EXPECT_EQ(1, context2.n_commod_requests[0]);
+  EXPECT_EQ(1, context2.n_commod_requests[1]);
+
+  // a context has a table of its own by default
+  ExchangeContext<Resource> context3;
+  context3.AddRequestPortfolio(rp2);
+  EXPECT_EQ(0, req2->commod_id());
+  EXPECT_EQ(1, req3->commod_id());
+  EXPECT_EQ(2, context3.commodities->size());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST_F(ExchangeContextTests, AddRequest3) {
   // 2 requests for 2 commod
@@ -162,10 +193,10 @@ TEST_F(ExchangeContextTests, AddBid1) {
 
   PrefMap<Resource>::type obs;
   obs[req1].insert(std::make_pair(bid, req1->preference()));
-  EXPECT_EQ(context.trader_prefs[req1->requester()], obs);
+  EXPECT_EQ(context.prefs.Map(req1->requester()), obs);
   obs.clear();
   obs[req1].insert(std::make_pair(bid, req1->preference() * 0.1));
-  EXPECT_NE(context.trader_prefs[req1->requester()], obs);
+  EXPECT_NE(context.prefs.Map(req1->requester()), obs);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "exchange_graph.h"
+#include "exchange_graph_aggregator.h"
+#include "greedy_solver.h"
+
+using cyclus::Arc;
+using cyclus::ExchangeGraph;
+using cyclus::ExchangeGraphAggregator;
+using cyclus::ExchangeNode;
+using cyclus::ExchangeNodeGroup;
+using cyclus::GreedySolver;
+using cyclus::Match;
+using cyclus::RequestGroup;
+
+namespace {
+
+/// adds a request group of one node of quantity qty with an arc to a new bid
+/// node of quantity 2 in a supply group, returning the arc
+Arc AddOrder(ExchangeGraph* g, ExchangeNodeGroup::Ptr supply, double qty,
+             double pref, bool exclusive) {
+  ExchangeNode::Ptr u(new ExchangeNode(qty, exclusive, "uox", 1));
+  ExchangeNode::Ptr v(new ExchangeNode(2, false, "uox", 2));
+  RequestGroup::Ptr r(new RequestGroup(qty));
+  r->AddExchangeNode(u);
+  r->AddCapacity(qty);
+  supply->AddExchangeNode(v);
+
+  Arc a(u, v);
+  a.pref(pref);
+  u->prefs[a] = pref;
+  u->unit_capacities[a].push_back(1);
+  v->unit_capacities[a].push_back(1);
+  g->AddRequestGroup(r);
+  g->AddArc(a);
+  return a;
+}
+
+}  // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeGraphAggregatorTests, Identical) {
+  ExchangeGraph::Ptr g(new ExchangeGraph());
+  ExchangeNodeGroup::Ptr s(new ExchangeNodeGroup());
+  s->AddCapacity(5);
+  g->AddSupplyGroup(s);
+  std::vector<Arc> arcs;
+  for (int i = 0; i < 3; i++) {
+    arcs.push_back(AddOrder(g.get(), s, 1, 1, false));
+  }
+
+  ExchangeGraphAggregator agg(g);
+  ExchangeGraph::Ptr r = agg.reduced();
+  EXPECT_EQ(2, agg.n_merged());
+  ASSERT_EQ(1, r->request_groups().size());
+  ASSERT_EQ(1, r->supply_groups().size());
+  ASSERT_EQ(1, r->arcs().size());
+
+  RequestGroup::Ptr rg = r->request_groups()[0];
+  EXPECT_DOUBLE_EQ(3, rg->qty());
+  ASSERT_EQ(1, rg->capacities().size());
+  EXPECT_DOUBLE_EQ(3, rg->capacities()[0]);
+  ASSERT_EQ(1, rg->nodes().size());
+  EXPECT_DOUBLE_EQ(3, rg->nodes()[0]->qty);
+  ASSERT_EQ(1, r->supply_groups()[0]->nodes().size());
+  EXPECT_DOUBLE_EQ(6, r->supply_groups()[0]->nodes()[0]->qty);
+  EXPECT_DOUBLE_EQ(5, r->supply_groups()[0]->capacities()[0]);
+
+  const Arc& a = r->arcs()[0];
+  EXPECT_DOUBLE_EQ(1, a.pref());
+  EXPECT_DOUBLE_EQ(1, a.unode()->prefs[a]);
+  EXPECT_EQ(std::vector<double>(1, 1), a.vnode()->unit_capacities[a]);
+
+  // the solution is split evenly
+  GreedySolver solver(true);
+  solver.Solve(r.get());
+  ASSERT_EQ(1, r->matches().size());
+  EXPECT_DOUBLE_EQ(3, r->matches()[0].second);
+  std::vector<Match> matches;
+  agg.Disaggregate(r->matches(), &matches);
+  ASSERT_EQ(3, matches.size());
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(arcs[i], matches[i].first);
+    EXPECT_DOUBLE_EQ(1, matches[i].second);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeGraphAggregatorTests, Distinct) {
+  ExchangeGraph::Ptr g(new ExchangeGraph());
+  ExchangeNodeGroup::Ptr s(new ExchangeNodeGroup());
+  s->AddCapacity(5);
+  g->AddSupplyGroup(s);
+  std::vector<Arc> arcs;
+  arcs.push_back(AddOrder(g.get(), s, 1, 1, false));
+  arcs.push_back(AddOrder(g.get(), s, 1, 2, false));  // preference
+  arcs.push_back(AddOrder(g.get(), s, 1.5, 1, false));  // quantity
+  arcs.push_back(AddOrder(g.get(), s, 1, 1, true));  // exclusive
+  arcs.push_back(AddOrder(g.get(), s, 1, 1, true));
+
+  ExchangeGraphAggregator agg(g);
+  ExchangeGraph::Ptr r = agg.reduced();
+  EXPECT_EQ(0, agg.n_merged());
+  ASSERT_EQ(5, r->request_groups().size());
+  ASSERT_EQ(5, r->arcs().size());
+  ASSERT_EQ(5, r->supply_groups()[0]->nodes().size());
+  for (int i = 0; i < 5; i++) {
+    const Arc& a = r->arcs()[i];
+    EXPECT_FALSE(arcs[i] == a);
+    EXPECT_EQ(arcs[i].unode()->qty, a.unode()->qty);
+    EXPECT_EQ(arcs[i].unode()->exclusive, a.unode()->exclusive);
+    EXPECT_DOUBLE_EQ(arcs[i].pref(), a.pref());
+  }
+  EXPECT_EQ(1, r->request_groups()[3]->excl_node_groups().size());
+
+  std::vector<Match> rmatches;
+  rmatches.push_back(std::make_pair(r->arcs()[2], 0.5));
+  std::vector<Match> matches;
+  agg.Disaggregate(rmatches, &matches);
+  ASSERT_EQ(1, matches.size());
+  EXPECT_EQ(arcs[2], matches[0].first);
+  EXPECT_DOUBLE_EQ(0.5, matches[0].second);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeGraphAggregatorTests, Mixed) {
+  ExchangeGraph::Ptr g(new ExchangeGraph());
+  ExchangeNodeGroup::Ptr s(new ExchangeNodeGroup());
+  s->AddCapacity(10);
+  g->AddSupplyGroup(s);
+  std::vector<Arc> arcs;
+  arcs.push_back(AddOrder(g.get(), s, 1, 1, false));
+  arcs.push_back(AddOrder(g.get(), s, 1, 2, false));
+  arcs.push_back(AddOrder(g.get(), s, 1, 1, false));
+
+  // merged groups and arcs take the place of their first original
+  ExchangeGraphAggregator agg(g);
+  ExchangeGraph::Ptr r = agg.reduced();
+  EXPECT_EQ(1, agg.n_merged());
+  ASSERT_EQ(2, r->request_groups().size());
+  EXPECT_DOUBLE_EQ(2, r->request_groups()[0]->qty());
+  EXPECT_DOUBLE_EQ(1, r->request_groups()[1]->qty());
+  ASSERT_EQ(2, r->arcs().size());
+  EXPECT_DOUBLE_EQ(1, r->arcs()[0].pref());
+  EXPECT_DOUBLE_EQ(2, r->arcs()[1].pref());
+  const std::vector<ExchangeNode::Ptr>& bids = r->supply_groups()[0]->nodes();
+  ASSERT_EQ(2, bids.size());
+  EXPECT_DOUBLE_EQ(4, bids[0]->qty);
+  EXPECT_DOUBLE_EQ(2, bids[1]->qty);
+
+  GreedySolver solver(true);
+  solver.Solve(r.get());
+  std::vector<Match> matches;
+  agg.Disaggregate(r->matches(), &matches);
+  ASSERT_EQ(3, matches.size());
+  double total = 0;
+  for (int i = 0; i < matches.size(); i++) {
+    EXPECT_DOUBLE_EQ(1, matches[i].second);
+    total += matches[i].second;
+  }
+  EXPECT_DOUBLE_EQ(3, total);
+}
@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "error.h"
+#include "exchange_graph.h"
+#include "exchange_graph_dump.h"
+#include "exchange_test_cases.h"
+#include "flat_exchange_graph.h"
+#include "greedy_solver.h"
+
+using cyclus::Arc;
+using cyclus::ExchangeGraph;
+using cyclus::ExchangeNode;
+using cyclus::ExchangeNodeGroup;
+using cyclus::FlatExchangeGraph;
+using cyclus::GreedySolver;
+using cyclus::RequestGroup;
+
+namespace {
+
+/// a requester of two exclusive orders contests a supplier with a requester
+/// of a non-exclusive order
+void ConstructExclusive(ExchangeGraph* g) {
+  ExchangeNode::Ptr u1(new ExchangeNode(2, true, "uox", 1));
+  ExchangeNode::Ptr u2(new ExchangeNode(3, true, "uox", 1));
+  ExchangeNode::Ptr u3(new ExchangeNode(4, false, "mox", 2));
+  ExchangeNode::Ptr v(new ExchangeNode(5, false, "uox", 3));
+  Arc a1(u1, v);
+  Arc a2(u2, v);
+  Arc a3(u3, v);
+  a1.pref(1);
+  a2.pref(2);
+  a3.pref(3);
+  u1->prefs[a1] = 1;
+  u2->prefs[a2] = 2;
+  u1->unit_capacities[a1].push_back(1);
+  u2->unit_capacities[a2].push_back(1);
+  u3->unit_capacities[a3].push_back(0.5);
+  v->unit_capacities[a1].push_back(1);
+  v->unit_capacities[a2].push_back(1);
+  v->unit_capacities[a3].push_back(1);
+
+  RequestGroup::Ptr r1(new RequestGroup(3));
+  std::vector<ExchangeNode::Ptr> excl;
+  excl.push_back(u1);
+  excl.push_back(u2);
+  r1->AddExchangeNode(u1);
+  r1->AddExchangeNode(u2);
+  r1->AddExclGroup(excl);
+  r1->AddCapacity(3);
+  RequestGroup::Ptr r2(new RequestGroup(4));
+  r2->AddExchangeNode(u3);
+  r2->AddCapacity(2);
+  ExchangeNodeGroup::Ptr s(new ExchangeNodeGroup());
+  s->AddExchangeNode(v);
+  s->AddCapacity(5);
+
+  g->AddRequestGroup(r1);
+  g->AddRequestGroup(r2);
+  g->AddSupplyGroup(s);
+  g->AddArc(a1);
+  g->AddArc(a2);
+  g->AddArc(a3);
+}
+
+ExchangeGraph::Ptr RoundTrip(ExchangeGraph* g) {
+  std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+  cyclus::DumpExchangeGraph(g, ss);
+  return cyclus::LoadExchangeGraph(ss);
+}
+
+void ExpectSameGraph(ExchangeGraph* exp, ExchangeGraph* obs) {
+  FlatExchangeGraph fe(exp);
+  FlatExchangeGraph fo(obs);
+  ASSERT_EQ(fe.n_groups(), fo.n_groups());
+  ASSERT_EQ(fe.n_req_groups(), fo.n_req_groups());
+  ASSERT_EQ(fe.n_nodes(), fo.n_nodes());
+  ASSERT_EQ(fe.n_arcs(), fo.n_arcs());
+  EXPECT_EQ(fe.capacities(), fo.capacities());
+
+  for (int g = 0; g < fe.n_groups(); g++) {
+    if (fe.request(g)) {
+      EXPECT_DOUBLE_EQ(fe.req_qty(g), fo.req_qty(g));
+    }
+    EXPECT_EQ(fe.node_begin(g), fo.node_begin(g));
+    EXPECT_EQ(fe.node_end(g), fo.node_end(g));
+    EXPECT_EQ(fe.cap_begin(g), fo.cap_begin(g));
+    ASSERT_EQ(fe.excl_end(g) - fe.excl_begin(g),
+              fo.excl_end(g) - fo.excl_begin(g));
+    for (int e = fe.excl_begin(g); e < fe.excl_end(g); e++) {
+      int eo = fo.excl_begin(g) + e - fe.excl_begin(g);
+      ASSERT_EQ(fe.n_excl_nodes(e), fo.n_excl_nodes(eo));
+      for (int i = 0; i < fe.n_excl_nodes(e); i++) {
+        EXPECT_EQ(fe.excl_nodes(e)[i], fo.excl_nodes(eo)[i]);
+      }
+    }
+  }
+
+  for (int n = 0; n < fe.n_nodes(); n++) {
+    EXPECT_EQ(fe.group(n), fo.group(n));
+    EXPECT_DOUBLE_EQ(fe.qty(n), fo.qty(n));
+    EXPECT_EQ(fe.exclusive(n), fo.exclusive(n));
+    EXPECT_EQ(fe.agent_id(n), fo.agent_id(n));
+    EXPECT_EQ(fe.node(n)->commod, fo.node(n)->commod);
+  }
+
+  for (int a = 0; a < fe.n_arcs(); a++) {
+    EXPECT_EQ(fe.unode(a), fo.unode(a));
+    EXPECT_EQ(fe.vnode(a), fo.vnode(a));
+    EXPECT_EQ(fe.arc_exclusive(a), fo.arc_exclusive(a));
+    EXPECT_DOUBLE_EQ(fe.excl_val(a), fo.excl_val(a));
+    EXPECT_DOUBLE_EQ(fe.pref(a), fo.pref(a));
+    EXPECT_DOUBLE_EQ(fe.req_pref(a), fo.req_pref(a));
+    ASSERT_EQ(fe.n_ucaps(a), fo.n_ucaps(a));
+    for (int i = 0; i < fe.n_ucaps(a); i++) {
+      EXPECT_DOUBLE_EQ(fe.ucaps(a)[i], fo.ucaps(a)[i]);
+    }
+    ASSERT_EQ(fe.n_vcaps(a), fo.n_vcaps(a));
+    for (int i = 0; i < fe.n_vcaps(a); i++) {
+      EXPECT_DOUBLE_EQ(fe.vcaps(a)[i], fo.vcaps(a)[i]);
+    }
+  }
+}
+
+void ExpectSameSolution(ExchangeGraph* exp, ExchangeGraph* obs) {
+  GreedySolver s(true);
+  double exp_obj = s.Solve(exp);
+  double obs_obj = s.Solve(obs);
+  EXPECT_DOUBLE_EQ(exp_obj, obs_obj);
+
+  // arcs are identified by the order in which they were added
+  ASSERT_EQ(exp->matches().size(), obs->matches().size());
+  for (int i = 0; i < exp->matches().size(); i++) {
+    EXPECT_EQ(exp->arc_ids().at(exp->matches()[i].first),
+              obs->arc_ids().at(obs->matches()[i].first));
+    EXPECT_DOUBLE_EQ(exp->matches()[i].second, obs->matches()[i].second);
+  }
+}
+
+}  // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeGraphDumpTests, Markets) {
+  ExchangeGraph g;
+  cyclus::ConstructMarkets(&g, 3);
+  ExchangeGraph::Ptr loaded = RoundTrip(&g);
+  ExpectSameGraph(&g, loaded.get());
+  ExpectSameSolution(&g, loaded.get());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeGraphDumpTests, Exclusive) {
+  ExchangeGraph g;
+  ConstructExclusive(&g);
+  ExchangeGraph::Ptr loaded = RoundTrip(&g);
+  ExpectSameGraph(&g, loaded.get());
+  ExpectSameSolution(&g, loaded.get());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeGraphDumpTests, Empty) {
+  ExchangeGraph g;
+  ExchangeGraph::Ptr loaded = RoundTrip(&g);
+  EXPECT_TRUE(loaded->request_groups().empty());
+  EXPECT_TRUE(loaded->supply_groups().empty());
+  EXPECT_TRUE(loaded->arcs().empty());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeGraphDumpTests, BadMagic) {
+  std::stringstream ss("CYEXGRPX and some more bytes");
+  EXPECT_THROW(cyclus::LoadExchangeGraph(ss), cyclus::ValueError);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeGraphDumpTests, Truncated) {
+  ExchangeGraph g;
+  ConstructExclusive(&g);
+  std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+  cyclus::DumpExchangeGraph(&g, ss);
+  std::string dump = ss.str();
+
+  std::stringstream trunc(dump.substr(0, dump.size() - 5),
+                          std::ios::in | std::ios::binary);
+  EXPECT_THROW(cyclus::LoadExchangeGraph(trunc), cyclus::IOError);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeGraphDumpTests, MissingFile) {
+  EXPECT_THROW(cyclus::LoadExchangeGraph("/nonexistent/graph.exg"),
+               cyclus::IOError);
+}
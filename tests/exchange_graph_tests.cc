@@ -3,12 +3,14 @@
 #include "cyc_limits.h"
 #include "error.h"
 #include "exchange_graph.h"
+#include "flat_exchange_graph.h"
 
 using cyclus::Arc;
 using cyclus::ExchangeGraph;
 using cyclus::Match;
 using cyclus::ExchangeNode;
 using cyclus::ExchangeNodeGroup;
+using cyclus::FlatExchangeGraph;
 using cyclus::RequestGroup;
 using std::vector;
 
@@ -130,3 +132,109 @@ TEST(ExGraphTests, AddMatch) {
   ASSERT_EQ(1, g.matches().size());
   EXPECT_EQ(match, g.matches().at(0));
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExGraphTests, Components) {
+  // r0 - s1 - r2 and r1 - s0 are connected, r3 and s2 have no arcs
+  vector<RequestGroup::Ptr> rgs;
+  vector<ExchangeNode::Ptr> us;
+  for (int i = 0; i < 4; i++) {
+    rgs.push_back(RequestGroup::Ptr(new RequestGroup()));
+    us.push_back(ExchangeNode::Ptr(new ExchangeNode()));
+    rgs[i]->AddExchangeNode(us[i]);
+  }
+  vector<ExchangeNodeGroup::Ptr> sgs;
+  vector<ExchangeNode::Ptr> vs;
+  for (int i = 0; i < 3; i++) {
+    sgs.push_back(ExchangeNodeGroup::Ptr(new ExchangeNodeGroup()));
+    vs.push_back(ExchangeNode::Ptr(new ExchangeNode()));
+    sgs[i]->AddExchangeNode(vs[i]);
+  }
+
+  ExchangeGraph g;
+  for (int i = 0; i < 4; i++) {
+    g.AddRequestGroup(rgs[i]);
+  }
+  for (int i = 0; i < 3; i++) {
+    g.AddSupplyGroup(sgs[i]);
+  }
+  Arc a1(us[1], vs[0]);
+  Arc a2(us[2], vs[1]);
+  Arc a3(us[0], vs[1]);
+  g.AddArc(a1);
+  g.AddArc(a2);
+  g.AddArc(a3);
+
+  vector<ExchangeGraph::Ptr> comps = g.Components();
+  ASSERT_EQ(2, comps.size());
+
+  ExchangeGraph::Ptr c = comps[0];
+  ASSERT_EQ(2, c->request_groups().size());
+  EXPECT_EQ(rgs[0], c->request_groups()[0]);
+  EXPECT_EQ(rgs[2], c->request_groups()[1]);
+  ASSERT_EQ(1, c->supply_groups().size());
+  EXPECT_EQ(sgs[1], c->supply_groups()[0]);
+  ASSERT_EQ(2, c->arcs().size());
+  EXPECT_EQ(a2, c->arcs()[0]);
+  EXPECT_EQ(a3, c->arcs()[1]);
+  EXPECT_EQ(2, c->node_arc_map().at(vs[1]).size());
+
+  c = comps[1];
+  ASSERT_EQ(1, c->request_groups().size());
+  EXPECT_EQ(rgs[1], c->request_groups()[0]);
+  ASSERT_EQ(1, c->supply_groups().size());
+  EXPECT_EQ(sgs[0], c->supply_groups()[0]);
+  ASSERT_EQ(1, c->arcs().size());
+  EXPECT_EQ(a1, c->arcs()[0]);
+
+  EXPECT_TRUE(ExchangeGraph().Components().empty());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExGraphTests, ArcIds) {
+  ExchangeNode::Ptr u(new ExchangeNode());
+  ExchangeNode::Ptr v1(new ExchangeNode());
+  ExchangeNode::Ptr v2(new ExchangeNode());
+  Arc a1(u, v1);
+  Arc a2(u, v2);
+
+  ExchangeGraph g;
+  g.AddArc(a1);
+  EXPECT_EQ(0, g.arc_ids().at(a1));
+  g.AddArc(a2);
+  EXPECT_EQ(1, g.arc_ids().at(a2));
+  EXPECT_EQ(2, g.arc_by_id().size());
+  EXPECT_EQ(a1, g.arc_by_id().at(0));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExGraphTests, Flat) {
+  ExchangeNode::Ptr u(new ExchangeNode());
+  ExchangeNode::Ptr v(new ExchangeNode());
+  RequestGroup::Ptr rg(new RequestGroup());
+  rg->AddExchangeNode(u);
+  ExchangeNodeGroup::Ptr sg(new ExchangeNodeGroup());
+  sg->AddExchangeNode(v);
+
+  ExchangeGraph g;
+  g.AddRequestGroup(rg);
+  boost::shared_ptr<FlatExchangeGraph> f = g.flat();
+  EXPECT_EQ(&g, f->graph());
+  EXPECT_EQ(f, g.flat());
+  EXPECT_EQ(1, f->n_nodes());
+
+  g.AddSupplyGroup(sg);
+  g.AddArc(Arc(u, v));
+  boost::shared_ptr<FlatExchangeGraph> f2 = g.flat();
+  EXPECT_NE(f, f2);
+  EXPECT_EQ(1, f->n_nodes());  // the previous snapshot is kept
+  EXPECT_EQ(2, f2->n_nodes());
+  EXPECT_EQ(1, f2->n_arcs());
+  EXPECT_EQ(f2, g.flat());
+
+  g.ClearFlat();
+  EXPECT_NE(f2, g.flat());
+
+  ExchangeGraph copy(g);
+  EXPECT_EQ(&copy, copy.flat()->graph());
+}
@@ -18,3 +18,22 @@ TEST(ExManagerTests, NullTest) {
 
   EXPECT_NO_THROW(manager.Execute());
 }
+
+TEST(ExManagerTests, Steps) {
+  TestContext tc;
+  GreedySolver* solver = new GreedySolver();
+  tc.get()->solver(solver);
+  ExchangeManager<Material> manager(tc.get());
+  EXPECT_EQ(solver, manager.solver());
+
+  GreedySolver other;
+  manager.solver(&other);
+  EXPECT_EQ(&other, manager.solver());
+  manager.solver(NULL);
+  EXPECT_EQ(solver, manager.solver());
+
+  EXPECT_NO_THROW(manager.Collect());
+  EXPECT_NO_THROW(manager.Solve());
+  EXPECT_NO_THROW(manager.ExecuteTrades());
+  EXPECT_NO_THROW(manager.Solve());  // nothing left to solve
+}
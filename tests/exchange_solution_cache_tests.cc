@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "exchange_graph.h"
+#include "exchange_solution_cache.h"
+#include "exchange_test_cases.h"
+
+using cyclus::ExchangeGraph;
+using cyclus::ExchangeSolutionCache;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeSolutionCacheTests, Keys) {
+  ExchangeGraph g1, g2;
+  cyclus::ConstructMarkets(&g1, 2);
+  cyclus::ConstructMarkets(&g2, 2);
+  std::vector<ExchangeGraph::Ptr> c1 = g1.Components();
+  std::vector<ExchangeGraph::Ptr> c2 = g2.Components();
+  ASSERT_EQ(2, c1.size());
+  EXPECT_EQ(ExchangeSolutionCache::Key(c1[0].get()),
+            ExchangeSolutionCache::Key(c2[0].get()));
+  EXPECT_NE(ExchangeSolutionCache::Key(c1[0].get()),
+            ExchangeSolutionCache::Key(c1[1].get()));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeSolutionCacheTests, Reuse) {
+  ExchangeGraph g1, g2;
+  cyclus::ConstructMarkets(&g1, 1);
+  cyclus::ConstructMarkets(&g2, 1);
+  g1.AddMatch(g1.arcs()[2], 1.5);
+  g1.AddMatch(g1.arcs()[0], 0.5);
+
+  ExchangeSolutionCache cache;
+  std::string key = ExchangeSolutionCache::Key(&g1);
+  double obj = 0;
+  EXPECT_FALSE(cache.Reuse(key, &g2, &obj));
+  cache.Add(key, &g1, 3);
+  EXPECT_EQ(1, cache.size());
+  ASSERT_TRUE(cache.Reuse(key, &g2, &obj));
+  EXPECT_DOUBLE_EQ(3, obj);
+  ASSERT_EQ(2, g2.matches().size());
+  EXPECT_EQ(g2.arcs()[2], g2.matches()[0].first);
+  EXPECT_DOUBLE_EQ(1.5, g2.matches()[0].second);
+  EXPECT_EQ(g2.arcs()[0], g2.matches()[1].first);
+  EXPECT_DOUBLE_EQ(0.5, g2.matches()[1].second);
+  EXPECT_EQ(1, cache.n_reused());
+  EXPECT_EQ(1, cache.n_solved());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExchangeSolutionCacheTests, Generations) {
+  ExchangeGraph g1, g2;
+  cyclus::ConstructMarkets(&g1, 1);
+  cyclus::ConstructMarkets(&g2, 2);
+  std::string k1 = ExchangeSolutionCache::Key(&g1);
+  std::string k2 = ExchangeSolutionCache::Key(g2.Components()[1].get());
+
+  ExchangeSolutionCache cache;
+  cache.Begin(1);
+  cache.Add(k1, &g1, 0);
+  cache.Begin(2);
+  cache.Add(k2, &g1, 0);
+  EXPECT_EQ(2, cache.size());
+
+  // solutions are kept through the generation after their last use
+  cache.Begin(3);
+  EXPECT_EQ(1, cache.size());
+  double obj;
+  EXPECT_FALSE(cache.Reuse(k1, &g1, &obj));
+  EXPECT_TRUE(cache.Reuse(k2, &g1, &obj));
+  cache.Begin(4);
+  EXPECT_EQ(1, cache.size());
+  cache.Begin(6);
+  EXPECT_EQ(0, cache.size());
+}
@@ -1,17 +1,24 @@
 #include <gtest/gtest.h>
 
+#include "exchange_graph.h"
 #include "exchange_solver.h"
+#include "exchange_test_cases.h"
 
 using cyclus::ExchangeSolver;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 class MockSolver: public ExchangeSolver {
  public:
-  explicit MockSolver() : i(0) {}
+  explicit MockSolver() : i(0), n_components(0) {}
 
-  virtual double SolveGraph() { ++i; return 0; }
+  virtual double SolveGraph() {
+    ++i;
+    n_components += component();
+    return 0;
+  }
 
   int i;
+  int n_components;
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -23,3 +30,40 @@ TEST(ExSolverTests, Interface) {
   s.Solve();
   EXPECT_EQ(2, s.i);
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExSolverTests, Decompose) {
+  cyclus::ExchangeGraph g;
+  cyclus::ConstructMarkets(&g, 3);
+  MockSolver s;
+  s.decompose(true);
+  s.Solve(&g);
+  EXPECT_EQ(3, s.i);  // once per component
+  EXPECT_EQ(3, s.n_components);
+  EXPECT_EQ(&g, s.graph());
+
+  // whole graphs are not components
+  s.decompose(false);
+  s.Solve(&g);
+  EXPECT_EQ(3, s.n_components);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExSolverTests, Incremental) {
+  cyclus::ExchangeGraph g1, g2, g3;
+  cyclus::ConstructMarkets(&g1, 3);
+  cyclus::ConstructMarkets(&g2, 3);
+  cyclus::ConstructMarkets(&g3, 4);
+  MockSolver s;
+  EXPECT_FALSE(s.incremental());
+  s.incremental(true);
+  s.Solve(&g1);
+  EXPECT_EQ(3, s.i);
+  s.Solve(&g2);
+  EXPECT_EQ(3, s.i);  // identical components are not solved again
+  s.Solve(&g3);
+  EXPECT_EQ(4, s.i);  // only the added component is solved
+  EXPECT_EQ(&g3, s.graph());
+  EXPECT_EQ(6, s.solution_cache().n_reused());
+  EXPECT_EQ(4, s.solution_cache().n_solved());
+}
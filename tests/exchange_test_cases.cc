@@ -1,5 +1,8 @@
 #include "exchange_test_cases.h"
 
+#include <sstream>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "exchange_graph.h"
@@ -742,4 +745,43 @@ void Case7::Test(std::string solver_type, ExchangeGraph* g) {
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ConstructMarkets(ExchangeGraph* g, int n) {
+  for (int m = 0; m < n; m++) {
+    std::stringstream ss;
+    ss << "commod" << m;
+    std::string commod = ss.str();
+
+    std::vector<ExchangeNode::Ptr> reqs;
+    for (int i = 0; i < 2; i++) {
+      RequestGroup::Ptr req(new RequestGroup(2 + i));
+      req->AddCapacity(2 + i);
+      for (int j = 0; j < 2; j++) {
+        ExchangeNode::Ptr u(new ExchangeNode(2 + i, false, commod, 2 * m + i));
+        req->AddExchangeNode(u);
+        reqs.push_back(u);
+      }
+      g->AddRequestGroup(req);
+    }
+
+    for (int i = 0; i < 2; i++) {
+      ExchangeNodeGroup::Ptr sup(new ExchangeNodeGroup());
+      sup->AddCapacity(1 + m % 3 + i);
+      ExchangeNode::Ptr v(new ExchangeNode(1 + m % 3 + i, false, commod,
+                                           1000 + 2 * m + i));
+      sup->AddExchangeNode(v);
+      g->AddSupplyGroup(sup);
+
+      for (int j = 0; j < reqs.size(); j++) {
+        Arc a(reqs[j], v);
+        a.pref(1 + (j + i + m) % 4);
+        reqs[j]->unit_capacities[a].push_back(1);
+        reqs[j]->prefs[a] = a.pref();
+        v->unit_capacities[a].push_back(1);
+        g->AddArc(a);
+      }
+    }
+  }
+}
+
 }  // namespace cyclus
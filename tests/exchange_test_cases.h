@@ -394,6 +394,12 @@ class Case7: public ExchangeCase {
   int N;
 };
 
+/// Constructs n independent markets, each with two request groups and two
+/// supply groups that are connected to each other but not to any other
+/// market. Requests exceed supply so that the order in which requests are
+/// satisfied matters. Markets use the commodities "commod0", "commod1", ...
+void ConstructMarkets(ExchangeGraph* g, int n);
+
 }  // namespace cyclus
 
 #endif  // CYCLUS_TESTS_EXCHANGE_TEST_CASES_H_
@@ -10,6 +10,7 @@
 #include "exchange_translator.h"
 #include "exchange_translation_context.h"
 #include "equality_helpers.h"
+#include "greedy_solver.h"
 #include "material.h"
 #include "test_agents/test_facility.h"
 #include "request.h"
@@ -77,6 +78,26 @@ struct MatConverter2 : public Converter<Material> {
   }
 };
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+/// counts its conversions, which may be declared pure
+struct CountingConverter : public Converter<Material> {
+  explicit CountingConverter(bool pure) : pure_(pure), calls(0) {}
+  virtual ~CountingConverter() {}
+
+  virtual double convert(
+      Material::Ptr r,
+      Arc const * a = NULL,
+      ExchangeTranslationContext<Material> const *  ctx = NULL) const {
+    calls++;
+    return r->comp()->mass().find(u235)->second * fraction;
+  }
+
+  virtual bool pure() const { return pure_; }
+
+  bool pure_;
+  mutable int calls;
+};
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST(ExXlateTests, NegPref) {
   TestContext tc;
@@ -162,6 +183,38 @@ TEST(ExXlateTests, XlateCapacities) {
   TestVecEq(bexp, bnode->unit_capacities[arc]);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExXlateTests, XlateCapacitiesCached) {
+  Material::Ptr mat = get_mat(u235, qty);
+  Material::Ptr same = Material::CreateUntracked(qty, mat->comp());
+  Material::Ptr other = get_mat(u235, qty);
+
+  CountingConverter* pure = new CountingConverter(true);
+  CountingConverter* impure = new CountingConverter(false);
+  std::set< CapacityConstraint<Material> > constrs;
+  constrs.insert(
+      CapacityConstraint<Material>(qty, Converter<Material>::Ptr(pure)));
+  constrs.insert(
+      CapacityConstraint<Material>(qty, Converter<Material>::Ptr(impure)));
+
+  ExchangeTranslationContext<Material> ctx;
+  Material::Ptr offers[] = {mat, mat, same, other};
+  std::vector<double> exp(2, fraction);
+  for (int i = 0; i < 4; i++) {
+    ExchangeNode::Ptr rnode(new ExchangeNode());
+    ExchangeNode::Ptr bnode(new ExchangeNode());
+    Arc arc(rnode, bnode);
+    TranslateCapacities<Material>(offers[i], constrs, bnode, arc, ctx);
+    TestVecEq(exp, bnode->unit_capacities[arc]);
+  }
+
+  // pure conversions are made once per composition and quantity
+  EXPECT_EQ(2, pure->calls);
+  EXPECT_EQ(4, impure->calls);
+  EXPECT_EQ(2, ctx.conversions->n_converted());
+  EXPECT_EQ(2, ctx.conversions->n_reused());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST(ExXlateTests, XlateReq) {
   TestContext tc;
@@ -424,6 +477,12 @@ TEST(ExXlateTests, SimpleXlate) {
   EXPECT_EQ(0, graph->matches().size());
   const Arc& a = *graph->arcs().begin();
   EXPECT_EQ(pref, a.unode()->prefs[a]);
+
+  // nodes carry the interned commodity
+  EXPECT_EQ(0, req->commod_id());
+  EXPECT_EQ(0, a.unode()->commod_id);
+  EXPECT_EQ(0, a.vnode()->commod_id);
+  EXPECT_EQ(commod, a.vnode()->commod);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -471,3 +530,40 @@ TEST(ExXlateTests, BackXlate) {
   xlator.BackTranslateSolution(matches, obs);
   EXPECT_EQ(exp, obs);
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ExXlateTests, AggregateXlate) {
+  TestContext tc;
+  TestFacility* trader = tc.trader();
+
+  std::string commod = "c";
+  double pref = 4.5;
+  ExchangeContext<Material> ctx;
+  BidPortfolio<Material>::Ptr bport(new BidPortfolio<Material>());
+  for (int i = 0; i < 2; i++) {
+    RequestPortfolio<Material>::Ptr rport(new RequestPortfolio<Material>());
+    Request<Material>* req =
+        rport->AddRequest(get_mat(u235, qty), trader, commod, pref);
+    bport->AddBid(req, get_mat(u235, qty), trader);
+    ctx.AddRequestPortfolio(rport);
+  }
+  ctx.AddBidPortfolio(bport);
+
+  ExchangeTranslator<Material> xlator(&ctx);
+  xlator.aggregate(true);
+  ExchangeGraph::Ptr graph = xlator.Translate();
+  ASSERT_EQ(1, graph->request_groups().size());
+  EXPECT_DOUBLE_EQ(2 * qty, graph->request_groups()[0]->qty());
+  ASSERT_EQ(1, graph->arcs().size());
+
+  cyclus::GreedySolver solver(true);
+  solver.Solve(graph.get());
+  std::vector< Trade<Material> > obs;
+  xlator.BackTranslateSolution(graph->matches(), obs);
+  ASSERT_EQ(2, obs.size());
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(obs[i].bid->request(), obs[i].request);
+    EXPECT_DOUBLE_EQ(qty, obs[i].amt);
+  }
+  EXPECT_NE(obs[0].request, obs[1].request);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "exchange_graph.h"
+#include "flat_exchange_graph.h"
+
+using cyclus::Arc;
+using cyclus::ExchangeGraph;
+using cyclus::ExchangeNode;
+using cyclus::ExchangeNodeGroup;
+using cyclus::FlatExchangeGraph;
+using cyclus::RequestGroup;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(FlatExGraphTests, Empty) {
+  ExchangeGraph g;
+  FlatExchangeGraph f(&g);
+  EXPECT_EQ(&g, f.graph());
+  EXPECT_EQ(0, f.n_groups());
+  EXPECT_EQ(0, f.n_req_groups());
+  EXPECT_EQ(0, f.n_nodes());
+  EXPECT_EQ(0, f.n_arcs());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(FlatExGraphTests, Structure) {
+  ExchangeNode::Ptr u1(new ExchangeNode(5, false, "commod", 1));
+  ExchangeNode::Ptr u2(new ExchangeNode(3, true, "commod", 2));
+  ExchangeNode::Ptr v(new ExchangeNode(4, false, "commod", 3));
+  ExchangeNode::Ptr orphan(new ExchangeNode(1, false, "commod", 4));
+  v->commod_id = 7;
+
+  Arc a1(u1, v);
+  a1.pref(0.5);
+  Arc a2(u2, v);
+  a2.pref(2);
+  Arc a3(u1, orphan);
+  a3.pref(1);
+  u1->prefs[a1] = 0.5;
+  u2->prefs[a2] = 2;
+  u1->unit_capacities[a1].push_back(1);
+  u1->unit_capacities[a1].push_back(2);
+  u2->unit_capacities[a2].push_back(3);
+  u2->unit_capacities[a2].push_back(4);
+  v->unit_capacities[a1].push_back(5);
+  v->unit_capacities[a2].push_back(6);
+
+  RequestGroup::Ptr rg(new RequestGroup(8));
+  rg->AddExchangeNode(u1);
+  rg->AddExchangeNode(u2);
+  rg->AddCapacity(8);
+  rg->AddCapacity(9);
+  ExchangeNodeGroup::Ptr sg(new ExchangeNodeGroup());
+  sg->AddExchangeNode(v);
+  sg->AddCapacity(10);
+
+  ExchangeGraph g;
+  g.AddSupplyGroup(sg);
+  g.AddRequestGroup(rg);
+  g.AddArc(a1);
+  g.AddArc(a2);
+  g.AddArc(a3);
+
+  FlatExchangeGraph f(&g);
+
+  // groups, request groups first
+  ASSERT_EQ(2, f.n_groups());
+  EXPECT_EQ(1, f.n_req_groups());
+  EXPECT_TRUE(f.request(0));
+  EXPECT_FALSE(f.request(1));
+  EXPECT_EQ(8, f.req_qty(0));
+  EXPECT_EQ(0, f.node_begin(0));
+  EXPECT_EQ(2, f.node_end(0));
+  EXPECT_EQ(2, f.node_begin(1));
+  EXPECT_EQ(3, f.node_end(1));
+  ASSERT_EQ(2, f.n_caps(0));
+  EXPECT_EQ(9, f.capacities()[f.cap_begin(0) + 1]);
+  ASSERT_EQ(1, f.n_caps(1));
+  EXPECT_EQ(10, f.capacities()[f.cap_begin(1)]);
+
+  // exclusive request node groups
+  ASSERT_EQ(1, f.excl_end(0) - f.excl_begin(0));
+  ASSERT_EQ(1, f.n_excl_nodes(f.excl_begin(0)));
+  EXPECT_EQ(1, f.excl_nodes(f.excl_begin(0))[0]);
+  EXPECT_EQ(f.excl_begin(1), f.excl_end(1));
+
+  // nodes, the orphan last
+  ASSERT_EQ(4, f.n_nodes());
+  EXPECT_EQ(u1, f.node(0));
+  EXPECT_EQ(u2, f.node(1));
+  EXPECT_EQ(v, f.node(2));
+  EXPECT_EQ(orphan, f.node(3));
+  EXPECT_EQ(0, f.group(1));
+  EXPECT_EQ(1, f.group(2));
+  EXPECT_EQ(-1, f.group(3));
+  EXPECT_EQ(3, f.qty(1));
+  EXPECT_TRUE(f.exclusive(1));
+  EXPECT_FALSE(f.exclusive(0));
+  EXPECT_EQ(3, f.agent_id(2));
+  EXPECT_EQ(7, f.commod_id(2));
+  EXPECT_EQ(-1, f.commod_id(0));
+
+  // arcs
+  ASSERT_EQ(3, f.n_arcs());
+  EXPECT_EQ(a2, f.arc(1));
+  EXPECT_EQ(1, f.unode(1));
+  EXPECT_EQ(2, f.vnode(1));
+  EXPECT_FALSE(f.arc_exclusive(0));
+  EXPECT_TRUE(f.arc_exclusive(1));
+  EXPECT_EQ(a2.excl_val(), f.excl_val(1));
+  EXPECT_EQ(2, f.pref(1));
+  EXPECT_EQ(0.5, f.req_pref(0));
+  EXPECT_EQ(0, f.req_pref(2));
+  ASSERT_EQ(2, f.n_ucaps(1));
+  EXPECT_EQ(3, f.ucaps(1)[0]);
+  EXPECT_EQ(4, f.ucaps(1)[1]);
+  ASSERT_EQ(1, f.n_vcaps(1));
+  EXPECT_EQ(6, f.vcaps(1)[0]);
+  EXPECT_EQ(0, f.n_ucaps(2));
+  EXPECT_EQ(0, f.n_vcaps(2));
+
+  // adjacency in the order arcs were added
+  ASSERT_EQ(2, f.n_node_arcs(0));
+  EXPECT_EQ(0, f.node_arcs(0)[0]);
+  EXPECT_EQ(2, f.node_arcs(0)[1]);
+  ASSERT_EQ(2, f.n_node_arcs(2));
+  EXPECT_EQ(0, f.node_arcs(2)[0]);
+  EXPECT_EQ(1, f.node_arcs(2)[1]);
+  ASSERT_EQ(1, f.n_node_arcs(3));
+  EXPECT_EQ(2, f.node_arcs(3)[0]);
+}
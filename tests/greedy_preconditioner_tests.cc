@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include "exchange_graph.h"
+#include "flat_exchange_graph.h"
 #include "greedy_preconditioner.h"
 
 using cyclus::Arc;
@@ -8,6 +9,7 @@ using cyclus::AvgPref;
 using cyclus::ExchangeNode;
 using cyclus::ExchangeNodeGroup;
 using cyclus::ExchangeGraph;
+using cyclus::FlatExchangeGraph;
 using cyclus::GreedyPreconditioner;
 using cyclus::RequestGroup;
 
@@ -124,7 +126,14 @@ TEST(ConditionerTests, Conditioning) {
   EXPECT_DOUBLE_EQ(GroupWeight(g1, &weights, &avg_prefs), expg1);
   EXPECT_DOUBLE_EQ(GroupWeight(g2, &weights, &avg_prefs), expg2);
 
+  boost::shared_ptr<FlatExchangeGraph> flat = g.flat();
   gp.Condition(&g);
+  EXPECT_NE(flat, g.flat());  // reordered
+
+  // conditioning again keeps the order and the flat graph
+  flat = g.flat();
+  gp.Condition(&g);
+  EXPECT_EQ(flat, g.flat());
 
   // final state
   EXPECT_EQ(g.request_groups().at(0), g2);
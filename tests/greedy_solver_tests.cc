@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include "exchange_graph.h"
+#include "exchange_test_cases.h"
 #include "greedy_preconditioner.h"
 #include "greedy_solver.h"
 #include "error.h"
@@ -13,6 +14,7 @@ using cyclus::ExchangeNodeGroup;
 using cyclus::RequestGroup;
 using cyclus::GreedySolver;
 using cyclus::GreedyPreconditioner;
+using cyclus::Match;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST(GreedySolverTests, AvgPref) {
@@ -83,3 +85,78 @@ TEST(GreedySolverTests, General) {
   EXPECT_EQ(g.request_groups()[1], gu1);
   EXPECT_EQ(g.request_groups()[0], gu2);
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(GreedySolverTests, Decompose) {
+  ExchangeGraph g;
+  cyclus::ConstructMarkets(&g, 6);
+  ASSERT_EQ(6, g.Components().size());
+
+  GreedySolver s(false);
+  EXPECT_FALSE(s.decompose());
+  s.Solve(&g);
+  std::vector<Match> exp = g.matches();
+  ASSERT_TRUE(exp.size() > 6);
+  g.ClearMatches();
+
+  s.decompose(true);
+  s.Solve(&g);
+  EXPECT_EQ(&g, s.graph());
+  EXPECT_EQ(exp, g.matches());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(GreedySolverTests, Incremental) {
+  ExchangeGraph g1, g2, g3;
+  cyclus::ConstructMarkets(&g1, 6);
+  cyclus::ConstructMarkets(&g2, 6);
+  cyclus::ConstructMarkets(&g3, 6);
+  GreedySolver s(false);
+  s.Solve(&g1);
+
+  s.incremental(true);
+  s.Solve(&g2);
+  s.Solve(&g3);
+  EXPECT_EQ(6, s.solution_cache().n_reused());
+
+  // kept solutions are mapped to the same arcs of the new graph
+  const std::vector<Match>& exp = g1.matches();
+  const std::vector<Match>& obs = g3.matches();
+  ASSERT_EQ(exp.size(), obs.size());
+  for (int i = 0; i < exp.size(); i++) {
+    EXPECT_EQ(g1.arc_ids()[exp[i].first], g3.arc_ids()[obs[i].first]);
+    EXPECT_DOUBLE_EQ(exp[i].second, obs[i].second);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(GreedySolverTests, Clone) {
+  ExchangeGraph g;
+  cyclus::ConstructMarkets(&g, 2);
+
+  GreedySolver s(false);
+  s.Solve(&g);
+  std::vector<Match> exp = g.matches();
+  g.ClearMatches();
+
+  cyclus::ExchangeSolver* c = s.Clone();
+  c->Solve(&g);
+  EXPECT_EQ(exp, g.matches());
+  delete c;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(GreedySolverTests, CloneWithOptions) {
+  GreedySolver s(false);
+  s.decompose(true);
+  s.aggregate(true);
+  s.concurrent_markets(true);
+
+  cyclus::ExchangeSolver* c = s.CloneWithOptions();
+  ASSERT_TRUE(c != NULL);
+  EXPECT_TRUE(c->decompose());
+  EXPECT_TRUE(c->aggregate());
+  EXPECT_FALSE(c->incremental());
+  EXPECT_TRUE(c->concurrent_markets());
+  delete c;
+}
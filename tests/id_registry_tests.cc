@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "id_registry.h"
+
+namespace {
+
+struct Obj {
+  explicit Obj(int id) : id(id) {}
+  int id;
+};
+
+struct ObjId {
+  int operator()(Obj* o) const { return o->id; }
+};
+
+typedef cyclus::IdRegistry<Obj, ObjId> Registry;
+
+std::vector<int> Ids(const Registry& reg) {
+  std::vector<int> ids;
+  Registry::iterator it;
+  for (it = reg.begin(); it != reg.end(); ++it) {
+    ids.push_back((*it)->id);
+  }
+  return ids;
+}
+
+}  // namespace
+
+TEST(IdRegistryTests, Empty) {
+  Registry reg;
+  EXPECT_TRUE(reg.empty());
+  EXPECT_EQ(0, reg.size());
+  EXPECT_TRUE(reg.begin() == reg.end());
+}
+
+TEST(IdRegistryTests, AddRemove) {
+  Obj a(1);
+  Obj b(2);
+  Registry reg;
+  EXPECT_TRUE(reg.Add(&a));
+  EXPECT_FALSE(reg.Add(&a));
+  EXPECT_TRUE(reg.Add(&b));
+  EXPECT_EQ(2, reg.size());
+  EXPECT_TRUE(reg.Contains(&a));
+
+  EXPECT_TRUE(reg.Remove(&a));
+  EXPECT_FALSE(reg.Remove(&a));
+  EXPECT_FALSE(reg.Contains(&a));
+  EXPECT_EQ(1, reg.size());
+  EXPECT_EQ(&b, *reg.begin());
+
+  EXPECT_TRUE(reg.Remove(&b));
+  EXPECT_TRUE(reg.empty());
+  EXPECT_TRUE(reg.begin() == reg.end());
+}
+
+TEST(IdRegistryTests, IdOrder) {
+  std::vector<Obj> objs;
+  int ids[] = {3, 1, 4, 1, 5, 9, 2, 6};
+  for (int i = 0; i < 8; ++i) {
+    objs.push_back(Obj(ids[i]));
+  }
+
+  Registry reg;
+  for (int i = 0; i < 4; ++i) {
+    reg.Add(&objs[i]);
+  }
+  int exp1[] = {1, 1, 3, 4};
+  EXPECT_EQ(std::vector<int>(exp1, exp1 + 4), Ids(reg));
+
+  for (int i = 4; i < 8; ++i) {
+    reg.Add(&objs[i]);
+  }
+  int exp2[] = {1, 1, 2, 3, 4, 5, 6, 9};
+  EXPECT_EQ(std::vector<int>(exp2, exp2 + 8), Ids(reg));
+
+  // equal ids are iterated in the order they were added
+  Registry::iterator it = reg.begin();
+  EXPECT_EQ(&objs[1], *it++);
+  EXPECT_EQ(&objs[3], *it++);
+}
+
+TEST(IdRegistryTests, Compact) {
+  std::vector<Obj> objs;
+  for (int i = 0; i < 100; ++i) {
+    objs.push_back(Obj(i));
+  }
+
+  Registry reg;
+  for (int i = 0; i < 100; ++i) {
+    reg.Add(&objs[i]);
+  }
+  Ids(reg);
+  for (int i = 0; i < 100; ++i) {
+    if (i % 3 != 0) {
+      reg.Remove(&objs[i]);
+    }
+  }
+  EXPECT_EQ(34, reg.size());
+
+  std::vector<int> ids = Ids(reg);
+  ASSERT_EQ(34, ids.size());
+  for (int i = 0; i < ids.size(); ++i) {
+    EXPECT_EQ(3 * i, ids[i]);
+  }
+
+  // removal and re-addition after compaction keeps id order
+  reg.Remove(&objs[0]);
+  reg.Add(&objs[0]);
+  reg.Add(&objs[1]);
+  ids = Ids(reg);
+  ASSERT_EQ(35, ids.size());
+  EXPECT_EQ(0, ids[0]);
+  EXPECT_EQ(1, ids[1]);
+  EXPECT_EQ(3, ids[2]);
+  EXPECT_EQ(99, ids.back());
+}
@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+
+#include "bid.h"
+#include "bid_portfolio.h"
+#include "error.h"
+#include "material.h"
+#include "pref_table.h"
+#include "request.h"
+#include "request_portfolio.h"
+#include "resource_helpers.h"
+#include "test_context.h"
+#include "test_agents/test_facility.h"
+#include "trader.h"
+
+using cyclus::Bid;
+using cyclus::BidPortfolio;
+using cyclus::Material;
+using cyclus::PrefMap;
+using cyclus::PrefTable;
+using cyclus::PrefView;
+using cyclus::Request;
+using cyclus::RequestPortfolio;
+using cyclus::TestContext;
+using cyclus::Trader;
+using test_helpers::get_mat;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+/// doubles preferences in PrefMap form
+class LegacyDoubler: public TestFacility {
+ public:
+  explicit LegacyDoubler(cyclus::Context* ctx) : TestFacility(ctx), calls(0) {}
+
+  virtual void AdjustMatlPrefs(PrefMap<Material>::type& prefs) {
+    PrefMap<Material>::type::iterator rit;
+    for (rit = prefs.begin(); rit != prefs.end(); ++rit) {
+      std::map<Bid<Material>*, double>::iterator bit;
+      for (bit = rit->second.begin(); bit != rit->second.end(); ++bit) {
+        bit->second *= 2;
+      }
+    }
+    calls++;
+  }
+
+  int calls;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+/// triples preferences in PrefMap form only if enabled, otherwise calls the
+/// default adjustment
+class LegacyConditional: public TestFacility {
+ public:
+  LegacyConditional(cyclus::Context* ctx, bool enabled)
+      : TestFacility(ctx),
+        enabled(enabled),
+        calls(0) {}
+
+  virtual void AdjustMatlPrefs(PrefMap<Material>::type& prefs) {
+    calls++;
+    if (!enabled) {
+      Trader::AdjustMatlPrefs(prefs);
+      return;
+    }
+    PrefMap<Material>::type::iterator rit;
+    for (rit = prefs.begin(); rit != prefs.end(); ++rit) {
+      std::map<Bid<Material>*, double>::iterator bit;
+      for (bit = rit->second.begin(); bit != rit->second.end(); ++bit) {
+        bit->second *= 3;
+      }
+    }
+  }
+
+  bool enabled;
+  int calls;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class PrefTableTests: public ::testing::Test {
+ protected:
+  TestContext tc;
+  TestFacility* reqr1;
+  TestFacility* reqr2;
+  TestFacility* bidr;
+  Request<Material>* req1;
+  Request<Material>* req2;
+  Request<Material>* req3;
+  Bid<Material>* bid1;
+  Bid<Material>* bid2;
+  Bid<Material>* bid3;
+  Bid<Material>* bid4;
+  RequestPortfolio<Material>::Ptr rp1, rp2;
+  BidPortfolio<Material>::Ptr bp;
+
+  virtual void SetUp() {
+    reqr1 = new TestFacility(tc.get());
+    reqr2 = new TestFacility(tc.get());
+    bidr = new TestFacility(tc.get());
+
+    rp1 = RequestPortfolio<Material>::Ptr(new RequestPortfolio<Material>());
+    req1 = rp1->AddRequest(get_mat(), reqr1, "commod", 1);
+    req2 = rp1->AddRequest(get_mat(), reqr1, "commod", 2);
+    rp2 = RequestPortfolio<Material>::Ptr(new RequestPortfolio<Material>());
+    req3 = rp2->AddRequest(get_mat(), reqr2, "commod", 3);
+
+    bp = BidPortfolio<Material>::Ptr(new BidPortfolio<Material>());
+    bid1 = bp->AddBid(req2, get_mat(), bidr);
+    bid2 = bp->AddBid(req3, get_mat(), bidr);
+    bid3 = bp->AddBid(req1, get_mat(), bidr);
+    bid4 = bp->AddBid(req2, get_mat(), bidr);
+  }
+
+  virtual void TearDown() {
+    delete reqr1;
+    delete reqr2;
+    delete bidr;
+  }
+
+  void AddAll(PrefTable<Material>* t) {
+    t->Add(bid1, 1);
+    t->Add(bid2, 2);
+    t->Add(bid3, 3);
+    t->Add(bid4, 4);
+  }
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(PrefTableTests, Arcs) {
+  PrefTable<Material> t;
+  AddAll(&t);
+  t.Add(bid1, 5);
+  EXPECT_EQ(4, t.size());
+  EXPECT_EQ(bid3, t.bid(2));
+  EXPECT_DOUBLE_EQ(3, t.pref(2));
+  EXPECT_EQ(0, t.Find(bid1));
+  EXPECT_DOUBLE_EQ(1, t.pref(bid1));
+
+  BidPortfolio<Material>::Ptr other(new BidPortfolio<Material>());
+  Bid<Material>* missing = other->AddBid(req1, get_mat(), bidr);
+  EXPECT_EQ(-1, t.Find(missing));
+  EXPECT_THROW(t.pref(missing), cyclus::KeyError);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(PrefTableTests, Views) {
+  PrefTable<Material> t;
+  AddAll(&t);
+
+  // requests in the order they first received a bid, bids in order of addition
+  PrefView<Material> v1 = t.View(reqr1);
+  ASSERT_EQ(2, v1.size());
+  EXPECT_EQ(req2, v1.request(0));
+  ASSERT_EQ(2, v1.n_bids(0));
+  EXPECT_EQ(bid1, v1.bid(0, 0));
+  EXPECT_EQ(bid4, v1.bid(0, 1));
+  EXPECT_EQ(req1, v1.request(1));
+  ASSERT_EQ(1, v1.n_bids(1));
+  EXPECT_EQ(bid3, v1.bid(1, 0));
+  EXPECT_DOUBLE_EQ(4, v1.pref(0, 1));
+
+  PrefView<Material> v2 = t.View(reqr2);
+  ASSERT_EQ(1, v2.size());
+  EXPECT_EQ(req3, v2.request(0));
+  EXPECT_EQ(bid2, v2.bid(0, 0));
+
+  EXPECT_TRUE(t.View(bidr).empty());
+  EXPECT_EQ(0, t.View(bidr).size());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(PrefTableTests, ViewWrites) {
+  PrefTable<Material> t;
+  AddAll(&t);
+  PrefView<Material> v = t.View(reqr1);
+  v.pref(0, 1) = 10;
+  EXPECT_DOUBLE_EQ(10, t.pref(bid4));
+  EXPECT_DOUBLE_EQ(10, t.View(reqr1).pref(0, 1));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(PrefTableTests, Maps) {
+  PrefTable<Material> t;
+  AddAll(&t);
+
+  PrefMap<Material>::type exp;
+  exp[req1][bid3] = 3;
+  exp[req2][bid1] = 1;
+  exp[req2][bid4] = 4;
+  EXPECT_EQ(exp, t.Map(reqr1));
+  EXPECT_TRUE(t.Map(bidr).empty());
+
+  PrefView<Material> v = t.View(reqr1);
+  EXPECT_FALSE(v.FromMap(exp));
+
+  // arcs missing from a map are given a preference of 0
+  exp[req2].erase(bid1);
+  exp[req1][bid3] = 6;
+  EXPECT_TRUE(v.FromMap(exp));
+  EXPECT_DOUBLE_EQ(0, t.pref(bid1));
+  EXPECT_DOUBLE_EQ(6, t.pref(bid3));
+  EXPECT_DOUBLE_EQ(4, t.pref(bid4));
+  EXPECT_DOUBLE_EQ(2, t.pref(bid2));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(PrefTableTests, AdjustLegacy) {
+  LegacyDoubler* doubler = new LegacyDoubler(tc.get());
+  PrefTable<Material> t;
+  AddAll(&t);
+  PrefView<Material> v = t.View(reqr1);
+
+  Trader* trader = doubler;
+  trader->AdjustMatlPrefs(v);
+  trader->AdjustMatlPrefs(v);
+  EXPECT_EQ(2, doubler->calls);
+  EXPECT_DOUBLE_EQ(4, t.pref(bid1));
+  EXPECT_DOUBLE_EQ(12, t.pref(bid3));
+  EXPECT_DOUBLE_EQ(2, t.pref(bid2));
+
+  delete doubler;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(PrefTableTests, AdjustLegacyConditional) {
+  LegacyConditional* off = new LegacyConditional(tc.get(), false);
+  LegacyConditional* on = new LegacyConditional(tc.get(), true);
+  PrefTable<Material> t;
+  AddAll(&t);
+
+  // an instance that changes nothing does not keep others of its type from
+  // adjusting preferences
+  Trader* trader = off;
+  PrefView<Material> v1 = t.View(reqr1);
+  trader->AdjustMatlPrefs(v1);
+  trader->AdjustMatlPrefs(v1);
+  EXPECT_EQ(2, off->calls);
+  EXPECT_DOUBLE_EQ(1, t.pref(bid1));
+
+  trader = on;
+  PrefView<Material> v2 = t.View(reqr2);
+  trader->AdjustMatlPrefs(v2);
+  EXPECT_EQ(1, on->calls);
+  EXPECT_DOUBLE_EQ(6, t.pref(bid2));
+  EXPECT_DOUBLE_EQ(1, t.pref(bid1));
+
+  delete off;
+  delete on;
+}
@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "exchange_graph.h"
+#include "exchange_test_cases.h"
+#include "greedy_solver.h"
+#include "priority_greedy_solver.h"
+
+using cyclus::Arc;
+using cyclus::ExchangeGraph;
+using cyclus::ExchangeNode;
+using cyclus::ExchangeNodeGroup;
+using cyclus::GreedySolver;
+using cyclus::Match;
+using cyclus::PriorityGreedySolver;
+using cyclus::RequestGroup;
+
+namespace {
+
+/// two requesters contest a supplier, the less preferred requester's group
+/// being first in the graph
+void ConstructContest(ExchangeGraph* g, Arc* a1, Arc* a2) {
+  ExchangeNode::Ptr u1(new ExchangeNode(1));
+  ExchangeNode::Ptr u2(new ExchangeNode(2));
+  ExchangeNode::Ptr v(new ExchangeNode());
+  *a1 = Arc(u1, v);
+  *a2 = Arc(u2, v);
+
+  u1->prefs[*a1] = 1;
+  u1->unit_capacities[*a1].push_back(1);
+  u2->prefs[*a2] = 2;
+  u2->unit_capacities[*a2].push_back(1);
+  v->unit_capacities[*a1].push_back(1);
+  v->unit_capacities[*a2].push_back(1);
+
+  RequestGroup::Ptr gu1(new RequestGroup(1));
+  gu1->AddExchangeNode(u1);
+  gu1->AddCapacity(1);
+  RequestGroup::Ptr gu2(new RequestGroup(2));
+  gu2->AddExchangeNode(u2);
+  gu2->AddCapacity(2);
+  ExchangeNodeGroup::Ptr gv(new ExchangeNodeGroup());
+  gv->AddExchangeNode(v);
+  gv->AddCapacity(1.5);
+
+  g->AddRequestGroup(gu1);
+  g->AddRequestGroup(gu2);
+  g->AddSupplyGroup(gv);
+  g->AddArc(*a1);
+  g->AddArc(*a2);
+}
+
+/// n requesters of exclusive orders of 1 with preferences 1, 2, 3, 1, 2, ...
+/// contest a supplier of cap
+void ConstructExclusive(ExchangeGraph* g, int n, double cap,
+                        std::vector<Arc>* arcs) {
+  ExchangeNode::Ptr v(new ExchangeNode(cap));
+  ExchangeNodeGroup::Ptr sup(new ExchangeNodeGroup());
+  sup->AddExchangeNode(v);
+  sup->AddCapacity(cap);
+  g->AddSupplyGroup(sup);
+  for (int i = 0; i < n; i++) {
+    ExchangeNode::Ptr u(new ExchangeNode(1, true, "commod", i));
+    Arc a(u, v);
+    a.pref(1 + i % 3);
+    u->prefs[a] = a.pref();
+    u->unit_capacities[a].push_back(1);
+    v->unit_capacities[a].push_back(1);
+    RequestGroup::Ptr req(new RequestGroup(1));
+    req->AddExchangeNode(u);
+    req->AddCapacity(1);
+    g->AddRequestGroup(req);
+    g->AddArc(a);
+    arcs->push_back(a);
+  }
+}
+
+}  // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(PriorityGreedySolverTests, GlobalOrder) {
+  ExchangeGraph g;
+  Arc a1, a2;
+  ConstructContest(&g, &a1, &a2);
+
+  // group by group, the first group is supplied first
+  GreedySolver greedy(false, NULL);
+  greedy.Solve(&g);
+  ASSERT_EQ(2, g.matches().size());
+  EXPECT_EQ(Match(a1, 1), g.matches()[0]);
+  EXPECT_EQ(Match(a2, 0.5), g.matches()[1]);
+  g.ClearMatches();
+
+  // the most preferred arc of the graph is supplied first
+  PriorityGreedySolver s(false, NULL);
+  s.Solve(&g);
+  ASSERT_EQ(1, g.matches().size());
+  EXPECT_EQ(Match(a2, 1.5), g.matches()[0]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(PriorityGreedySolverTests, Decompose) {
+  ExchangeGraph g;
+  cyclus::ConstructMarkets(&g, 6);
+  ASSERT_EQ(6, g.Components().size());
+
+  PriorityGreedySolver s(false);
+  s.Solve(&g);
+  std::vector<Match> exp = g.matches();
+  ASSERT_TRUE(exp.size() > 6);
+  g.ClearMatches();
+
+  // components are matched in the global order restricted to each of them
+  s.decompose(true);
+  s.Solve(&g);
+  std::vector<Match> obs = g.matches();
+  std::sort(exp.begin(), exp.end());
+  std::sort(obs.begin(), obs.end());
+  EXPECT_EQ(exp, obs);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(PriorityGreedySolverTests, Clone) {
+  ExchangeGraph g;
+  cyclus::ConstructMarkets(&g, 2);
+
+  PriorityGreedySolver s(true);
+  s.Solve(&g);
+  std::vector<Match> exp = g.matches();
+  g.ClearMatches();
+
+  cyclus::ExchangeSolver* c = s.Clone();
+  EXPECT_TRUE(dynamic_cast<PriorityGreedySolver*>(c) != NULL);
+  c->Solve(&g);
+  EXPECT_EQ(exp, g.matches());
+  delete c;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(PriorityGreedySolverTests, Repair) {
+  ExchangeGraph g;
+  std::vector<Arc> arcs;
+  ConstructExclusive(&g, 4, 2, &arcs);
+
+  // the largest fractions are rounded up
+  PriorityGreedySolver s(true, NULL);
+  double relaxed[] = {0.2, 0.9, 0.5, 0.4};
+  s.Repair(&g, std::vector<double>(relaxed, relaxed + 4));
+  ASSERT_EQ(2, g.matches().size());
+  EXPECT_EQ(Match(arcs[1], 1), g.matches()[0]);
+  EXPECT_EQ(Match(arcs[2], 1), g.matches()[1]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(PriorityGreedySolverTests, RepairFill) {
+  ExchangeGraph g;
+  std::vector<Arc> arcs;
+  ConstructExclusive(&g, 4, 3, &arcs);
+
+  // remaining capacity is matched in the global order
+  PriorityGreedySolver s(true, NULL);
+  double relaxed[] = {0, 0.9, 0, 0};
+  s.Repair(&g, std::vector<double>(relaxed, relaxed + 4));
+  ASSERT_EQ(3, g.matches().size());
+  EXPECT_EQ(Match(arcs[1], 1), g.matches()[0]);
+  EXPECT_EQ(Match(arcs[2], 1), g.matches()[1]);
+  EXPECT_EQ(Match(arcs[0], 1), g.matches()[2]);
+}
@@ -13,9 +13,110 @@
 #include "logger.h"
 #include "prog_translator.h"
 #include "solver_factory.h"
+#include "thread_pool.h"
 
 namespace cyclus {
 
+namespace {
+
+/// a requester (agent 1) with a group of n nodes, each with an arc to a node
+/// of a supplier (agent 2)
+void ConstructMarket(ExchangeGraph* g, int n, double qty, double cap) {
+  RequestGroup::Ptr rg(new RequestGroup(qty));
+  rg->AddCapacity(qty);
+  ExchangeNodeGroup::Ptr sg(new ExchangeNodeGroup());
+  sg->AddCapacity(cap);
+  g->AddRequestGroup(rg);
+  g->AddSupplyGroup(sg);
+  for (int i = 0; i != n; i++) {
+    ExchangeNode::Ptr u(new ExchangeNode(qty, false, "commod", 1));
+    ExchangeNode::Ptr v(new ExchangeNode(cap, false, "commod", 2));
+    u->commod_id = 0;
+    v->commod_id = 0;
+    rg->AddExchangeNode(u);
+    sg->AddExchangeNode(v);
+    Arc a(u, v);
+    a.pref(1 + i);
+    u->unit_capacities[a].push_back(1);
+    v->unit_capacities[a].push_back(1);
+    u->prefs[a] = 1 + i;
+    g->AddArc(a);
+  }
+}
+
+}  // namespace
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ProgTranslatorTests, Update) {
+  SolverFactory sf("clp");
+  OsiSolverInterface* iface = sf.get();
+  CoinMessageHandler h;
+  h.setLogLevel(0);
+  iface->passInMessageHandler(&h);
+
+  ExchangeGraph g1;
+  ConstructMarket(&g1, 2, 5, 3);
+  ProgTranslator pt1(&g1, iface);
+  pt1.ToProg();
+
+  const ProgTranslator::Context& ctx = pt1.ctx();
+  ASSERT_EQ(3, ctx.col_keys.size());
+  EXPECT_EQ(ProgColKey(1, 2, 0), ctx.col_keys[0]);
+  EXPECT_EQ(1, ctx.col_keys[1].n);
+  EXPECT_EQ(ProgColKey(1, -1, 0), ctx.col_keys[2]);
+  SolveProg(iface);
+  EXPECT_DOUBLE_EQ(3, iface->getColSolution()[1]);
+
+  // more supply
+  ExchangeGraph g2;
+  ConstructMarket(&g2, 2, 5, 4);
+  ProgTranslator pt2(&g2, iface);
+  pt2.Translate();
+  ASSERT_TRUE(pt2.SameStructure(ctx));
+  pt2.Update(ctx);
+  EXPECT_DOUBLE_EQ(4, iface->getRowUpper()[0]);
+  ResolveProg(iface, iface->getInfinity(), false, std::vector<double>());
+  EXPECT_DOUBLE_EQ(4, iface->getColSolution()[1]);
+  pt2.FromProg();
+  ASSERT_EQ(1, g2.matches().size());
+  EXPECT_EQ(g2.arcs()[1], g2.matches()[0].first);
+
+  // another arc
+  ExchangeGraph g3;
+  ConstructMarket(&g3, 3, 5, 4);
+  ProgTranslator pt3(&g3, iface);
+  pt3.Translate();
+  EXPECT_FALSE(pt3.SameStructure(pt2.ctx()));
+
+  delete iface;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(ProgTranslatorTests, Pooled) {
+  SolverFactory sf("clp");
+  OsiSolverInterface* iface = sf.get();
+  ThreadPool pool(3);
+
+  ExchangeGraph g;
+  for (int i = 0; i != 20; i++) {
+    ConstructMarket(&g, 1 + i % 4, 5 + i, 3);
+  }
+  ProgTranslator pt(&g, iface);
+  pt.pool(&pool);
+  pt.Translate();
+  ProgTranslator ref(&g, iface);
+  ref.TranslateByRow();
+
+  EXPECT_TRUE(ref.ctx().m.isEquivalent2(pt.ctx().m));
+  EXPECT_EQ(ref.ctx().row_lbs, pt.ctx().row_lbs);
+  EXPECT_EQ(ref.ctx().row_ubs, pt.ctx().row_ubs);
+  EXPECT_EQ(ref.ctx().col_ubs, pt.ctx().col_ubs);
+  EXPECT_EQ(ref.ctx().obj_coeffs, pt.ctx().obj_coeffs);
+  EXPECT_TRUE(pt.SameStructure(ref.ctx()));
+
+  delete iface;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TEST(ProgTranslatorTests, translation) {
   // Logger::ReportLevel() = Logger::ToLogLevel("LEV_DEBUG2");
@@ -211,6 +312,15 @@ TEST(ProgTranslatorTests, translation) {
 
   EXPECT_TRUE(m.isEquivalent2(pt.ctx().m));
 
+  // the row by row translation is the same
+  ProgTranslator ref(&g, iface, excl, max_cost);
+  ref.TranslateByRow();
+  EXPECT_TRUE(m.isEquivalent2(ref.ctx().m));
+  EXPECT_EQ(pt.ctx().row_lbs, ref.ctx().row_lbs);
+  EXPECT_EQ(pt.ctx().row_ubs, ref.ctx().row_ubs);
+  EXPECT_EQ(pt.ctx().obj_coeffs, ref.ctx().obj_coeffs);
+  EXPECT_EQ(pt.ctx().col_keys, ref.ctx().col_keys);
+
   // test population
   EXPECT_NO_THROW(pt.Populate());
 
@@ -216,6 +216,37 @@ TEST(RecorderTest, Datum_addVal) {
   EXPECT_EQ(d, back.data.back());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(RecorderTest, Manager_Deferred) {
+  using cyclus::Recorder;
+  TestBack back;
+  Recorder m;
+  m.set_dump_count(10);
+  m.RegisterBackend(&back);
+
+  cyclus::DatumList buf;
+  m.BeginDeferred(&buf);
+  m.NewDatum("Deferred")
+      ->AddVal("animal", std::string("monkey"))
+      ->Record();
+  m.EndDeferred();
+  ASSERT_EQ(buf.size(), 1);
+
+  m.NewDatum("Live")
+      ->AddVal("animal", std::string("elephant"))
+      ->Record();
+  m.CommitDeferred(&buf);
+  EXPECT_EQ(buf.size(), 0);
+
+  m.Close();
+  ASSERT_EQ(back.flush_count, 2);
+  EXPECT_EQ(back.data[0]->title(), "Live");
+  EXPECT_EQ(back.data[1]->title(), "Deferred");
+  ASSERT_EQ(back.data[1]->vals().size(), 2);
+  EXPECT_STREQ(back.data[1]->vals()[1].first, "animal");
+  EXPECT_EQ(back.data[1]->vals()[1].second.cast<std::string>(), "monkey");
+}
+
 
 //
 // Raw Recorder Test
@@ -28,6 +28,7 @@ using cyclus::ExchangeContext;
 using cyclus::Facility;
 using cyclus::Material;
 using cyclus::Agent;
+using cyclus::PrefBatch;
 using cyclus::PrefMap;
 using cyclus::Request;
 using cyclus::RequestPortfolio;
@@ -43,16 +44,21 @@ class Requester: public TestFacility {
       : TestFacility(ctx),
         i_(i),
         req_ctr_(0),
-        pref_ctr_(0) {}
+        pref_ctr_(0),
+        unchanged_(false) {}
 
   virtual cyclus::Agent* Clone() {
     Requester* m = new Requester(context());
     m->InitFrom(this);
     m->i_ = i_;
     m->port_ = port_;
+    m->unchanged_ = unchanged_;
     return m;
   }
 
+  virtual bool MemoizesPortfolios() { return unchanged_; }
+  virtual bool MatlRequestsUnchanged() { return unchanged_; }
+
   set<RequestPortfolio<Material>::Ptr> GetMatlRequests() {
     set<RequestPortfolio<Material>::Ptr> rps;
     RequestPortfolio<Material>::Ptr rp(new RequestPortfolio<Material>());
@@ -79,6 +85,7 @@ class Requester: public TestFacility {
   int i_;
   int pref_ctr_;
   int req_ctr_;
+  bool unchanged_;
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -87,15 +94,20 @@ class Bidder: public TestFacility {
   Bidder(Context* ctx, std::string commod)
       : TestFacility(ctx),
         commod_(commod),
-        bid_ctr_(0) {}
+        bid_ctr_(0),
+        unchanged_(false) {}
 
   virtual cyclus::Agent* Clone() {
     Bidder* m = new Bidder(context(), commod_);
     m->InitFrom(this);
     m->port_ = port_;
+    m->unchanged_ = unchanged_;
     return m;
   }
 
+  virtual bool MemoizesPortfolios() { return unchanged_; }
+  virtual bool MatlBidsUnchanged() { return unchanged_; }
+
   set<BidPortfolio<Material>::Ptr> GetMatlBids(
       CommodMap<Material>::type& commod_requests) {
     set<BidPortfolio<Material>::Ptr> bps;
@@ -107,6 +119,33 @@ class Bidder: public TestFacility {
   BidPortfolio<Material>::Ptr port_;
   std::string commod_;
   int bid_ctr_;
+  bool unchanged_;
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class BatchAdjuster: public TestFacility {
+ public:
+  BatchAdjuster(Context* ctx) : TestFacility(ctx) {}
+
+  virtual cyclus::Agent* Clone() {
+    BatchAdjuster* m = new BatchAdjuster(context());
+    m->InitFrom(this);
+    return m;
+  }
+
+  // records the batch size and triples all preferences
+  virtual void AdjustMatlPrefs(PrefBatch<Material>::type& prefs) {
+    for (int k = 0; k < prefs.size(); ++k) {
+      for (int i = 0; i < prefs[k].size(); ++i) {
+        for (int j = 0; j < prefs[k].n_bids(i); ++j) {
+          prefs[k].pref(i, j) *= 3;
+        }
+      }
+    }
+    batches_.push_back(prefs.size());
+  }
+
+  std::vector<int> batches_;
 };
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -309,16 +348,137 @@ TEST_F(ResourceExchangeTests, PrefValues) {
   cobs[creq].insert(std::make_pair(cbid, creq->preference()));
 
   ExchangeContext<Material>& context = exchng->ex_ctx();
-  EXPECT_EQ(context.trader_prefs[parent], pobs);
-  EXPECT_EQ(context.trader_prefs[child], cobs);
+  EXPECT_EQ(context.prefs.Map(parent), pobs);
+  EXPECT_EQ(context.prefs.Map(child), cobs);
 
   EXPECT_NO_THROW(exchng->AdjustAll());
 
   pobs[preq].begin()->second = std::pow(preq->preference(), 2);
   cobs[creq].begin()->second = std::pow(std::pow(creq->preference(), 2), 2);
-  EXPECT_EQ(context.trader_prefs[parent], pobs);
-  EXPECT_EQ(context.trader_prefs[child], cobs);
+  EXPECT_EQ(context.prefs.Map(parent), pobs);
+  EXPECT_EQ(context.prefs.Map(child), cobs);
 
   child->Decommission();
   parent->Decommission();
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ResourceExchangeTests, PrefBatches) {
+  BatchAdjuster adjuster(tc.get());
+  Facility* parent = dynamic_cast<Facility*>(adjuster.Clone());
+  Facility* child1 = dynamic_cast<Facility*>(reqr->Clone());
+  Facility* child2 = dynamic_cast<Facility*>(reqr->Clone());
+  parent->Build(NULL);
+  child1->Build(parent);
+  child2->Build(parent);
+
+  Requester* c1cast = dynamic_cast<Requester*>(child1);
+  Requester* c2cast = dynamic_cast<Requester*>(child2);
+  RequestPortfolio<Material>::Ptr rp1(new RequestPortfolio<Material>());
+  Request<Material>* req1 = rp1->AddRequest(mat, c1cast, commod, pref);
+  c1cast->port_ = rp1;
+  RequestPortfolio<Material>::Ptr rp2(new RequestPortfolio<Material>());
+  Request<Material>* req2 = rp2->AddRequest(mat, c2cast, commod, pref);
+  c2cast->port_ = rp2;
+
+  Bidder* bidr = new Bidder(tc.get(), commod);
+  BidPortfolio<Material>::Ptr bp(new BidPortfolio<Material>());
+  Bid<Material>* bid1 = bp->AddBid(req1, mat, bidr);
+  Bid<Material>* bid2 = bp->AddBid(req2, mat, bidr);
+  bidr->port_ = bp;
+  Facility* bclone = dynamic_cast<Facility*>(bidr->Clone());
+  bclone->Build(NULL);
+
+  EXPECT_NO_THROW(exchng->AddAllRequests());
+  EXPECT_NO_THROW(exchng->AddAllBids());
+  EXPECT_NO_THROW(exchng->AdjustAll());
+
+  // the parent adjusts the preferences of both children in one call, after
+  // the children squared their own
+  BatchAdjuster* pcast = dynamic_cast<BatchAdjuster*>(parent);
+  ASSERT_EQ(1, pcast->batches_.size());
+  EXPECT_EQ(2, pcast->batches_[0]);
+  EXPECT_EQ(1, c1cast->pref_ctr_);
+  EXPECT_EQ(1, c2cast->pref_ctr_);
+  ExchangeContext<Material>& context = exchng->ex_ctx();
+  EXPECT_DOUBLE_EQ(3 * std::pow(pref, 2), context.prefs.pref(bid1));
+  EXPECT_DOUBLE_EQ(3 * std::pow(pref, 2), context.prefs.pref(bid2));
+
+  child1->Decommission();
+  child2->Decommission();
+  parent->Decommission();
+  bclone->Decommission();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ResourceExchangeTests, Memoized) {
+  reqr->unchanged_ = true;
+  Facility* child1 = dynamic_cast<Facility*>(reqr->Clone());
+  Facility* child2 = dynamic_cast<Facility*>(reqr->Clone());
+  child1->Build(NULL);
+  child2->Build(NULL);
+  Requester* c1cast = dynamic_cast<Requester*>(child1);
+  Requester* c2cast = dynamic_cast<Requester*>(child2);
+  RequestPortfolio<Material>::Ptr rp1(new RequestPortfolio<Material>());
+  Request<Material>* req1 = rp1->AddRequest(mat, c1cast, commod, pref);
+  c1cast->port_ = rp1;
+  RequestPortfolio<Material>::Ptr rp2(new RequestPortfolio<Material>());
+  Request<Material>* req2 = rp2->AddRequest(mat, c2cast, commod, pref);
+  c2cast->port_ = rp2;
+
+  Bidder* bidr = new Bidder(tc.get(), commod);
+  bidr->unchanged_ = true;
+  Bidder* bcast = dynamic_cast<Bidder*>(bidr->Clone());
+  bcast->Build(NULL);
+  BidPortfolio<Material>::Ptr bp(new BidPortfolio<Material>());
+  bp->AddBid(req1, mat, bcast);
+  bp->AddBid(req2, mat, bcast);
+  bcast->port_ = bp;
+
+  // traders are queried in the first exchange
+  exchng->AddAllRequests();
+  exchng->AddAllBids();
+  EXPECT_EQ(1, c1cast->req_ctr_);
+  EXPECT_EQ(1, c2cast->req_ctr_);
+  EXPECT_EQ(1, bcast->bid_ctr_);
+
+  // and their portfolios are reused in the next
+  ResourceExchange<Material> next(tc.get());
+  next.AddAllRequests();
+  next.AddAllBids();
+  EXPECT_EQ(1, c1cast->req_ctr_);
+  EXPECT_EQ(1, c2cast->req_ctr_);
+  EXPECT_EQ(1, bcast->bid_ctr_);
+  ASSERT_EQ(2, next.ex_ctx().requests.size());
+  ASSERT_EQ(1, next.ex_ctx().bids.size());
+  EXPECT_EQ(bp, next.ex_ctx().bids[0]);
+  EXPECT_EQ(2, next.ex_ctx().bids_by_request.size());
+
+  // bids are queried again when requests they bid on change
+  c2cast->unchanged_ = false;
+  RequestPortfolio<Material>::Ptr rp3(new RequestPortfolio<Material>());
+  Request<Material>* req3 = rp3->AddRequest(mat, c2cast, commod, pref);
+  c2cast->port_ = rp3;
+  BidPortfolio<Material>::Ptr bp2(new BidPortfolio<Material>());
+  bp2->AddBid(req1, mat, bcast);
+  bp2->AddBid(req3, mat, bcast);
+  bcast->port_ = bp2;
+
+  ResourceExchange<Material> last(tc.get());
+  last.AddAllRequests();
+  last.AddAllBids();
+  EXPECT_EQ(1, c1cast->req_ctr_);
+  EXPECT_EQ(2, c2cast->req_ctr_);
+  EXPECT_EQ(2, bcast->bid_ctr_);
+  ASSERT_EQ(1, last.ex_ctx().bids.size());
+  EXPECT_EQ(bp2, last.ex_ctx().bids[0]);
+
+  // the portfolios of traders that do not memoize them are not kept
+  EXPECT_TRUE(c2cast->matl_memo().requests.empty());
+  EXPECT_FALSE(c1cast->matl_memo().requests.empty());
+
+  child1->Decommission();
+  child2->Decommission();
+  bcast->Decommission();
+  delete bidr;
+}
@@ -159,15 +159,27 @@ class SimInitTest : public ::testing::Test {
   int transid(cy::Context* ctx) { return ctx->trans_id_; }
 
   cy::SimInfo siminfo(cy::Context* ctx) { return ctx->si_; }
-  std::set<Agent*> agent_list(cy::Context* ctx) { return ctx->agent_list_; }
+  std::set<Agent*> agent_list(cy::Context* ctx) {
+    return std::set<Agent*>(ctx->agent_list_.begin(), ctx->agent_list_.end());
+  }
   std::map<int, cy::TimeListener*> tickers(cy::Timer* ti) { return ti->tickers_; }
 
   std::map<int, std::vector<std::pair<std::string, Agent*> > >
   build_queue(cy::Timer* ti) {
-    return ti->build_queue_;
+    std::map<int, std::vector<std::pair<std::string, Agent*> > > queue;
+    std::multimap<int, std::pair<std::string, Agent*> >::iterator it;
+    for (it = ti->build_queue_.begin(); it != ti->build_queue_.end(); ++it) {
+      queue[it->first].push_back(it->second);
+    }
+    return queue;
   }
   std::map<int, std::vector<Agent*> > decom_queue(cy::Timer* ti) {
-    return ti->decom_queue_;
+    std::map<int, std::vector<Agent*> > queue;
+    std::map<std::pair<int, unsigned long>, Agent*>::iterator it;
+    for (it = ti->decom_queue_.begin(); it != ti->decom_queue_.end(); ++it) {
+      queue[it->first.first].push_back(it->second);
+    }
+    return queue;
   }
 
   cy::Context* ctx;
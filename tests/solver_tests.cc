@@ -148,4 +148,114 @@ TYPED_TEST(ExchangeSolverTest, ExclusiveGreedySolver) {
 
 #endif  // GTEST_HAS_TYPED_TEST
 
+TEST(ProgSolverTests, Persistent) {
+  ExchangeGraph g;
+  ConstructMarkets(&g, 5);
+  ProgSolver cold("cbc", true);
+  double exp = cold.Solve(&g);
+  ASSERT_FALSE(g.matches().empty());
+
+  ProgSolver warm("cbc", true);
+  warm.persistent(true);
+  EXPECT_TRUE(warm.persistent());
+  for (int i = 0; i < 3; ++i) {
+    g.ClearMatches();
+    EXPECT_NEAR(exp, warm.Solve(&g), 1e-8);
+    EXPECT_FALSE(g.matches().empty());
+  }
+
+  // a structurally different graph is reloaded
+  ExchangeGraph g2;
+  ConstructMarkets(&g2, 6);
+  exp = cold.Solve(&g2);
+  g2.ClearMatches();
+  EXPECT_NEAR(exp, warm.Solve(&g2), 1e-8);
+}
+
+/// n exclusive orders of 1 contest a supplier of supply
+void ConstructExclusive(ExchangeGraph* g, int n, double supply) {
+  ExchangeNode::Ptr v(new ExchangeNode(supply));
+  ExchangeNodeGroup::Ptr sup(new ExchangeNodeGroup());
+  sup->AddExchangeNode(v);
+  sup->AddCapacity(supply);
+  g->AddSupplyGroup(sup);
+  for (int i = 0; i < n; i++) {
+    ExchangeNode::Ptr u(new ExchangeNode(1, true, "commod", i));
+    Arc a(u, v);
+    a.pref(1 + i % 4);
+    u->prefs[a] = a.pref();
+    u->unit_capacities[a].push_back(1);
+    v->unit_capacities[a].push_back(1);
+    RequestGroup::Ptr req(new RequestGroup(1));
+    req->AddExchangeNode(u);
+    req->AddCapacity(1);
+    g->AddRequestGroup(req);
+    g->AddArc(a);
+  }
+}
+
+TEST(ProgSolverTests, PersistentDecomposed) {
+  ExchangeGraph g;
+  ConstructMarkets(&g, 5);
+  ProgSolver cold("cbc", true);
+  double exp = cold.Solve(&g);
+
+  // components are solved from scratch and the program of the whole graph
+  // is kept for its next solve
+  ProgSolver warm("cbc", true);
+  warm.persistent(true);
+  for (int i = 0; i < 4; ++i) {
+    warm.decompose(i % 2 == 1);
+    g.ClearMatches();
+    EXPECT_NEAR(exp, warm.Solve(&g), 1e-8);
+    EXPECT_TRUE(warm.finished());
+    EXPECT_FALSE(g.matches().empty());
+  }
+}
+
+TEST(ProgSolverTests, Relax) {
+  ExchangeGraph g;
+  ConstructExclusive(&g, 10, 4.5);
+
+  ProgSolver milp("cbc", true);
+  double exp = milp.Solve(&g);
+  g.ClearMatches();
+
+  ProgSolver relaxed("cbc", true);
+  relaxed.relax(true);
+  EXPECT_TRUE(relaxed.relax());
+  double obs = relaxed.Solve(&g);
+  EXPECT_TRUE(relaxed.finished());
+  EXPECT_GE(obs, exp - 1e-8);
+
+  // only whole orders are matched, within the supplier's capacity
+  ASSERT_EQ(4, g.matches().size());
+  for (int i = 0; i < g.matches().size(); i++) {
+    EXPECT_DOUBLE_EQ(1, g.matches()[i].second);
+  }
+}
+
+TEST(ProgSolverTests, Budget) {
+  ExchangeGraph g;
+  ConstructExclusive(&g, 20, 9.5);
+
+  // without a budget, the search is not stopped at the maximum solution time
+  // and only whole exclusive orders are matched
+  ProgSolver s("cbc", 1, true, false, false);
+  EXPECT_GT(0, s.budget());
+  s.Solve(&g);
+  EXPECT_TRUE(s.finished());
+  ASSERT_EQ(9, g.matches().size());
+  for (int i = 0; i < g.matches().size(); i++) {
+    EXPECT_DOUBLE_EQ(1, g.matches()[i].second);
+  }
+
+  // a budget stops the search, which the caller must check
+  g.ClearMatches();
+  ProgSolver b("cbc", true);
+  b.budget(1e-9);
+  b.Solve(&g);
+  EXPECT_FALSE(b.finished());
+}
+
 }  // namespace cyclus
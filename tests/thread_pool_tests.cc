@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "error.h"
+#include "thread_pool.h"
+
+namespace {
+
+void Square(std::vector<int>* out, int i) {
+  (*out)[i] = i * i;
+}
+
+void Throw(int i) {
+  if (i == 7) {
+    throw cyclus::ValueError("task failed");
+  }
+}
+
+/// squares [10 * i, 10 * i + 10) using the same pool
+void SquareRow(cyclus::ThreadPool* pool, std::vector<int>* out, int i) {
+  std::vector<int> row(10, -1);
+  pool->ParallelFor(10, std::bind(&Square, &row, std::placeholders::_1));
+  for (int j = 0; j < 10; ++j) {
+    (*out)[10 * i + j] = row[j] + 20 * i * j + 100 * i * i;
+  }
+}
+
+}  // namespace
+
+TEST(ThreadPoolTests, Size) {
+  cyclus::ThreadPool serial(0);
+  EXPECT_EQ(1, serial.size());
+  cyclus::ThreadPool pool(4);
+  EXPECT_EQ(4, pool.size());
+}
+
+TEST(ThreadPoolTests, ParallelFor) {
+  cyclus::ThreadPool pool(4);
+  for (int n = 0; n < 200; n += 13) {
+    std::vector<int> out(n, -1);
+    pool.ParallelFor(n, std::bind(&Square, &out, std::placeholders::_1));
+    for (int i = 0; i < n; ++i) {
+      EXPECT_EQ(i * i, out[i]);
+    }
+  }
+}
+
+TEST(ThreadPoolTests, Serial) {
+  cyclus::ThreadPool pool(1);
+  std::vector<int> out(50, -1);
+  pool.ParallelFor(50, std::bind(&Square, &out, std::placeholders::_1));
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_EQ(i * i, out[i]);
+  }
+}
+
+TEST(ThreadPoolTests, Exception) {
+  cyclus::ThreadPool pool(3);
+  EXPECT_THROW(pool.ParallelFor(20, &Throw), cyclus::ValueError);
+
+  // the pool is still usable afterwards
+  std::vector<int> out(20, -1);
+  pool.ParallelFor(20, std::bind(&Square, &out, std::placeholders::_1));
+  EXPECT_EQ(19 * 19, out[19]);
+}
+
+TEST(ThreadPoolTests, Nested) {
+  cyclus::ThreadPool pool(4);
+  std::vector<int> out(100, -1);
+  pool.ParallelFor(10, std::bind(&SquareRow, &pool, &out,
+                                 std::placeholders::_1));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i * i, out[i]);
+  }
+}
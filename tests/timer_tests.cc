@@ -1,9 +1,15 @@
+#include <algorithm>
+
 #include <gtest/gtest.h>
 
 #include "context.h"
+#include "exchange_graph.h"
+#include "exchange_test_cases.h"
 #include "facility.h"
+#include "rec_backend.h"
 #include "greedy_preconditioner.h"
 #include "greedy_solver.h"
+#include "material.h"
 #include "recorder.h"
 #include "timer.h"
 #include "sqlite_back.h"
@@ -63,6 +69,408 @@ class Snapper : public cyclus::Facility {
   bool snap;
 };
 
+class Ticker : public cyclus::Facility {
+ public:
+  Ticker(cyclus::Context* ctx, bool safe)
+      : cyclus::Facility(ctx),
+        safe_(safe) {
+    spec(safe ? ":timer_tests:SafeTicker" : ":timer_tests:Ticker");
+  }
+  virtual ~Ticker() {}
+
+  virtual cyclus::Agent* Clone() { return new Ticker(context(), safe_); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+  virtual Json::Value annotations() {
+    Json::Value anno(Json::objectValue);
+    anno["thread_safe"] = safe_;
+    return anno;
+  }
+
+  void Tick() {
+    context()->NewDatum("Ticks")
+        ->AddVal("AgentId", id())
+        ->AddVal("Time", context()->time())
+        ->Record();
+  }
+  void Tock() {}
+
+ private:
+  bool safe_;
+};
+
+class Exchanger : public cyclus::Facility {
+ public:
+  explicit Exchanger(cyclus::Context* ctx)
+      : cyclus::Facility(ctx),
+        solves(0),
+        same(0),
+        pooled(false) {}
+  virtual ~Exchanger() {}
+
+  virtual cyclus::Agent* Clone() { return new Exchanger(context()); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+
+  /// solves a graph of independent markets whole and by component
+  void Tick() {
+    cyclus::ExchangeGraph g;
+    cyclus::ConstructMarkets(&g, 20);
+    cyclus::GreedySolver s(false);
+    s.sim_ctx(context());
+    s.Solve(&g);
+    std::vector<cyclus::Match> exp = g.matches();
+    g.ClearMatches();
+
+    s.decompose(true);
+    s.Solve(&g);
+    solves++;
+    pooled = context()->thread_pool() != NULL;
+    if (!exp.empty() && exp == g.matches()) {
+      same++;
+    }
+  }
+  void Tock() {}
+
+  int solves;
+  int same;
+  bool pooled;
+};
+
+class Marketeer : public cyclus::Facility {
+ public:
+  Marketeer(cyclus::Context* ctx, bool safe)
+      : cyclus::Facility(ctx),
+        safe_(safe),
+        fuel_(Fuel(1)) {
+    spec(safe ? ":timer_tests:SafeMarketeer" : ":timer_tests:Marketeer");
+  }
+  virtual ~Marketeer() {}
+
+  virtual cyclus::Agent* Clone() { return new Marketeer(context(), safe_); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+  virtual Json::Value annotations() {
+    Json::Value anno(Json::objectValue);
+    anno["thread_safe"] = safe_;
+    return anno;
+  }
+
+  void Tick() {}
+  void Tock() {}
+
+  /// requests one unit of fuel, the targets and offers of which are built
+  /// beforehand because a thread-safe trader must not create resources while
+  /// it is queried
+  virtual std::set<cyclus::RequestPortfolio<cyclus::Material>::Ptr>
+      GetMatlRequests() {
+    RecordPortfolio("request");
+    cyclus::RequestPortfolio<cyclus::Material>::Ptr port(
+        new cyclus::RequestPortfolio<cyclus::Material>());
+    port->AddRequest(fuel_, this, "fuel", 1 + id() % 7);
+    std::set<cyclus::RequestPortfolio<cyclus::Material>::Ptr> ports;
+    ports.insert(port);
+    return ports;
+  }
+
+  /// offers a unit of fuel to every other requester
+  virtual std::set<cyclus::BidPortfolio<cyclus::Material>::Ptr> GetMatlBids(
+      cyclus::CommodMap<cyclus::Material>::type& commod_requests) {
+    RecordPortfolio("bid");
+    std::set<cyclus::BidPortfolio<cyclus::Material>::Ptr> ports;
+    cyclus::CommodMap<cyclus::Material>::type::iterator it =
+        commod_requests.find("fuel");
+    if (it == commod_requests.end()) {
+      return ports;
+    }
+    cyclus::BidPortfolio<cyclus::Material>::Ptr port(
+        new cyclus::BidPortfolio<cyclus::Material>());
+    for (int i = 0; i < it->second.size(); ++i) {
+      cyclus::Request<cyclus::Material>* r = it->second[i];
+      if (r->requester() != this) {
+        port->AddBid(r, fuel_, this);
+      }
+    }
+    port->AddConstraint(cyclus::CapacityConstraint<cyclus::Material>(1));
+    ports.insert(port);
+    return ports;
+  }
+
+  virtual void GetMatlTrades(
+      const std::vector<cyclus::Trade<cyclus::Material> >& trades,
+      std::vector<std::pair<cyclus::Trade<cyclus::Material>,
+                            cyclus::Material::Ptr> >& responses) {
+    for (int i = 0; i < trades.size(); ++i) {
+      cyclus::Material::Ptr m =
+          cyclus::Material::Create(this, trades[i].amt, fuel_->comp());
+      responses.push_back(std::make_pair(trades[i], m));
+    }
+  }
+
+  virtual void AcceptMatlTrades(
+      const std::vector<std::pair<cyclus::Trade<cyclus::Material>,
+                                  cyclus::Material::Ptr> >& responses) {}
+
+  static cyclus::Material::Ptr Fuel(double qty) {
+    cyclus::CompMap cm;
+    cm[922350000] = 1;
+    return cyclus::Material::CreateUntracked(
+        qty, cyclus::Composition::CreateFromMass(cm));
+  }
+
+ private:
+  void RecordPortfolio(std::string kind) {
+    context()->NewDatum("Portfolios")
+        ->AddVal("AgentId", id())
+        ->AddVal("Kind", kind)
+        ->AddVal("Pooled", context()->thread_pool() != NULL)
+        ->AddVal("ResourceId", fuel_->state_id())
+        ->AddVal("QualId", fuel_->comp()->id())
+        ->Record();
+  }
+
+  bool safe_;
+  cyclus::Material::Ptr fuel_;
+};
+
+/// requests a unit of fuel every timestep and, whenever its product requests
+/// are queried, notes how much fuel it has received so far
+class Refiner : public cyclus::Facility {
+ public:
+  explicit Refiner(cyclus::Context* ctx)
+      : cyclus::Facility(ctx),
+        received(0) {}
+  virtual ~Refiner() {}
+
+  virtual cyclus::Agent* Clone() { return new Refiner(context()); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+
+  void Tick() {}
+  void Tock() {}
+
+  virtual std::set<cyclus::RequestPortfolio<cyclus::Material>::Ptr>
+      GetMatlRequests() {
+    cyclus::RequestPortfolio<cyclus::Material>::Ptr port(
+        new cyclus::RequestPortfolio<cyclus::Material>());
+    port->AddRequest(Marketeer::Fuel(1), this, "fuel");
+    std::set<cyclus::RequestPortfolio<cyclus::Material>::Ptr> ports;
+    ports.insert(port);
+    return ports;
+  }
+
+  virtual void AcceptMatlTrades(
+      const std::vector<std::pair<cyclus::Trade<cyclus::Material>,
+                                  cyclus::Material::Ptr> >& responses) {
+    for (int i = 0; i < responses.size(); ++i) {
+      received += responses[i].second->quantity();
+    }
+  }
+
+  virtual std::set<cyclus::RequestPortfolio<cyclus::Product>::Ptr>
+      GetProductRequests() {
+    seen.push_back(received);
+    return std::set<cyclus::RequestPortfolio<cyclus::Product>::Ptr>();
+  }
+
+  double received;
+  /// the fuel received when the product requests were queried
+  std::vector<double> seen;
+};
+
+/// counts the steps it is run and notes the solvers it is given
+class CountingMarket : public cyclus::Market {
+ public:
+  CountingMarket()
+      : collects(0),
+        solves(0),
+        executes(0),
+        solver_(NULL) {}
+
+  virtual void Execute() {
+    Collect();
+    Solve();
+    ExecuteTrades();
+  }
+  virtual void Collect() { collects++; }
+  virtual void Solve() {
+    solves++;
+    solvers.insert(solver_);
+  }
+  virtual void ExecuteTrades() { executes++; }
+  virtual void solver(cyclus::ExchangeSolver* s) { solver_ = s; }
+  cyclus::ExchangeSolver* solver() const { return solver_; }
+
+  int collects;
+  int solves;
+  int executes;
+  std::set<cyclus::ExchangeSolver*> solvers;
+
+ private:
+  cyclus::ExchangeSolver* solver_;
+};
+
+class Sleeper : public cyclus::Facility {
+ public:
+  Sleeper(cyclus::Context* ctx, int period)
+      : cyclus::Facility(ctx),
+        period_(period),
+        ticks(0),
+        tocks(0) {}
+  virtual ~Sleeper() {}
+
+  virtual cyclus::Agent* Clone() { return new Sleeper(context(), period_); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+
+  virtual void Decommission() {
+    decommissioned.push_back(std::make_pair(context()->time(), id()));
+    cyclus::Facility::Decommission();
+  }
+
+  void Tick() { ticks++; }
+  void Tock() { tocks++; }
+  int NextWake(int time) { return time + period_; }
+
+  int ticks;
+  int tocks;
+  static std::vector<std::pair<int, int> > decommissioned;
+
+ private:
+  int period_;
+};
+
+std::vector<std::pair<int, int> > Sleeper::decommissioned;
+
+class Waker : public cyclus::Facility {
+ public:
+  Waker(cyclus::Context* ctx, cyclus::TimeListener* target, int t)
+      : cyclus::Facility(ctx),
+        target_(target),
+        t_(t) {}
+  virtual ~Waker() {}
+
+  virtual cyclus::Agent* Clone() { return new Waker(context(), target_, t_); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() { return cyclus::Inventories(); }
+
+  void Tick() {
+    if (context()->time() == t_) {
+      context()->Wake(target_);
+    }
+  }
+  void Tock() {}
+
+ private:
+  cyclus::TimeListener* target_;
+  int t_;
+};
+
+class Stocker : public cyclus::Facility {
+ public:
+  Stocker(cyclus::Context* ctx) : cyclus::Facility(ctx) {}
+  virtual ~Stocker() {}
+
+  virtual cyclus::Agent* Clone() { return new Stocker(context()); }
+  virtual void InitInv(cyclus::Inventories& inv) {}
+  virtual cyclus::Inventories SnapshotInv() {
+    cyclus::Inventories invs;
+    invs["stock"] = stock;
+    return invs;
+  }
+
+  // adds a second material at t=2, empties the stock at t=3 and refills it
+  // at t=4
+  void Tick() {
+    cyclus::CompMap v;
+    v[922350000] = 1;
+    v[922380000] = 3;
+    cyclus::Composition::Ptr c = cyclus::Composition::CreateFromMass(v);
+    int t = context()->time();
+    if (t == 0 || t == 2 || t == 4) {
+      stock.push_back(cyclus::Material::CreateUntracked(2, c));
+    } else if (t == 3) {
+      stock.clear();
+    }
+  }
+  void Tock() {}
+
+  std::vector<cyclus::Resource::Ptr> stock;
+};
+
+class InvBack : public cyclus::RecBackend {
+ public:
+  virtual void Notify(cyclus::DatumList data) {
+    for (int i = 0; i < data.size(); ++i) {
+      cyclus::Datum::Vals v = data[i]->vals();
+      if (data[i]->title() == "ExplicitInventoryCompact") {
+        compact.push_back(std::make_pair(v[2].second.cast<int>(),
+                                         v[4].second.cast<double>()));
+      } else if (data[i]->title() == "ExplicitInventory") {
+        full.push_back(std::make_pair(v[2].second.cast<int>(),
+                                      v[5].second.cast<double>()));
+      }
+    }
+  }
+  virtual std::string Name() { return "InvBack"; }
+  virtual void Flush() {}
+  virtual void Close() {}
+
+  std::vector<std::pair<int, double> > compact;
+  std::vector<std::pair<int, double> > full;
+};
+
+class TickBack : public cyclus::RecBackend {
+ public:
+  virtual void Notify(cyclus::DatumList data) {
+    for (int i = 0; i < data.size(); ++i) {
+      counts[data[i]->title()]++;
+      if (data[i]->title() == "Ticks") {
+        ids.push_back(data[i]->vals()[1].second.cast<int>());
+      }
+    }
+  }
+  virtual std::string Name() { return "TickBack"; }
+  virtual void Flush() {}
+  virtual void Close() {}
+
+  std::vector<int> ids;
+  std::map<std::string, int> counts;
+};
+
+class MarketBack : public cyclus::RecBackend {
+ public:
+  MarketBack() : pooled(0) {}
+
+  virtual void Notify(cyclus::DatumList data) {
+    for (int i = 0; i < data.size(); ++i) {
+      const cyclus::Datum::Vals& v = data[i]->vals();
+      if (data[i]->title() == "Portfolios") {
+        portfolios.push_back(std::make_pair(
+            v[1].second.cast<int>(), v[2].second.cast<std::string>()));
+        pooled += v[3].second.cast<bool>();
+        ids.push_back(std::make_pair(v[4].second.cast<int>(),
+                                     v[5].second.cast<int>()));
+      } else if (data[i]->title() == "Transactions") {
+        trades.push_back(std::make_pair(v[2].second.cast<int>(),
+                                        v[3].second.cast<int>()));
+      }
+    }
+  }
+  virtual std::string Name() { return "MarketBack"; }
+  virtual void Flush() {}
+  virtual void Close() {}
+
+  /// (agent id, portfolio kind) in recording order
+  std::vector<std::pair<int, std::string> > portfolios;
+  /// (resource id, composition id) of the portfolios' resources in recording
+  /// order
+  std::vector<std::pair<int, int> > ids;
+  /// (sender id, receiver id) in recording order
+  std::vector<std::pair<int, int> > trades;
+  int pooled;
+};
+
 TEST(TimerTests, BareSim) {
   cyclus::Recorder rec;
   cyclus::Timer ti;
@@ -169,3 +577,373 @@ TEST(TimerTests, DoubleDecom) {
   ti.RunSim();
   EXPECT_EQ(1, Dier::decom_count);
 }
+
+TEST(TimerTests, ThreadedTickOrder) {
+  cyclus::Recorder rec;
+  TickBack back;
+  rec.RegisterBackend(&back);
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(3));
+  ctx.threads(4);
+  EXPECT_EQ(4, ctx.sim_info().threads);
+
+  std::vector<int> ids;
+  for (int i = 0; i < 40; ++i) {
+    Ticker* t = new Ticker(&ctx, i % 3 != 0);
+    t->Build(NULL);
+    ids.push_back(t->id());
+  }
+
+  ti.RunSim();
+  rec.Flush();
+
+  ASSERT_EQ(3 * ids.size(), back.ids.size());
+  for (int i = 0; i < back.ids.size(); ++i) {
+    EXPECT_EQ(ids[i % ids.size()], back.ids[i]);
+  }
+}
+
+TEST(TimerTests, SleepingListeners) {
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(10));
+
+  Sleeper* every = new Sleeper(&ctx, 1);
+  every->Build(NULL);
+  Sleeper* third = new Sleeper(&ctx, 3);
+  third->Build(NULL);
+  Sleeper* never = new Sleeper(&ctx, 1000);
+  never->Build(NULL);
+  Waker* w = new Waker(&ctx, never, 5);
+  w->Build(NULL);
+
+  ti.RunSim();
+
+  EXPECT_EQ(10, every->ticks);
+  EXPECT_EQ(10, every->tocks);
+  EXPECT_EQ(4, third->ticks);  // 0, 3, 6, 9
+  EXPECT_EQ(4, third->tocks);
+  EXPECT_EQ(1, never->ticks);  // woken after its tick at time 5
+  EXPECT_EQ(2, never->tocks);  // 0, 5
+}
+
+TEST(TimerTests, BulkDecomSched) {
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(5));
+
+  std::vector<cyclus::Agent*> ags;
+  std::vector<int> ids;
+  for (int i = 0; i < 4; ++i) {
+    Sleeper* s = new Sleeper(&ctx, 1);
+    s->Build(NULL);
+    ags.push_back(s);
+    ids.push_back(s->id());
+  }
+  ctx.SchedDecoms(ags, 3);
+  ctx.SchedDecom(ags[0], 1);  // reschedule
+  EXPECT_TRUE(ti.CancelDecom(ags[1]));
+  EXPECT_FALSE(ti.CancelDecom(ags[1]));
+
+  Sleeper::decommissioned.clear();
+  ti.RunSim();
+
+  ASSERT_EQ(3, Sleeper::decommissioned.size());
+  EXPECT_EQ(std::make_pair(1, ids[0]), Sleeper::decommissioned[0]);
+  EXPECT_EQ(std::make_pair(3, ids[2]), Sleeper::decommissioned[1]);
+  EXPECT_EQ(std::make_pair(3, ids[3]), Sleeper::decommissioned[2]);
+  EXPECT_EQ(5, dynamic_cast<Sleeper*>(ags[1])->ticks);
+}
+
+TEST(TimerTests, RecordTimings) {
+  cyclus::Recorder rec;
+  TickBack back;
+  rec.RegisterBackend(&back);
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  cyclus::SimInfo si(3);
+  si.record_timings = true;
+  ctx.InitSim(si);
+
+  for (int i = 0; i < 4; ++i) {
+    Ticker* t = new Ticker(&ctx, i % 2 == 0);
+    t->Build(NULL);
+  }
+
+  ti.RunSim();
+  rec.Flush();
+
+  // Build, Tick, ResEx, Tock, Decom and request collection for each of the
+  // two (empty) exchanges every timestep
+  EXPECT_EQ(3 * 7, back.counts["PhaseTimings"]);
+  // two archetypes, tick and tock, every timestep
+  EXPECT_EQ(3 * 2 * 2, back.counts["ArchetypeTimings"]);
+}
+
+TEST(TimerTests, NoTimings) {
+  cyclus::Recorder rec;
+  TickBack back;
+  rec.RegisterBackend(&back);
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(3));
+  Ticker* t = new Ticker(&ctx, false);
+  t->Build(NULL);
+
+  ti.RunSim();
+  rec.Flush();
+
+  EXPECT_EQ(0, back.counts["PhaseTimings"]);
+  EXPECT_EQ(0, back.counts["ArchetypeTimings"]);
+}
+
+void RunInventorySim(InvBack* back, bool changes, int threads) {
+  cyclus::Recorder rec;
+  rec.RegisterBackend(back);
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  cyclus::SimInfo si(5);
+  si.explicit_inventory = true;
+  si.explicit_inventory_compact = true;
+  si.explicit_inventory_changes = changes;
+  ctx.InitSim(si);
+  ctx.threads(threads);
+
+  Stocker* s = new Stocker(&ctx);
+  s->Build(NULL);
+
+  ti.RunSim();
+  rec.Flush();
+}
+
+TEST(TimerTests, ExplicitInventory) {
+  InvBack back;
+  RunInventorySim(&back, false, 1);
+
+  ASSERT_EQ(4, back.compact.size());
+  EXPECT_EQ(std::make_pair(0, 2.0), back.compact[0]);
+  EXPECT_EQ(std::make_pair(1, 2.0), back.compact[1]);
+  EXPECT_EQ(std::make_pair(2, 4.0), back.compact[2]);
+  EXPECT_EQ(std::make_pair(4, 2.0), back.compact[3]);
+
+  ASSERT_EQ(8, back.full.size());
+  EXPECT_EQ(0, back.full[0].first);
+  EXPECT_DOUBLE_EQ(0.5, back.full[0].second);
+  EXPECT_DOUBLE_EQ(1.5, back.full[1].second);
+  EXPECT_EQ(2, back.full[4].first);
+  EXPECT_DOUBLE_EQ(1.0, back.full[4].second);
+  EXPECT_DOUBLE_EQ(3.0, back.full[5].second);
+}
+
+TEST(TimerTests, ExplicitInventoryChanges) {
+  InvBack back;
+  RunInventorySim(&back, true, 1);
+
+  ASSERT_EQ(4, back.compact.size());
+  EXPECT_EQ(std::make_pair(0, 2.0), back.compact[0]);
+  EXPECT_EQ(std::make_pair(2, 4.0), back.compact[1]);
+  EXPECT_EQ(std::make_pair(3, 0.0), back.compact[2]);  // emptied
+  EXPECT_EQ(std::make_pair(4, 2.0), back.compact[3]);
+
+  ASSERT_EQ(8, back.full.size());
+  EXPECT_EQ(std::make_pair(3, 0.0), back.full[4]);
+  EXPECT_EQ(std::make_pair(3, 0.0), back.full[5]);
+}
+
+TEST(TimerTests, ExplicitInventoryThreaded) {
+  InvBack serial;
+  RunInventorySim(&serial, true, 1);
+  InvBack threaded;
+  RunInventorySim(&threaded, true, 3);
+
+  EXPECT_EQ(serial.compact, threaded.compact);
+  EXPECT_EQ(serial.full, threaded.full);
+}
+
+TEST(TimerTests, ThreadedDecomposedSolve) {
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(3));
+  ctx.threads(4);
+  Exchanger* ex = new Exchanger(&ctx);
+  ex->Build(NULL);
+
+  ti.RunSim();
+  EXPECT_EQ(3, ex->solves);
+  EXPECT_EQ(3, ex->same);
+  EXPECT_TRUE(ex->pooled);
+  EXPECT_TRUE(ctx.thread_pool() == NULL);  // pool only lives while running
+}
+
+void RunMarketSim(MarketBack* back, int threads, bool concurrent = false) {
+  cyclus::Recorder rec;
+  rec.RegisterBackend(back);
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(3));
+  ctx.threads(threads);
+  cyclus::GreedySolver* solver = new cyclus::GreedySolver(false, NULL);
+  solver->concurrent_markets(concurrent);
+  ctx.solver(solver);
+  int first = -1;
+  for (int i = 0; i < 30; ++i) {
+    Marketeer* m = new Marketeer(&ctx, i % 4 != 0);
+    m->Build(NULL);
+    first = first < 0 ? m->id() : first;
+  }
+
+  ti.RunSim();
+  rec.Flush();
+
+  // agent ids are unique across simulations
+  for (int i = 0; i < back->portfolios.size(); ++i) {
+    back->portfolios[i].first -= first;
+  }
+  for (int i = 0; i < back->trades.size(); ++i) {
+    back->trades[i].first -= first;
+    back->trades[i].second -= first;
+  }
+
+  // and so are resource and composition ids, which are allocated in agent id
+  // order as the agents are built
+  std::pair<int, int> min = back->ids.empty() ? std::make_pair(0, 0) :
+                            back->ids[0];
+  for (int i = 0; i < back->ids.size(); ++i) {
+    min.first = std::min(min.first, back->ids[i].first);
+    min.second = std::min(min.second, back->ids[i].second);
+  }
+  for (int i = 0; i < back->ids.size(); ++i) {
+    back->ids[i].first -= min.first;
+    back->ids[i].second -= min.second;
+  }
+}
+
+TEST(TimerTests, ThreadedExchangeCollection) {
+  MarketBack serial;
+  RunMarketSim(&serial, 1);
+  MarketBack threaded;
+  RunMarketSim(&threaded, 4);
+
+  // every agent requests and bids every timestep, in id order
+  ASSERT_EQ(3 * 2 * 30, serial.portfolios.size());
+  for (int i = 1; i < 30; ++i) {
+    EXPECT_LT(serial.portfolios[i - 1].first, serial.portfolios[i].first);
+    EXPECT_EQ("request", serial.portfolios[i].second);
+  }
+  EXPECT_EQ("bid", serial.portfolios[30].second);
+  EXPECT_EQ(0, serial.pooled);
+  EXPECT_FALSE(serial.trades.empty());
+
+  // trades are recorded in trader address order
+  std::sort(serial.trades.begin(), serial.trades.end());
+  std::sort(threaded.trades.begin(), threaded.trades.end());
+  EXPECT_EQ(serial.portfolios, threaded.portfolios);
+  EXPECT_EQ(serial.trades, threaded.trades);
+
+  // the resources and compositions of the portfolios have the same ids
+  ASSERT_EQ(3 * 2 * 30, threaded.ids.size());
+  EXPECT_EQ(serial.ids, threaded.ids);
+  EXPECT_EQ(serial.ids[0], serial.ids[30]);  // a trader's request and bid
+  EXPECT_NE(serial.ids[0], serial.ids[1]);
+  EXPECT_EQ(3 * 2 * 30, threaded.pooled);
+}
+
+TEST(TimerTests, ConcurrentMarkets) {
+  MarketBack serial;
+  RunMarketSim(&serial, 1, true);
+  MarketBack concurrent;
+  RunMarketSim(&concurrent, 4, true);
+
+  // with only material traders, portfolios and trades are recorded in the
+  // same order as when the markets are solved one after another
+  ASSERT_EQ(3 * 2 * 30, concurrent.portfolios.size());
+  EXPECT_FALSE(concurrent.trades.empty());
+  EXPECT_EQ(serial.portfolios, concurrent.portfolios);
+  std::sort(serial.trades.begin(), serial.trades.end());
+  std::sort(concurrent.trades.begin(), concurrent.trades.end());
+  EXPECT_EQ(serial.trades, concurrent.trades);
+}
+
+/// @return the fuel a refiner supplied by a marketeer has received whenever
+/// its product requests are queried
+std::vector<double> RunRefinerSim(bool concurrent) {
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(3));
+  ctx.threads(4);
+  cyclus::GreedySolver* solver = new cyclus::GreedySolver(false, NULL);
+  solver->concurrent_markets(concurrent);
+  ctx.solver(solver);
+  Marketeer* m = new Marketeer(&ctx, true);
+  m->Build(NULL);
+  Refiner* r = new Refiner(&ctx);
+  r->Build(NULL);
+
+  ti.RunSim();
+  return r->seen;
+}
+
+/// runs a simulation with a registered market
+void RunRegisteredMarket(CountingMarket* market, bool concurrent) {
+  cyclus::Recorder rec;
+  cyclus::Timer ti;
+  cyclus::Context ctx(&ti, &rec);
+
+  ti.Initialize(&ctx, cyclus::SimInfo(3));
+  ctx.threads(4);
+  cyclus::GreedySolver* solver = new cyclus::GreedySolver(false, NULL);
+  solver->concurrent_markets(concurrent);
+  ctx.solver(solver);
+  ctx.RegisterMarket(market);
+  ctx.RegisterMarket(market);  // registered once
+  ti.RunSim();
+}
+
+TEST(TimerTests, RegisterMarket) {
+  CountingMarket serial;
+  RunRegisteredMarket(&serial, false);
+  EXPECT_EQ(3, serial.collects);
+  EXPECT_EQ(3, serial.solves);
+  EXPECT_EQ(3, serial.executes);
+  ASSERT_EQ(1, serial.solvers.size());
+  EXPECT_TRUE(*serial.solvers.begin() == NULL);  // the simulation's
+
+  // concurrently, the market has a solver of its own while the simulation runs
+  CountingMarket concurrent;
+  RunRegisteredMarket(&concurrent, true);
+  EXPECT_EQ(3, concurrent.collects);
+  EXPECT_EQ(3, concurrent.solves);
+  EXPECT_EQ(3, concurrent.executes);
+  ASSERT_EQ(1, concurrent.solvers.size());
+  EXPECT_TRUE(*concurrent.solvers.begin() != NULL);
+  EXPECT_TRUE(concurrent.solver() == NULL);
+}
+
+TEST(TimerTests, ConcurrentMarketOrder) {
+  // serially, the product market is collected after the material trades of
+  // the same timestep are executed
+  std::vector<double> serial = RunRefinerSim(false);
+  ASSERT_EQ(3, serial.size());
+  EXPECT_DOUBLE_EQ(1, serial[0]);
+  EXPECT_DOUBLE_EQ(3, serial[2]);
+
+  // concurrently, all markets are collected before any trades are executed
+  std::vector<double> concurrent = RunRefinerSim(true);
+  ASSERT_EQ(3, concurrent.size());
+  EXPECT_DOUBLE_EQ(0, concurrent[0]);
+  EXPECT_DOUBLE_EQ(2, concurrent[2]);
+}